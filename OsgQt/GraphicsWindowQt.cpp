@@ -560,17 +560,10 @@ void GLWidget::mouseMoveEvent( QMouseEvent* event )
     // 注意：坐标需要乘以设备像素比以处理高DPI显示器
     _gw->getEventQueue()->mouseMotion( event->x()*_devicePixelRatio, event->y()*_devicePixelRatio );
 	
-    // ===== 地图状态管理器通知 =====
-    // 如果设置了地图状态管理器，则通知它鼠标移动事件
-    // 这样可以让地图状态管理器实时获取鼠标位置和状态信息
-    if (_mapStateManager) {
-        _mapStateManager->onMouseMove(event);
-    }
-
-    // ===== 实体管理器通知 =====
-    if (_entityManager) {
-        _entityManager->onMouseMove(event);
-    }
+    // ===== 地图状态管理器/实体管理器通知 =====
+    // 鼠标移动不再逐个事件通知管理器：OsgMapWidget通过事件过滤器只保留最新的
+    // 光标位置，并在每帧渲染后统一调用 MapStateManager::updateMousePosition
+    // 和 GeoEntityManager::updateHover，避免高回报率鼠标在一帧内重复求交
 }
 
 void GLWidget::wheelEvent( QWheelEvent* event )
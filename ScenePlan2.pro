@@ -1,7 +1,7 @@
 QT       += core gui opengl
 CONFIG += console
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets sql
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets sql concurrent
 
 CONFIG += c++11
 
@@ -109,14 +109,35 @@ SOURCES += \
     OsgQt/QGraphicsViewAdapter.cpp \
     OsgQt/QWidgetImage.cpp \
     geo/geoentity.cpp \
+    geo/entityspatialindex.cpp \
+    geo/screenpickbuffer.cpp \
+    geo/labeldeclutter.cpp \
+    geo/routegeometry.cpp \
+    geo/routetessellator.cpp \
+    geo/screenquadbatch.cpp \
+    geo/entityclusterlayer.cpp \
+    geo/entitystore.cpp \
+    geo/entityslotmap.cpp \
+    geo/entitynodepool.cpp \
+    geo/highlightcache.cpp \
     geo/geoentitymanager.cpp \
     geo/imageentity.cpp \
+    geo/iconcache.cpp \
+    geo/iconbatchlayer.cpp \
+    geo/iconatlas.cpp \
+    geo/glyphatlas.cpp \
+    geo/waypointbatchlayer.cpp \
     geo/mapstatemanager.cpp \
     geo/waypointentity.cpp \
     geo/geoutils.cpp \
     geo/navigationhistory.cpp \
     geo/basemapmanager.cpp \
     util/databaseutils.cpp \
+    util/catalogcache.cpp \
+    plan/planloader.cpp \
+    plan/planjournal.cpp \
+    plan/planformat.cpp \
+    plan/plandefinitions.cpp \
     plan/planfilemanager.cpp \
     widgets/MapInfoOverlay.cpp \
     widgets/draggablelistwidget.cpp \
@@ -141,14 +162,36 @@ HEADERS += \
     OsgQt/QGraphicsViewAdapter.h \
     OsgQt/QWidgetImage.h \
     geo/geoentity.h \
+    geo/entityspatialindex.h \
+    geo/screenpickbuffer.h \
+    geo/labeldeclutter.h \
+    geo/routegeometry.h \
+    geo/routetessellator.h \
+    geo/screenquadbatch.h \
+    geo/entityclusterlayer.h \
+    geo/entitystore.h \
+    geo/entityhandle.h \
+    geo/entityslotmap.h \
+    geo/entitynodepool.h \
+    geo/highlightcache.h \
     geo/geoentitymanager.h \
     geo/imageentity.h \
+    geo/iconcache.h \
+    geo/iconbatchlayer.h \
+    geo/iconatlas.h \
+    geo/glyphatlas.h \
+    geo/waypointbatchlayer.h \
     geo/mapstatemanager.h \
     geo/waypointentity.h \
     geo/geoutils.h \
     geo/navigationhistory.h \
     geo/basemapmanager.h \
     util/databaseutils.h \
+    util/catalogcache.h \
+    plan/planloader.h \
+    plan/planjournal.h \
+    plan/planformat.h \
+    plan/plandefinitions.h \
     plan/planfilemanager.h \
     widgets/MapInfoOverlay.h \
     widgets/draggablelistwidget.h \
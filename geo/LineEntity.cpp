@@ -13,6 +13,9 @@
 #include <osg/StateSet>
 
 namespace {
+const float kLabelCharacterSize = 250.0f;   // 标签字高（米）
+const double kMinLabelPixels = 6.0;         // 换算后字高低于此值时不显示标签
+
 QVariant buildEndpointObject(double lon, double lat, double alt)
 {
     QVariantMap map;
@@ -91,6 +94,21 @@ osg::ref_ptr<osg::Node> LineEntity::createNode()
 {
     osg::ref_ptr<osg::PositionAttitudeTransform> pat = createPATNode();
 
+    // 节点池中整组归还的线节点（线几何体 + 标签）直接重用，只需刷新顶点与文字
+    if (!adoptPooledNodes(pat.get())) {
+        pat->removeChildren(0, pat->getNumChildren());
+        buildNodes(pat.get());
+    }
+    labelGeode_->setNodeMask(isLabelVisible() ? 0xffffffff : 0x0);
+
+    updateLineGeometry();
+    updateLabelText();
+
+    return pat.get();
+}
+
+void LineEntity::buildNodes(osg::PositionAttitudeTransform* pat)
+{
     geometry_ = new osg::Geometry();
     vertices_ = new osg::Vec3Array();
     geometry_->setVertexArray(vertices_.get());
@@ -115,7 +133,7 @@ osg::ref_ptr<osg::Node> LineEntity::createNode()
 
     labelGeode_ = new osg::Geode();
     labelText_ = new osgText::Text();
-    labelText_->setCharacterSize(250.0f);
+    labelText_->setCharacterSize(kLabelCharacterSize);
     labelText_->setColor(osg::Vec4(1.0f, 1.0f, 0.2f, 1.0f));
     labelText_->setAlignment(osgText::Text::CENTER_BOTTOM);
     labelText_->setAxisAlignment(osgText::TextBase::SCREEN);
@@ -128,11 +146,31 @@ osg::ref_ptr<osg::Node> LineEntity::createNode()
     labelState->setRenderBinDetails(9999, "RenderBin");
     labelGeode_->setCullingActive(false);
     pat->addChild(labelGeode_.get());
+}
 
-    updateLineGeometry();
-    updateLabelText();
+bool LineEntity::adoptPooledNodes(osg::PositionAttitudeTransform* pat)
+{
+    if (pat->getNumChildren() != 2) {
+        return false;
+    }
+    osg::Geode* geode = pat->getChild(0)->asGeode();
+    osg::Geode* labelGeode = pat->getChild(1)->asGeode();
+    if (!geode || !labelGeode || geode->getNumDrawables() != 1 || labelGeode->getNumDrawables() != 1) {
+        return false;
+    }
+    osg::Geometry* geometry = geode->getDrawable(0)->asGeometry();
+    osg::Vec3Array* vertices = geometry ? dynamic_cast<osg::Vec3Array*>(geometry->getVertexArray()) : nullptr;
+    osgText::Text* labelText = dynamic_cast<osgText::Text*>(labelGeode->getDrawable(0));
+    if (!vertices || !labelText) {
+        return false;
+    }
 
-    return pat.get();
+    geometry_ = geometry;
+    vertices_ = vertices;
+    geode_ = geode;
+    labelGeode_ = labelGeode;
+    labelText_ = labelText;
+    return true;
 }
 
 void LineEntity::onUpdated()
@@ -140,6 +178,31 @@ void LineEntity::onUpdated()
     updateLineGeometry();
 }
 
+void LineEntity::onLabelVisibilityChanged(bool visible)
+{
+    if (labelGeode_) {
+        labelGeode_->setNodeMask(visible ? 0xffffffff : 0x0);
+    }
+}
+
+QRectF LineEntity::labelScreenRect(double metersPerPixel) const
+{
+    if (!labelText_ || metersPerPixel <= 0.0) {
+        return QRectF();
+    }
+    const double height = kLabelCharacterSize / metersPerPixel;
+    if (height < kMinLabelPixels) {
+        return QRectF();
+    }
+
+    // 按字符估算宽度：ASCII约为字高的0.6倍，其余（中文等）按字高计
+    double width = 0.0;
+    for (const QChar& ch : resolveDisplayName()) {
+        width += ch.unicode() < 0x80 ? height * 0.6 : height;
+    }
+    return QRectF(-width * 0.5, -height, width, height);
+}
+
 void LineEntity::updateLineGeometry()
 {
     if (!vertices_) {
@@ -30,11 +30,18 @@ public:
 
     double lengthMeters() const;
 
+    bool hasLabel() const override { return labelText_.valid(); }
+    /** @brief 标签矩形：中点上方水平居中；字高为世界尺寸，按当前比例换算成像素，过小时返回空矩形 */
+    QRectF labelScreenRect(double metersPerPixel) const override;
+
 protected:
     osg::ref_ptr<osg::Node> createNode() override;
     void onUpdated() override;
+    void onLabelVisibilityChanged(bool visible) override;
 
 private:
+    void buildNodes(osg::PositionAttitudeTransform* pat);
+    bool adoptPooledNodes(osg::PositionAttitudeTransform* pat);
     void updateLineGeometry();
     void updateHighlightFromLength();
     void syncEndpointProperties();
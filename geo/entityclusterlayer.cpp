@@ -0,0 +1,362 @@
+/**
+ * @file entityclusterlayer.cpp
+ * @brief 实体聚合图层实现文件
+ *
+ * 实现EntityClusterLayer类的所有功能
+ */
+
+#include "entityclusterlayer.h"
+#include "geoentity.h"
+#include "geoutils.h"
+#include "glyphatlas.h"
+#include "iconatlas.h"
+#include <QDebug>
+#include <cmath>
+
+namespace {
+
+const double kBaseCellDegrees = 0.02;        // 第0级网格边长（度），约2.2公里
+const double kMetersPerDegree = 111320.0;
+const double kClusterPixels = 48.0;          // 网格边长在屏幕上不小于该像素数时才聚合
+const double kLevelHysteresis = 1.25;        // 级别切换的滞回系数
+const double kDefaultMinClusterRange = 100000.0;
+const float kMarkerIconPixels = 32.0f;
+const int kMarkerIconRenderBin = 101;        // 在航点标签之后绘制
+const int kMarkerCountRenderBin = 102;
+
+}
+
+EntityClusterLayer::EntityClusterLayer()
+    : icons_("ClusterIcons", nullptr, kMarkerIconRenderBin)
+    , counts_("ClusterCounts", GlyphAtlas::instance().texture(), kMarkerCountRenderBin)
+    , levels_(kLevelCount)
+    , minClusterRange_(kDefaultMinClusterRange)
+{
+    root_ = new osg::MatrixTransform;
+    root_->setName("EntityClusterLayer");
+    root_->addChild(icons_.getNode());
+    root_->addChild(counts_.getNode());
+}
+
+double EntityClusterLayer::cellDegrees(int level)
+{
+    return kBaseCellDegrees * static_cast<double>(1 << level);
+}
+
+quint64 EntityClusterLayer::cellKey(double longitude, double latitude, int level)
+{
+    const double size = cellDegrees(level);
+    const qint32 x = static_cast<qint32>(std::floor((longitude + 180.0) / size));
+    const qint32 y = static_cast<qint32>(std::floor((latitude + 90.0) / size));
+    return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+
+void EntityClusterLayer::addEntity(GeoEntity* entity, const QString& iconKey)
+{
+    if (!entity || records_.contains(entity)) {
+        return;
+    }
+
+    Record& record = records_[entity];
+    record.iconKey = iconKey;
+    entity->getPosition(record.longitude, record.latitude, record.altitude);
+    if (!hasOrigin_) {
+        origin_ = GeoUtils::geoToWorldCoordinates(record.longitude, record.latitude, record.altitude);
+        root_->setMatrix(osg::Matrix::translate(origin_));
+        hasOrigin_ = true;
+    }
+    if (entity->isVisible()) {
+        insertIntoCells(entity, record);
+    }
+}
+
+void EntityClusterLayer::updateEntity(GeoEntity* entity)
+{
+    auto it = records_.find(entity);
+    if (it == records_.end()) {
+        return;
+    }
+
+    Record& record = it.value();
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    entity->getPosition(longitude, latitude, altitude);
+
+    // 仍在同一网格单元且可见性未变时只更新累计的坐标和
+    const bool visible = entity->isVisible();
+    if (record.indexed && visible) {
+        bool sameCells = true;
+        for (int level = 0; level < kLevelCount && sameCells; ++level) {
+            sameCells = cellKey(longitude, latitude, level) == record.keys[level];
+        }
+        if (sameCells) {
+            for (int level = 0; level < kLevelCount; ++level) {
+                Cell& cell = levels_[level][record.keys[level]];
+                cell.sumLongitude += longitude - record.longitude;
+                cell.sumLatitude += latitude - record.latitude;
+                cell.sumAltitude += altitude - record.altitude;
+            }
+            record.longitude = longitude;
+            record.latitude = latitude;
+            record.altitude = altitude;
+            if (activeLevel_ >= 0) {
+                dirtyCells_.insert(record.keys[activeLevel_]);
+            }
+            return;
+        }
+    }
+
+    if (record.indexed) {
+        removeFromCells(entity, record);
+    }
+    record.longitude = longitude;
+    record.latitude = latitude;
+    record.altitude = altitude;
+    if (visible) {
+        insertIntoCells(entity, record);
+    } else {
+        // 隐藏的实体不再属于任何聚合；跨单元移动的实体保持原状态，由下次刷新决定
+        entity->setClustered(false);
+    }
+}
+
+void EntityClusterLayer::removeEntity(GeoEntity* entity)
+{
+    auto it = records_.find(entity);
+    if (it == records_.end()) {
+        return;
+    }
+    if (it->indexed) {
+        removeFromCells(entity, it.value());
+    }
+    records_.erase(it);
+    entity->setClustered(false);
+    if (records_.isEmpty()) {
+        hasOrigin_ = false;
+    }
+}
+
+void EntityClusterLayer::clear()
+{
+    records_.clear();
+    for (QHash<quint64, Cell>& cells : levels_) {
+        cells.clear();
+    }
+    dirtyCells_.clear();
+    hasOrigin_ = false;
+    activeLevel_ = -1;
+    rebuildMarkers();
+}
+
+void EntityClusterLayer::insertIntoCells(GeoEntity* entity, Record& record)
+{
+    for (int level = 0; level < kLevelCount; ++level) {
+        const quint64 key = cellKey(record.longitude, record.latitude, level);
+        record.keys[level] = key;
+        Cell& cell = levels_[level][key];
+        cell.members.insert(entity);
+        cell.sumLongitude += record.longitude;
+        cell.sumLatitude += record.latitude;
+        cell.sumAltitude += record.altitude;
+        ++cell.iconCounts[record.iconKey];
+    }
+    record.indexed = true;
+    if (activeLevel_ >= 0) {
+        dirtyCells_.insert(record.keys[activeLevel_]);
+    }
+}
+
+void EntityClusterLayer::removeFromCells(GeoEntity* entity, Record& record)
+{
+    for (int level = 0; level < kLevelCount; ++level) {
+        auto it = levels_[level].find(record.keys[level]);
+        if (it == levels_[level].end()) {
+            continue;
+        }
+        Cell& cell = it.value();
+        cell.members.remove(entity);
+        if (cell.members.isEmpty()) {
+            levels_[level].erase(it);
+            continue;
+        }
+        cell.sumLongitude -= record.longitude;
+        cell.sumLatitude -= record.latitude;
+        cell.sumAltitude -= record.altitude;
+        if (--cell.iconCounts[record.iconKey] <= 0) {
+            cell.iconCounts.remove(record.iconKey);
+        }
+    }
+    record.indexed = false;
+    if (activeLevel_ >= 0) {
+        dirtyCells_.insert(record.keys[activeLevel_]);
+    }
+}
+
+void EntityClusterLayer::setEnabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+void EntityClusterLayer::setMinClusterRange(double rangeMeters)
+{
+    minClusterRange_ = qMax(0.0, rangeMeters);
+}
+
+int EntityClusterLayer::selectLevel(double rangeMeters, double pixelScale) const
+{
+    if (!enabled_ || pixelScale <= 0.0 || records_.isEmpty()) {
+        return -1;
+    }
+    // 已聚合时拉近到最小距离以内一段才展开，避免在边界上反复切换
+    const double minRange = activeLevel_ >= 0 ? minClusterRange_ / kLevelHysteresis : minClusterRange_;
+    if (rangeMeters < minRange) {
+        return -1;
+    }
+
+    const double targetMeters = kClusterPixels * rangeMeters * pixelScale;
+    if (activeLevel_ >= 0) {
+        const double activeMeters = cellDegrees(activeLevel_) * kMetersPerDegree;
+        if (activeMeters * kLevelHysteresis >= targetMeters
+            && activeMeters < 2.0 * targetMeters * kLevelHysteresis) {
+            return activeLevel_;
+        }
+    }
+    for (int level = 0; level < kLevelCount; ++level) {
+        if (cellDegrees(level) * kMetersPerDegree >= targetMeters) {
+            return level;
+        }
+    }
+    return kLevelCount - 1;
+}
+
+bool EntityClusterLayer::update(double rangeMeters, double pixelScale)
+{
+    bool markersDirty = false;
+    const int generation = IconAtlas::instance().generation();
+    if (generation != atlasGeneration_ && IconAtlas::instance().texture().valid()) {
+        atlasGeneration_ = generation;
+        icons_.setTexture(IconAtlas::instance().texture().get());
+        markersDirty = activeLevel_ >= 0;
+    }
+
+    const int level = selectLevel(rangeMeters, pixelScale);
+    if (level != activeLevel_) {
+        qDebug() << "实体聚合级别:" << activeLevel_ << "->" << level << "相机距离:" << rangeMeters;
+        activeLevel_ = level;
+        refreshAll();
+        return true;
+    }
+
+    if (activeLevel_ >= 0 && !dirtyCells_.isEmpty()) {
+        for (quint64 key : dirtyCells_) {
+            refreshCell(key);
+        }
+        cellRefreshes_ += static_cast<quint64>(dirtyCells_.size());
+        markersDirty = true;
+    }
+    dirtyCells_.clear();
+
+    if (markersDirty) {
+        rebuildMarkers();
+    }
+    return markersDirty;
+}
+
+void EntityClusterLayer::refreshAll()
+{
+    for (auto it = records_.begin(); it != records_.end(); ++it) {
+        bool clustered = false;
+        if (activeLevel_ >= 0 && it->indexed) {
+            auto cell = levels_[activeLevel_].constFind(it->keys[activeLevel_]);
+            clustered = cell != levels_[activeLevel_].constEnd() && cell->members.size() >= 2;
+        }
+        it.key()->setClustered(clustered);
+    }
+    dirtyCells_.clear();
+    ++fullRefreshes_;
+    rebuildMarkers();
+}
+
+void EntityClusterLayer::refreshCell(quint64 key)
+{
+    auto it = levels_[activeLevel_].constFind(key);
+    if (it == levels_[activeLevel_].constEnd()) {
+        return;
+    }
+    const bool clustered = it->members.size() >= 2;
+    for (GeoEntity* member : it->members) {
+        member->setClustered(clustered);
+    }
+}
+
+void EntityClusterLayer::rebuildMarkers()
+{
+    icons_.clear();
+    counts_.clear();
+    clusterCount_ = 0;
+    clusteredEntities_ = 0;
+
+    if (activeLevel_ >= 0) {
+        IconAtlas& iconAtlas = IconAtlas::instance();
+        GlyphAtlas& glyphAtlas = GlyphAtlas::instance();
+        const float half = kMarkerIconPixels * 0.5f;
+        const float cellSize = static_cast<float>(GlyphAtlas::kCellSize);
+        const float cellPadding = static_cast<float>(GlyphAtlas::kCellPadding);
+
+        for (const Cell& cell : levels_[activeLevel_]) {
+            const int count = cell.members.size();
+            if (count < 2) {
+                continue;
+            }
+            ++clusterCount_;
+            clusteredEntities_ += count;
+
+            const osg::Vec3d world = GeoUtils::geoToWorldCoordinates(cell.sumLongitude / count,
+                                                                     cell.sumLatitude / count,
+                                                                     cell.sumAltitude / count);
+            const osg::Vec3d offset = world - origin_;
+            const osg::Vec4 anchor(offset.x(), offset.y(), offset.z(), 1.0f);
+
+            // 主要图标：单元内数量最多的图标
+            QString dominant;
+            int dominantCount = 0;
+            for (auto icon = cell.iconCounts.constBegin(); icon != cell.iconCounts.constEnd(); ++icon) {
+                if (icon.value() > dominantCount) {
+                    dominant = icon.key();
+                    dominantCount = icon.value();
+                }
+            }
+            osg::Vec4 uv;
+            if (iconAtlas.uvRect(dominant, uv)) {
+                icons_.append(anchor, osg::Vec4(-half, -half, kMarkerIconPixels, kMarkerIconPixels), uv);
+            }
+
+            // 成员数显示在图标右侧
+            float pen = half + 2.0f;
+            for (uint codePoint : QString::number(count).toUcs4()) {
+                GlyphAtlas::Glyph glyph = glyphAtlas.glyph(codePoint);
+                if (!glyph.valid) {
+                    continue;
+                }
+                counts_.append(anchor, osg::Vec4(pen - cellPadding, -cellSize * 0.5f, cellSize, cellSize), glyph.uvRect);
+                pen += glyph.advance;
+            }
+        }
+    }
+
+    icons_.commit();
+    counts_.commit();
+}
+
+EntityClusterLayer::Stats EntityClusterLayer::stats() const
+{
+    Stats result;
+    result.entityCount = records_.size();
+    result.activeLevel = activeLevel_;
+    result.clusterCount = clusterCount_;
+    result.clusteredEntities = clusteredEntities_;
+    result.fullRefreshes = fullRefreshes_;
+    result.cellRefreshes = cellRefreshes_;
+    return result;
+}
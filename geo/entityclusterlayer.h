@@ -0,0 +1,137 @@
+/**
+ * @file entityclusterlayer.h
+ * @brief 实体聚合图层头文件
+ *
+ * 定义EntityClusterLayer类，远距离时把相邻的图片实体合并为一个聚合标记
+ * （主要图标 + 实体数），拉近时逐级展开。
+ */
+
+#ifndef ENTITYCLUSTERLAYER_H
+#define ENTITYCLUSTERLAYER_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <osg/MatrixTransform>
+#include <osg/Vec3d>
+#include "screenquadbatch.h"
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 实体聚合图层（分级经纬度网格）
+ *
+ * 共kLevelCount级网格，第L级网格边长为 kBaseCellDegrees * 2^L 度。每个实体在每一级都登记到
+ * 所在网格单元，单元内累计成员、经纬度之和与各图标的计数，因此增删与移动都只需O(级数)的更新。
+ *
+ * 每帧按相机距离与像素尺寸选择网格边长不小于kClusterPixels像素的最细一级（带滞回，
+ * 避免在两级之间来回切换）：
+ * - 成员数不少于2的单元显示一个聚合标记：位于成员质心，图标取单元内数量最多的图标，旁边显示成员数
+ * - 该单元的成员GeoEntity::setClustered(true)，不再单独绘制、拾取与参与标签避让
+ * - 级别变化时整体刷新；级别不变时只刷新有成员增删或移动的单元
+ * - 相机距离小于最小聚合距离时关闭聚合，所有实体单独绘制
+ *
+ * 聚合标记的图标来自共享的IconAtlas，数字来自GlyphAtlas，各为一次实例化绘制。
+ *
+ * - 仅在主线程使用
+ */
+class EntityClusterLayer
+{
+public:
+    /** @brief 图层统计 */
+    struct Stats {
+        int entityCount = 0;         ///< 登记的实体数
+        int activeLevel = -1;        ///< 当前网格级别（-1表示未聚合）
+        int clusterCount = 0;        ///< 聚合标记数
+        int clusteredEntities = 0;   ///< 被聚合的实体数
+        int fullRefreshes = 0;       ///< 整体刷新次数
+        quint64 cellRefreshes = 0;   ///< 累计增量刷新的网格单元数
+    };
+
+    static const int kLevelCount = 12;
+
+    EntityClusterLayer();
+
+    /** @brief 图层根节点（加入实体组即可） */
+    osg::Node* getNode() const { return root_.get(); }
+
+    /**
+     * @brief 登记实体
+     * @param entity 实体
+     * @param iconKey 图标路径（聚合标记按数量最多的图标显示，同时作为实体类别）
+     */
+    void addEntity(GeoEntity* entity, const QString& iconKey);
+    /** @brief 实体位置或可见性变化后更新其所在网格单元 */
+    void updateEntity(GeoEntity* entity);
+    /** @brief 移除实体 */
+    void removeEntity(GeoEntity* entity);
+    /** @brief 清空 */
+    void clear();
+
+    /** @brief 启用/关闭聚合；关闭时所有实体单独绘制 */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+    /** @brief 设置开始聚合的最小相机距离（米） */
+    void setMinClusterRange(double rangeMeters);
+    double minClusterRange() const { return minClusterRange_; }
+
+    /**
+     * @brief 按当前相机状态刷新聚合
+     * @param rangeMeters 相机距离（米）
+     * @param pixelScale 单位深度下一个像素对应的米数
+     * @return 聚合状态或聚合标记有变化返回true
+     */
+    bool update(double rangeMeters, double pixelScale);
+
+    /** @brief 获取图层统计 */
+    Stats stats() const;
+
+private:
+    struct Record {
+        QString iconKey;
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double altitude = 0.0;
+        bool indexed = false;                // 是否已登记到网格（不可见的实体不登记）
+        quint64 keys[kLevelCount];           // 各级网格单元键
+    };
+
+    struct Cell {
+        QSet<GeoEntity*> members;
+        double sumLongitude = 0.0;
+        double sumLatitude = 0.0;
+        double sumAltitude = 0.0;
+        QHash<QString, int> iconCounts;
+    };
+
+    static double cellDegrees(int level);
+    static quint64 cellKey(double longitude, double latitude, int level);
+    int selectLevel(double rangeMeters, double pixelScale) const;
+    void insertIntoCells(GeoEntity* entity, Record& record);
+    void removeFromCells(GeoEntity* entity, Record& record);
+    void refreshAll();
+    void refreshCell(quint64 key);
+    void rebuildMarkers();
+
+    osg::ref_ptr<osg::MatrixTransform> root_;
+    ScreenQuadBatch icons_;
+    ScreenQuadBatch counts_;
+    osg::Vec3d origin_;
+    bool hasOrigin_ = false;
+    int atlasGeneration_ = -1;
+
+    QHash<GeoEntity*, Record> records_;
+    QVector<QHash<quint64, Cell>> levels_;
+    QSet<quint64> dirtyCells_;               // 当前级别下需要刷新的单元
+    bool enabled_ = true;
+    double minClusterRange_;
+    int activeLevel_ = -1;
+    int clusterCount_ = 0;
+    int clusteredEntities_ = 0;
+    int fullRefreshes_ = 0;
+    quint64 cellRefreshes_ = 0;
+};
+
+#endif // ENTITYCLUSTERLAYER_H
@@ -0,0 +1,43 @@
+/**
+ * @file entityhandle.h
+ * @brief 实体句柄头文件
+ *
+ * 定义EntityHandle（槽位下标 + 代数），用于在不持有裸指针的情况下引用实体。
+ */
+
+#ifndef ENTITYHANDLE_H
+#define ENTITYHANDLE_H
+
+#include <QHash>
+#include <QtGlobal>
+
+/**
+ * @ingroup managers
+ * @brief 实体句柄
+ *
+ * 由EntitySlotMap分配：index为槽位下标，generation为槽位当前代数。实体删除时槽位代数加一，
+ * 之前发出的句柄随即失效（解析为nullptr），槽位复用后也不会误指向新实体。
+ *
+ * - 默认构造的句柄为空句柄（generation为0）
+ * - 按值传递与保存，可作为QHash/QSet的键
+ */
+struct EntityHandle {
+    quint32 index = 0;
+    quint32 generation = 0;
+
+    /** @brief 是否为空句柄 */
+    bool isNull() const { return generation == 0; }
+
+    bool operator==(const EntityHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
+
+inline uint qHash(const EntityHandle& handle, uint seed = 0)
+{
+    return ::qHash((static_cast<quint64>(handle.generation) << 32) | handle.index, seed);
+}
+
+#endif // ENTITYHANDLE_H
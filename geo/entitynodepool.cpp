@@ -0,0 +1,169 @@
+/**
+ * @file entitynodepool.cpp
+ * @brief 实体场景节点池实现文件
+ *
+ * 实现EntityNodePool类的所有功能
+ */
+
+#include "entitynodepool.h"
+#include <cstring>
+
+namespace {
+
+bool isOsgClass(const osg::Node* node, const char* className)
+{
+    return std::strcmp(node->libraryName(), "osg") == 0
+        && std::strcmp(node->className(), className) == 0;
+}
+
+// 清除实体写入的状态，使节点不再引用用户数据、共享渲染状态与上一个实体挂接的回调
+void resetNode(osg::Node* node)
+{
+    node->setUserData(nullptr);
+    node->setStateSet(nullptr);
+    node->setUpdateCallback(nullptr);
+    node->setEventCallback(nullptr);
+    node->setCullCallback(nullptr);
+    node->setComputeBoundingSphereCallback(nullptr);
+    node->setInitialBound(osg::BoundingSphere());
+    node->setDescriptions(osg::Node::DescriptionList());
+    node->setNodeMask(0xffffffff);
+    node->setCullingActive(true);
+    node->setName(std::string());
+}
+
+}
+
+EntityNodePool& EntityNodePool::instance()
+{
+    static EntityNodePool pool;
+    return pool;
+}
+
+template <typename T>
+osg::ref_ptr<T> EntityNodePool::take(FreeList<T>& freeList)
+{
+    ++acquired_;
+    if (freeList.nodes.isEmpty()) {
+        return new T;
+    }
+    ++reused_;
+    osg::ref_ptr<T> node = freeList.nodes.last();
+    freeList.nodes.removeLast();
+    freeList.idleCount = qMin(freeList.idleCount, freeList.nodes.size());
+    return node;
+}
+
+template <typename T>
+bool EntityNodePool::put(FreeList<T>& freeList, T* node)
+{
+    if (freeList.nodes.size() >= kMaxPooledNodes) {
+        return false;
+    }
+    freeList.nodes.append(node);
+    return true;
+}
+
+template <typename T>
+int EntityNodePool::trimList(FreeList<T>& freeList)
+{
+    const int released = freeList.idleCount;
+    if (released > 0) {
+        freeList.nodes.remove(0, released);
+    }
+    freeList.idleCount = freeList.nodes.size();
+    return released;
+}
+
+osg::ref_ptr<osg::PositionAttitudeTransform> EntityNodePool::acquireTransform(const QString& entityType)
+{
+    return take(pools_[entityType].transforms);
+}
+
+osg::ref_ptr<osg::Group> EntityNodePool::acquireGroup(const QString& entityType)
+{
+    return take(pools_[entityType].groups);
+}
+
+osg::ref_ptr<osg::Geode> EntityNodePool::acquireGeode(const QString& entityType)
+{
+    return take(pools_[entityType].geodes);
+}
+
+void EntityNodePool::release(const QString& entityType, osg::Node* node, bool keepChildren)
+{
+    if (!node) {
+        return;
+    }
+    // 仍在场景中或仍被其他对象持有的节点不能复用
+    if (node->getNumParents() > 0 || node->referenceCount() > 1) {
+        ++discarded_;
+        return;
+    }
+
+    osg::Group* group = node->asGroup();
+    if (!keepChildren) {
+        // OSG 3.6之前Geode不是Group，可绘制对象需要单独移除，否则会继续引用共享的图标几何体
+        osg::Geode* geode = node->asGeode();
+        if (geode) {
+            geode->removeDrawables(0, geode->getNumDrawables());
+        } else if (group) {
+            group->removeChildren(0, group->getNumChildren());
+        }
+    }
+    resetNode(node);
+
+    bool pooled = false;
+    TypePool& pool = pools_[entityType];
+    if (isOsgClass(node, "PositionAttitudeTransform")) {
+        osg::PositionAttitudeTransform* pat = static_cast<osg::PositionAttitudeTransform*>(node);
+        pat->setPosition(osg::Vec3d());
+        pat->setAttitude(osg::Quat());
+        pat->setScale(osg::Vec3d(1.0, 1.0, 1.0));
+        pat->setPivotPoint(osg::Vec3d());
+        pat->setReferenceFrame(osg::Transform::RELATIVE_RF);
+        pooled = put(pool.transforms, pat);
+    } else if (isOsgClass(node, "Geode")) {
+        pooled = put(pool.geodes, static_cast<osg::Geode*>(node));
+    } else if (isOsgClass(node, "Group")) {
+        pooled = put(pool.groups, group);
+    }
+
+    if (pooled) {
+        ++released_;
+    } else {
+        ++discarded_;
+    }
+}
+
+int EntityNodePool::trim()
+{
+    int released = 0;
+    for (auto it = pools_.begin(); it != pools_.end(); ++it) {
+        released += trimList(it->transforms);
+        released += trimList(it->groups);
+        released += trimList(it->geodes);
+    }
+    return released;
+}
+
+void EntityNodePool::clear()
+{
+    pools_.clear();
+}
+
+EntityNodePool::Stats EntityNodePool::stats() const
+{
+    Stats result;
+    result.acquired = acquired_;
+    result.reused = reused_;
+    result.released = released_;
+    result.discarded = discarded_;
+    result.reuseRate = acquired_ > 0 ? static_cast<double>(reused_) / static_cast<double>(acquired_) : 0.0;
+    for (auto it = pools_.constBegin(); it != pools_.constEnd(); ++it) {
+        const int count = it->transforms.nodes.size() + it->groups.nodes.size() + it->geodes.nodes.size();
+        result.pooledByType.insert(it.key(), count);
+        result.pooled += count;
+    }
+    return result;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file entitynodepool.h
+ * @brief 实体场景节点池头文件
+ *
+ * 定义EntityNodePool类，按实体类型缓存已回收实体的场景节点，
+ * 清空方案后再次加载时直接复用，避免反复分配OSG节点。
+ */
+
+#ifndef ENTITYNODEPOOL_H
+#define ENTITYNODEPOOL_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include <osg/Geode>
+#include <osg/Group>
+#include <osg/PositionAttitudeTransform>
+
+/**
+ * @ingroup managers
+ * @brief 实体场景节点池
+ *
+ * 每种实体类型（image、waypoint、line 等）各有三组空闲列表：
+ * - 变换节点（PositionAttitudeTransform）：GeoEntity::createPATNode() 的根节点
+ * - 组节点（Group）：航点的外层组、注解组，以及批量绘制模式下的占位节点
+ * - 叶节点（Geode）：图片实体的图标节点
+ *
+ * 实体回收（GeoEntityManager::processPendingDeletions）时GeoEntity::cleanup()把节点归还到池中，
+ * 归还时重置变换、用户数据、渲染状态、更新/事件/裁剪回调、包围球设置、描述和节点掩码，
+ * 并默认移除子节点（叶节点为可绘制对象），不再引用共享的图标资源。
+ * 子类自行搭建的整组节点（如线实体的线几何体与标签）可以连同子节点一起归还，
+ * 下次创建同类型实体时由子类取回并直接重用。
+ *
+ * - 只接收类名恰好匹配的节点（子类节点，如osgEarth注解节点，不入池）
+ * - 仍有父节点或仍被其他对象引用的节点不入池
+ * - 每组空闲列表最多保留kMaxPooledNodes个节点，超出部分直接释放
+ * - trim()释放自上次trim()以来一直空闲的节点（随实体回收调用），不再加载方案时池会逐步清空
+ * - 全局唯一实例；仅在主线程使用。节点可能持有GL对象，应在图形上下文销毁前调用clear()
+ */
+class EntityNodePool
+{
+public:
+    /** @brief 节点池统计 */
+    struct Stats {
+        quint64 acquired = 0;            ///< 累计获取节点次数
+        quint64 reused = 0;              ///< 其中从池中复用的次数
+        quint64 released = 0;            ///< 累计归还入池的节点数
+        quint64 discarded = 0;           ///< 归还时因池满、仍被引用或类型不符而释放的节点数
+        int pooled = 0;                  ///< 当前池中的空闲节点数
+        double reuseRate = 0.0;          ///< 复用率（reused / acquired）
+        QHash<QString, int> pooledByType;  ///< 按实体类型统计的空闲节点数
+    };
+
+    static const int kMaxPooledNodes = 8192;
+
+    /** @brief 获取全局实例 */
+    static EntityNodePool& instance();
+
+    /** @brief 获取变换节点（已重置为原点、无旋转、单位缩放；线等整组归还的类型可能带有子节点） */
+    osg::ref_ptr<osg::PositionAttitudeTransform> acquireTransform(const QString& entityType);
+    /** @brief 获取空的组节点 */
+    osg::ref_ptr<osg::Group> acquireGroup(const QString& entityType);
+    /** @brief 获取空的叶节点（无可绘制对象、无渲染状态） */
+    osg::ref_ptr<osg::Geode> acquireGeode(const QString& entityType);
+
+    /**
+     * @brief 归还节点
+     *
+     * 调用方应先断开自身的其他引用，只保留传入的这一个引用。
+     * @param entityType 实体类型
+     * @param node 已从场景中移除的节点
+     * @param keepChildren 是否保留子节点（整组归还，由同类型实体取回后重用）
+     */
+    void release(const QString& entityType, osg::Node* node, bool keepChildren = false);
+
+    /**
+     * @brief 释放自上次调用以来一直未被取用的空闲节点
+     * @return 释放的节点数
+     */
+    int trim();
+
+    /** @brief 释放池中所有空闲节点（应在图形上下文销毁前调用） */
+    void clear();
+
+    /** @brief 获取节点池统计 */
+    Stats stats() const;
+
+private:
+    template <typename T>
+    struct FreeList {
+        QVector<osg::ref_ptr<T>> nodes;      // 末尾最近归还，取用从末尾取
+        int idleCount = 0;                   // 自上次trim()以来一直未被取用的节点数（位于开头）
+    };
+
+    struct TypePool {
+        FreeList<osg::PositionAttitudeTransform> transforms;
+        FreeList<osg::Group> groups;
+        FreeList<osg::Geode> geodes;
+    };
+
+    EntityNodePool() = default;
+    EntityNodePool(const EntityNodePool&) = delete;
+    EntityNodePool& operator=(const EntityNodePool&) = delete;
+
+    template <typename T>
+    osg::ref_ptr<T> take(FreeList<T>& freeList);
+    template <typename T>
+    bool put(FreeList<T>& freeList, T* node);
+    template <typename T>
+    int trimList(FreeList<T>& freeList);
+
+    QHash<QString, TypePool> pools_;
+    quint64 acquired_ = 0;
+    quint64 reused_ = 0;
+    quint64 released_ = 0;
+    quint64 discarded_ = 0;
+};
+
+#endif // ENTITYNODEPOOL_H
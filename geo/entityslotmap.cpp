@@ -0,0 +1,76 @@
+/**
+ * @file entityslotmap.cpp
+ * @brief 实体槽位表实现文件
+ *
+ * 实现EntitySlotMap类的所有功能
+ */
+
+#include "entityslotmap.h"
+#include "geoentity.h"
+
+EntityHandle EntitySlotMap::insert(GeoEntity* entity)
+{
+    if (!entity) {
+        return EntityHandle();
+    }
+    if (!entity->handle_.isNull() && get(entity->handle_) == entity) {
+        return entity->handle_;
+    }
+
+    quint32 index = 0;
+    if (!freeSlots_.isEmpty()) {
+        index = freeSlots_.takeLast();
+    } else {
+        index = static_cast<quint32>(slots_.size());
+        slots_.append(Slot());
+    }
+
+    Slot& slot = slots_[static_cast<int>(index)];
+    slot.entity = entity;
+
+    EntityHandle handle;
+    handle.index = index;
+    handle.generation = slot.generation;
+    entity->handle_ = handle;
+    ++liveCount_;
+    return handle;
+}
+
+GeoEntity* EntitySlotMap::get(EntityHandle handle) const
+{
+    if (handle.isNull() || handle.index >= static_cast<quint32>(slots_.size())) {
+        return nullptr;
+    }
+    const Slot& slot = slots_[static_cast<int>(handle.index)];
+    return slot.generation == handle.generation ? slot.entity : nullptr;
+}
+
+bool EntitySlotMap::retire(EntityHandle handle)
+{
+    GeoEntity* entity = get(handle);
+    if (!entity) {
+        return false;
+    }
+
+    Slot& slot = slots_[static_cast<int>(handle.index)];
+    slot.entity = nullptr;
+    // 代数跳过0，保证有效句柄永远不是空句柄
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    freeSlots_.append(handle.index);
+    --liveCount_;
+
+    entity->handle_ = EntityHandle();
+    retired_.append(entity);
+    return true;
+}
+
+QVector<GeoEntity*> EntitySlotMap::reclaim()
+{
+    // 退役时实体已从场景移除；调用方保证此时不在渲染过程中
+    ++epoch_;
+    QVector<GeoEntity*> entities;
+    entities.swap(retired_);
+    return entities;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file entityslotmap.h
+ * @brief 实体槽位表头文件
+ *
+ * 定义EntitySlotMap类，为实体分配带代数的句柄，并延迟回收已删除的实体。
+ */
+
+#ifndef ENTITYSLOTMAP_H
+#define ENTITYSLOTMAP_H
+
+#include <QVector>
+#include "entityhandle.h"
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 实体槽位表（带代数的句柄 + 纪元回收）
+ *
+ * - insert() 为实体分配槽位（优先复用空闲槽位），返回句柄并写入实体
+ * - get() 按句柄O(1)解析实体：下标越界或代数不符（实体已删除）时返回nullptr
+ * - retire() 使句柄立即失效并释放槽位，实体对象进入当前纪元的回收列表
+ * - reclaim() 结束当前纪元，返回此前退役的全部实体，由调用方清理并删除
+ *
+ * 退役只使句柄失效，删除推迟到reclaim()。调用方只在渲染之外调用reclaim()（每帧frame()之后，
+ * 或清空方案后直接在主线程调用），因此渲染过程中不会访问已释放的节点。
+ * 本类不保证退役与回收之间完成过一帧渲染：清空方案后立即回收时，退役的实体当场被删除。
+ * 句柄失效后，持有句柄的一方解析得到nullptr，不会访问悬空指针。
+ *
+ * - 仅在主线程使用
+ */
+class EntitySlotMap
+{
+public:
+    EntitySlotMap() = default;
+
+    /** @brief 为实体分配槽位并返回句柄（同时写入GeoEntity::handle()） */
+    EntityHandle insert(GeoEntity* entity);
+    /** @brief 按句柄解析实体，句柄为空或已失效返回nullptr */
+    GeoEntity* get(EntityHandle handle) const;
+    /** @brief 句柄是否仍然有效 */
+    bool contains(EntityHandle handle) const { return get(handle) != nullptr; }
+
+    /**
+     * @brief 退役实体：句柄立即失效，实体对象延迟到下一次reclaim()时交还调用方
+     * @return 句柄有效返回true
+     */
+    bool retire(EntityHandle handle);
+
+    /**
+     * @brief 结束当前纪元（纪元加一）并取出此前退役的全部实体
+     *
+     * 不得在渲染过程中调用。
+     * @return 由调用方清理与删除的实体
+     */
+    QVector<GeoEntity*> reclaim();
+
+    /** @brief 是否有等待回收的实体 */
+    bool hasRetired() const { return !retired_.isEmpty(); }
+    /** @brief 存活的实体数 */
+    int size() const { return liveCount_; }
+    /** @brief 当前纪元（reclaim()的调用次数） */
+    quint64 epoch() const { return epoch_; }
+
+private:
+    struct Slot {
+        GeoEntity* entity = nullptr;
+        quint32 generation = 1;
+    };
+
+    QVector<Slot> slots_;
+    QVector<quint32> freeSlots_;
+    QVector<GeoEntity*> retired_;            // 本纪元内退役、等待回收的实体
+    quint64 epoch_ = 0;
+    int liveCount_ = 0;
+};
+
+#endif // ENTITYSLOTMAP_H
@@ -0,0 +1,165 @@
+/**
+ * @file entityspatialindex.cpp
+ * @brief 实体空间索引实现文件
+ *
+ * 实现EntitySpatialIndex类的所有功能
+ */
+
+#include "entityspatialindex.h"
+#include <cmath>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+// 与 GeoUtils::calculateGeographicDistance 使用相同的地球半径
+const double kEarthRadiusMeters = 6378137.0;
+const double kMetersPerDegree = kEarthRadiusMeters * M_PI / 180.0;
+
+double normalizeLongitude(double longitude)
+{
+    double lon = std::fmod(longitude + 180.0, 360.0);
+    if (lon < 0.0) {
+        lon += 360.0;
+    }
+    return lon - 180.0;
+}
+}
+
+EntitySpatialIndex::EntitySpatialIndex(double cellSizeDegrees)
+    : cellSizeDegrees_(cellSizeDegrees > 0.0 ? cellSizeDegrees : 0.05)
+{
+    cellsX_ = std::max(1, static_cast<int>(std::ceil(360.0 / cellSizeDegrees_)));
+    cellsY_ = std::max(1, static_cast<int>(std::ceil(180.0 / cellSizeDegrees_)));
+}
+
+int EntitySpatialIndex::cellX(double longitude) const
+{
+    int cx = static_cast<int>(std::floor((normalizeLongitude(longitude) + 180.0) / cellSizeDegrees_));
+    cx %= cellsX_;
+    if (cx < 0) {
+        cx += cellsX_;
+    }
+    return cx;
+}
+
+int EntitySpatialIndex::cellY(double latitude) const
+{
+    int cy = static_cast<int>(std::floor((latitude + 90.0) / cellSizeDegrees_));
+    return std::min(std::max(cy, 0), cellsY_ - 1);
+}
+
+quint64 EntitySpatialIndex::cellKey(int cx, int cy) const
+{
+    return (static_cast<quint64>(static_cast<quint32>(cy)) << 32) | static_cast<quint32>(cx);
+}
+
+void EntitySpatialIndex::insert(GeoEntity* entity, double longitude, double latitude)
+{
+    if (!entity || !std::isfinite(longitude) || !std::isfinite(latitude)) {
+        return;
+    }
+
+    const quint64 key = cellKey(cellX(longitude), cellY(latitude));
+    auto it = entityCells_.find(entity);
+    if (it != entityCells_.end()) {
+        if (it.value() == key) {
+            return;
+        }
+        removeFromCell(it.value(), entity);
+        it.value() = key;
+    } else {
+        entityCells_.insert(entity, key);
+    }
+    cells_[key].append(entity);
+}
+
+void EntitySpatialIndex::update(GeoEntity* entity, double longitude, double latitude)
+{
+    if (!entityCells_.contains(entity)) {
+        return;
+    }
+    insert(entity, longitude, latitude);
+}
+
+void EntitySpatialIndex::remove(GeoEntity* entity)
+{
+    auto it = entityCells_.find(entity);
+    if (it == entityCells_.end()) {
+        return;
+    }
+    removeFromCell(it.value(), entity);
+    entityCells_.erase(it);
+}
+
+void EntitySpatialIndex::clear()
+{
+    cells_.clear();
+    entityCells_.clear();
+}
+
+void EntitySpatialIndex::removeFromCell(quint64 key, GeoEntity* entity)
+{
+    auto cellIt = cells_.find(key);
+    if (cellIt == cells_.end()) {
+        return;
+    }
+    QVector<GeoEntity*>& list = cellIt.value();
+    int index = list.indexOf(entity);
+    if (index >= 0) {
+        // 单元内顺序无意义，交换删除避免整体搬移
+        list[index] = list.last();
+        list.removeLast();
+    }
+    if (list.isEmpty()) {
+        cells_.erase(cellIt);
+    }
+}
+
+int EntitySpatialIndex::queryRadius(double longitude, double latitude, double radiusMeters,
+                                    QVector<GeoEntity*>& outEntities) const
+{
+    if (cells_.isEmpty() || !std::isfinite(longitude) || !std::isfinite(latitude)) {
+        return 0;
+    }
+
+    const double radius = std::max(0.0, radiusMeters);
+    const double deltaLat = radius / kMetersPerDegree;
+
+    // 取查询范围内纬度绝对值最大处的余弦，保证经度方向范围足够覆盖
+    const double extremeLat = std::min(90.0, std::fabs(latitude) + deltaLat);
+    const double cosLat = std::cos(extremeLat * M_PI / 180.0);
+
+    int minCy = cellY(latitude - deltaLat);
+    int maxCy = cellY(latitude + deltaLat);
+
+    int spanX = cellsX_;
+    int startCx = 0;
+    if (cosLat > 1e-6) {
+        const double deltaLon = radius / (kMetersPerDegree * cosLat);
+        if (deltaLon < 180.0) {
+            startCx = cellX(longitude - deltaLon);
+            int endCx = cellX(longitude + deltaLon);
+            spanX = endCx - startCx;
+            if (spanX < 0) {
+                spanX += cellsX_;  // 跨越±180°
+            }
+            spanX = std::min(spanX + 1, cellsX_);
+        }
+    }
+
+    int visitedCells = 0;
+    for (int cy = minCy; cy <= maxCy; ++cy) {
+        for (int i = 0; i < spanX; ++i) {
+            const int cx = (startCx + i) % cellsX_;
+            ++visitedCells;
+            auto cellIt = cells_.constFind(cellKey(cx, cy));
+            if (cellIt != cells_.constEnd()) {
+                outEntities += cellIt.value();
+            }
+        }
+    }
+    return visitedCells;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file entityspatialindex.h
+ * @brief 实体空间索引头文件
+ *
+ * 定义EntitySpatialIndex类，基于经纬度网格对实体位置建立索引，
+ * 用于拾取、悬停等需要按距离查找实体的场景。
+ */
+
+#ifndef ENTITYSPATIALINDEX_H
+#define ENTITYSPATIALINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 实体空间索引（经纬度规则网格）
+ *
+ * 将地球表面按固定经纬度步长划分为网格单元，每个单元记录落在其中的实体。
+ * 半径查询只遍历与查询范围相交的单元，避免对全部实体做Haversine距离计算。
+ *
+ * - 经度方向首尾相接（跨越±180°时自动回绕）
+ * - 高纬度时经度方向的查询范围自动放宽，靠近极点时退化为整圈扫描
+ * - 通过 update() 增量维护，通常由 GeoEntity::positionChanged 驱动
+ *
+ * @note 查询结果只是候选集合，调用方仍需计算精确距离进行过滤。
+ */
+class EntitySpatialIndex
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param cellSizeDegrees 网格单元边长（度），默认0.05°（约5.5公里）
+     */
+    explicit EntitySpatialIndex(double cellSizeDegrees = 0.05);
+
+    /** @brief 插入实体（已存在时等价于update） */
+    void insert(GeoEntity* entity, double longitude, double latitude);
+    /** @brief 更新实体位置（未索引的实体会被忽略） */
+    void update(GeoEntity* entity, double longitude, double latitude);
+    /** @brief 从索引中移除实体 */
+    void remove(GeoEntity* entity);
+    /** @brief 清空索引 */
+    void clear();
+
+    /** @brief 是否包含指定实体 */
+    bool contains(GeoEntity* entity) const { return entityCells_.contains(entity); }
+    /** @brief 已索引实体数量 */
+    int size() const { return entityCells_.size(); }
+
+    /**
+     * @brief 查询指定点附近的候选实体
+     * @param longitude 查询中心经度（度）
+     * @param latitude 查询中心纬度（度）
+     * @param radiusMeters 查询半径（米）
+     * @param outEntities 输出候选实体（追加，不清空）
+     * @return 本次查询遍历的网格单元数量
+     */
+    int queryRadius(double longitude, double latitude, double radiusMeters,
+                    QVector<GeoEntity*>& outEntities) const;
+
+private:
+    int cellX(double longitude) const;
+    int cellY(double latitude) const;
+    quint64 cellKey(int cx, int cy) const;
+    void removeFromCell(quint64 key, GeoEntity* entity);
+
+    double cellSizeDegrees_;
+    int cellsX_;
+    int cellsY_;
+    QHash<quint64, QVector<GeoEntity*>> cells_;   // 网格单元 -> 实体列表
+    QHash<GeoEntity*, quint64> entityCells_;       // 实体 -> 所在网格单元
+};
+
+#endif // ENTITYSPATIALINDEX_H
@@ -0,0 +1,171 @@
+/**
+ * @file entitystore.cpp
+ * @brief 实体核心数据存储实现文件
+ *
+ * 实现EntityStore类的所有功能
+ */
+
+#include "entitystore.h"
+#include <QHash>
+
+namespace {
+
+const QHash<QString, EntityStore::Column>& columnsByKey()
+{
+    static const QHash<QString, EntityStore::Column> columns = {
+        {QStringLiteral("size"), EntityStore::SizeColumn},
+        {QStringLiteral("highlightSize"), EntityStore::HighlightSizeColumn},
+        {QStringLiteral("modelId"), EntityStore::ModelIdColumn},
+        {QStringLiteral("routeGroupId"), EntityStore::RouteGroupIdColumn},
+        {QStringLiteral("waypointGroupId"), EntityStore::WaypointGroupIdColumn},
+        {QStringLiteral("waypointOrder"), EntityStore::WaypointOrderColumn},
+    };
+    return columns;
+}
+
+// 用最后一个元素填补空位
+template <typename T>
+void swapRemove(QVector<T>& column, int slot)
+{
+    const int last = column.size() - 1;
+    if (slot != last) {
+        column[slot] = column[last];
+    }
+    column.removeLast();
+}
+
+}
+
+EntityStore& EntityStore::instance()
+{
+    static EntityStore store;
+    return store;
+}
+
+EntityStore::Column EntityStore::columnForKey(const QString& key)
+{
+    return columnsByKey().value(key, NoColumn);
+}
+
+QString EntityStore::keyForColumn(Column column)
+{
+    return columnsByKey().key(column);
+}
+
+int EntityStore::allocate(GeoEntity* owner)
+{
+    const int slot = owners_.size();
+    owners_.append(owner);
+    longitudes_.append(0.0);
+    latitudes_.append(0.0);
+    altitudes_.append(0.0);
+    headings_.append(0.0);
+    flags_.append(Visible | LabelVisible);
+    columnMask_.append(0);
+    sizes_.append(0.0);
+    highlightSizes_.append(0.0);
+    modelIds_.append(QString());
+    routeGroupIds_.append(QString());
+    waypointGroupIds_.append(QString());
+    waypointOrders_.append(0);
+    return slot;
+}
+
+GeoEntity* EntityStore::release(int slot)
+{
+    if (slot < 0 || slot >= owners_.size()) {
+        return nullptr;
+    }
+    const int last = owners_.size() - 1;
+    GeoEntity* moved = slot != last ? owners_[last] : nullptr;
+
+    swapRemove(owners_, slot);
+    swapRemove(longitudes_, slot);
+    swapRemove(latitudes_, slot);
+    swapRemove(altitudes_, slot);
+    swapRemove(headings_, slot);
+    swapRemove(flags_, slot);
+    swapRemove(columnMask_, slot);
+    swapRemove(sizes_, slot);
+    swapRemove(highlightSizes_, slot);
+    swapRemove(modelIds_, slot);
+    swapRemove(routeGroupIds_, slot);
+    swapRemove(waypointGroupIds_, slot);
+    swapRemove(waypointOrders_, slot);
+    return moved;
+}
+
+void EntityStore::setPosition(int slot, double longitude, double latitude, double altitude)
+{
+    longitudes_[slot] = longitude;
+    latitudes_[slot] = latitude;
+    altitudes_[slot] = altitude;
+}
+
+void EntityStore::setFlag(int slot, Flag flag, bool on)
+{
+    if (on) {
+        flags_[slot] |= flag;
+    } else {
+        flags_[slot] &= static_cast<quint8>(~flag);
+    }
+}
+
+QVariant EntityStore::columnValue(int slot, Column column) const
+{
+    if (!hasColumn(slot, column)) {
+        return QVariant();
+    }
+    switch (column) {
+    case SizeColumn:
+        return sizes_[slot];
+    case HighlightSizeColumn:
+        return highlightSizes_[slot];
+    case ModelIdColumn:
+        return modelIds_[slot];
+    case RouteGroupIdColumn:
+        return routeGroupIds_[slot];
+    case WaypointGroupIdColumn:
+        return waypointGroupIds_[slot];
+    case WaypointOrderColumn:
+        return waypointOrders_[slot];
+    default:
+        return QVariant();
+    }
+}
+
+void EntityStore::setColumnValue(int slot, Column column, const QVariant& value)
+{
+    if (column == NoColumn) {
+        return;
+    }
+    const bool valid = value.isValid();
+    if (valid) {
+        columnMask_[slot] |= column;
+    } else {
+        columnMask_[slot] &= static_cast<quint8>(~column);
+    }
+
+    switch (column) {
+    case SizeColumn:
+        sizes_[slot] = valid ? value.toDouble() : 0.0;
+        break;
+    case HighlightSizeColumn:
+        highlightSizes_[slot] = valid ? value.toDouble() : 0.0;
+        break;
+    case ModelIdColumn:
+        modelIds_[slot] = valid ? value.toString() : QString();
+        break;
+    case RouteGroupIdColumn:
+        routeGroupIds_[slot] = valid ? value.toString() : QString();
+        break;
+    case WaypointGroupIdColumn:
+        waypointGroupIds_[slot] = valid ? value.toString() : QString();
+        break;
+    case WaypointOrderColumn:
+        waypointOrders_[slot] = valid ? value.toInt() : 0;
+        break;
+    default:
+        break;
+    }
+}
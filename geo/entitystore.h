@@ -0,0 +1,136 @@
+/**
+ * @file entitystore.h
+ * @brief 实体核心数据存储头文件
+ *
+ * 定义EntityStore类，以列式（结构数组）方式集中保存所有实体的位置、航向、状态标志
+ * 以及常用的类型化属性，GeoEntity只保存自己的槽位下标。
+ */
+
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+
+#include <QString>
+#include <QVariant>
+#include <QVector>
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 实体核心数据存储（结构数组）
+ *
+ * 每个实体在构造时分配一个槽位，析构时释放（用最后一个槽位填补空位，列保持紧凑）。
+ * 各列按槽位下标连续存放：
+ * - 位置：经度、纬度、高度；航向
+ * - 状态标志：可见、选中、悬停、标签显示、被聚合
+ * - 类型化属性列：size、highlightSize、modelId、routeGroupId、waypointGroupId、waypointOrder
+ *
+ * 类型化属性仍可通过GeoEntity::setProperty/getProperty按名称读写（由GeoEntity转发到对应列），
+ * 热路径直接使用GeoEntity的类型化访问函数或本类的列，不再经过字符串查找与QVariant转换。
+ * 批量遍历（拾取、剔除、序列化、导出）可直接扫描连续的列。
+ *
+ * - 全局唯一实例：实体在加入GeoEntityManager之前就需要保存位置与属性
+ * - 仅在主线程使用
+ */
+class EntityStore
+{
+public:
+    /** @brief 状态标志位 */
+    enum Flag : quint8 {
+        Visible = 0x01,
+        Selected = 0x02,
+        Hovered = 0x04,
+        LabelVisible = 0x08,
+        Clustered = 0x10
+    };
+
+    /** @brief 类型化属性列（同时作为“已设置”掩码的位） */
+    enum Column : quint8 {
+        NoColumn = 0x00,
+        SizeColumn = 0x01,
+        HighlightSizeColumn = 0x02,
+        ModelIdColumn = 0x04,
+        RouteGroupIdColumn = 0x08,
+        WaypointGroupIdColumn = 0x10,
+        WaypointOrderColumn = 0x20
+    };
+
+    /** @brief 获取全局实例 */
+    static EntityStore& instance();
+
+    /** @brief 按属性名查找类型化列，不是类型化属性时返回NoColumn */
+    static Column columnForKey(const QString& key);
+    /** @brief 类型化列对应的属性名 */
+    static QString keyForColumn(Column column);
+
+    /** @brief 槽位数（即存活的实体数） */
+    int size() const { return owners_.size(); }
+    /** @brief 槽位所属实体 */
+    GeoEntity* owner(int slot) const { return owners_[slot]; }
+
+    // 位置与航向
+    double longitude(int slot) const { return longitudes_[slot]; }
+    double latitude(int slot) const { return latitudes_[slot]; }
+    double altitude(int slot) const { return altitudes_[slot]; }
+    double heading(int slot) const { return headings_[slot]; }
+    void setPosition(int slot, double longitude, double latitude, double altitude);
+    void setHeading(int slot, double heading) { headings_[slot] = heading; }
+
+    // 状态标志
+    bool testFlag(int slot, Flag flag) const { return (flags_[slot] & flag) != 0; }
+    void setFlag(int slot, Flag flag, bool on);
+    /** @brief 可见且未被聚合 */
+    bool isRendered(int slot) const { return (flags_[slot] & (Visible | Clustered)) == Visible; }
+
+    // 类型化属性列
+    bool hasColumn(int slot, Column column) const { return (columnMask_[slot] & column) != 0; }
+    /** @brief 按列读取为QVariant（未设置时返回无效QVariant） */
+    QVariant columnValue(int slot, Column column) const;
+    /** @brief 按列写入，无效QVariant表示清除 */
+    void setColumnValue(int slot, Column column, const QVariant& value);
+    double sizeValue(int slot) const { return sizes_[slot]; }
+    double highlightSize(int slot) const { return highlightSizes_[slot]; }
+    const QString& modelId(int slot) const { return modelIds_[slot]; }
+    const QString& routeGroupId(int slot) const { return routeGroupIds_[slot]; }
+    const QString& waypointGroupId(int slot) const { return waypointGroupIds_[slot]; }
+    int waypointOrder(int slot) const { return waypointOrders_[slot]; }
+
+    // 批量访问（按槽位连续存放）
+    const QVector<GeoEntity*>& owners() const { return owners_; }
+    const QVector<double>& longitudes() const { return longitudes_; }
+    const QVector<double>& latitudes() const { return latitudes_; }
+    const QVector<double>& altitudes() const { return altitudes_; }
+    const QVector<double>& headings() const { return headings_; }
+    const QVector<quint8>& flags() const { return flags_; }
+
+private:
+    friend class GeoEntity;
+
+    EntityStore() = default;
+    EntityStore(const EntityStore&) = delete;
+    EntityStore& operator=(const EntityStore&) = delete;
+
+    /** @brief 为实体分配槽位（由GeoEntity构造函数调用） */
+    int allocate(GeoEntity* owner);
+    /**
+     * @brief 释放槽位（由GeoEntity析构函数调用），最后一个槽位移入空位
+     * @return 被移入该槽位的实体（调用方更新其槽位下标），没有移动时返回nullptr
+     */
+    GeoEntity* release(int slot);
+
+    QVector<GeoEntity*> owners_;
+    QVector<double> longitudes_;
+    QVector<double> latitudes_;
+    QVector<double> altitudes_;
+    QVector<double> headings_;
+    QVector<quint8> flags_;
+    QVector<quint8> columnMask_;             // 已设置的类型化属性列
+    QVector<double> sizes_;
+    QVector<double> highlightSizes_;
+    QVector<QString> modelIds_;
+    QVector<QString> routeGroupIds_;
+    QVector<QString> waypointGroupIds_;
+    QVector<int> waypointOrders_;
+};
+
+#endif // ENTITYSTORE_H
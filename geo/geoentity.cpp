@@ -7,10 +7,15 @@
 
 #include "geoentity.h"
 #include "geoutils.h"
+#include "entitynodepool.h"
+#include "highlightcache.h"
 #include <QColor>
-#include <osg/LineWidth>
 #include <osg/StateSet>
 #include <osg/Array>
+#include <osg/ValueObject>
+
+int GeoEntity::deferDepth_ = 0;
+QVector<GeoEntity*> GeoEntity::deferredEntities_;
 
 GeoEntity::GeoEntity(const QString& name, const QString& type,
                      double longitude, double latitude, double altitude,
@@ -19,72 +24,98 @@ GeoEntity::GeoEntity(const QString& name, const QString& type,
     , uid_(uidOverride.isEmpty() ? QUuid::createUuid().toString(QUuid::WithoutBraces) : uidOverride)
     , entityName_(name)
     , entityType_(type)
-    , longitude_(longitude)
-    , latitude_(latitude)
-    , altitude_(altitude)
-    , heading_(0.0)
-    , visible_(true)
-    , selected_(false)
-    , hovered_(false)
+    , storeSlot_(EntityStore::instance().allocate(this))
     , lastHighlightSize_(0.0)
 {
+    EntityStore::instance().setPosition(storeSlot_, longitude, latitude, altitude);
+
     // 设置默认属性
     setProperty("size", 100.0);
     setProperty("color", QColor(255, 255, 255));
     setProperty("opacity", 1.0);
 }
 
+GeoEntity::~GeoEntity()
+{
+    if (pendingChanges_ != 0) {
+        deferredEntities_.removeOne(this);
+    }
+
+    // 释放槽位；被移入该槽位的实体更新自己的下标
+    if (GeoEntity* moved = EntityStore::instance().release(storeSlot_)) {
+        moved->storeSlot_ = storeSlot_;
+    }
+}
+
 void GeoEntity::setPosition(double longitude, double latitude, double altitude)
 {
-    longitude_ = longitude;
-    latitude_ = latitude;
-    altitude_ = altitude;
+    EntityStore::instance().setPosition(storeSlot_, longitude, latitude, altitude);
     
     // 自我更新渲染节点
     updateNode();
     
     // 发出信号
+    if (deferChange(PendingPosition)) {
+        return;
+    }
     emit positionChanged(longitude, latitude, altitude);
 }
 
 void GeoEntity::getPosition(double& longitude, double& latitude, double& altitude) const
 {
-    longitude = longitude_;
-    latitude = latitude_;
-    altitude = altitude_;
+    const EntityStore& store = EntityStore::instance();
+    longitude = store.longitude(storeSlot_);
+    latitude = store.latitude(storeSlot_);
+    altitude = store.altitude(storeSlot_);
 }
 
 void GeoEntity::setHeading(double headingDegrees)
 {
-    heading_ = headingDegrees;
+    EntityStore::instance().setHeading(storeSlot_, headingDegrees);
     
     // 自我更新渲染节点
     updateNode();
     
     // 发出信号
-    emit headingChanged(heading_);
+    if (deferChange(PendingHeading)) {
+        return;
+    }
+    emit headingChanged(headingDegrees);
 }
 
 void GeoEntity::setVisible(bool visible)
 {
-    visible_ = visible;
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Visible, visible);
     
     // 自我更新渲染节点
     if (node_) {
-        node_->setNodeMask(visible ? 0xffffffff : 0x0);
+        node_->setNodeMask(isRendered() ? 0xffffffff : 0x0);
     }
     
     // 发出信号
     emit visibilityChanged(visible);
 }
 
+void GeoEntity::setClustered(bool clustered)
+{
+    if (isClustered() == clustered) {
+        return;
+    }
+
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Clustered, clustered);
+    if (node_) {
+        node_->setNodeMask(isRendered() ? 0xffffffff : 0x0);
+    }
+    emit clusteredChanged(clustered);
+}
+
 void GeoEntity::setSelected(bool selected)
 {
-    if (selected_ == selected) {
+    if (isSelected() == selected) {
         return;
     }
 
-    selected_ = selected;
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Selected, selected);
     updateHighlightState();
     updateNode();
     
@@ -94,29 +125,117 @@ void GeoEntity::setSelected(bool selected)
 
 void GeoEntity::setHovered(bool hovered)
 {
-    if (hovered_ == hovered) {
+    if (isHovered() == hovered) {
         return;
     }
 
-    hovered_ = hovered;
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Hovered, hovered);
     updateHighlightState();
+    
+    // 发出信号
+    emit hoverChanged(hovered);
+}
+
+void GeoEntity::setLabelVisible(bool visible)
+{
+    if (isLabelVisible() == visible) {
+        return;
+    }
+
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::LabelVisible, visible);
+    onLabelVisibilityChanged(visible);
+    emit labelVisibilityChanged(visible);
 }
 
 void GeoEntity::setProperty(const QString& key, const QVariant& value)
 {
-    properties_[key] = value;
+    const EntityStore::Column column = EntityStore::columnForKey(key);
+    if (column != EntityStore::NoColumn) {
+        EntityStore::instance().setColumnValue(storeSlot_, column, value);
+    } else {
+        properties_[key] = value;
+    }
     updateHighlightState();
     updateNode();
     
     // 发出信号
+    if (deferChange(PendingProperty)) {
+        if (!pendingKeys_.contains(key)) {
+            pendingKeys_.append(key);
+        }
+        return;
+    }
     emit propertyChanged(key, value);
 }
 
+void GeoEntity::beginDeferredNotifications()
+{
+    ++deferDepth_;
+}
+
+QVector<GeoEntity*> GeoEntity::endDeferredNotifications()
+{
+    if (deferDepth_ <= 0 || --deferDepth_ > 0) {
+        return QVector<GeoEntity*>();
+    }
+    QVector<GeoEntity*> entities;
+    entities.swap(deferredEntities_);
+    return entities;
+}
+
+bool GeoEntity::deferChange(PendingChange change)
+{
+    if (deferDepth_ <= 0) {
+        return false;
+    }
+    if (pendingChanges_ == 0) {
+        deferredEntities_.append(this);
+    }
+    pendingChanges_ |= change;
+    return true;
+}
+
+void GeoEntity::flushDeferredNotifications()
+{
+    const quint8 changes = pendingChanges_;
+    const QStringList keys = pendingKeys_;
+    pendingChanges_ = 0;
+    pendingKeys_.clear();
+
+    const EntityStore& store = EntityStore::instance();
+    if (changes & PendingPosition) {
+        emit positionChanged(store.longitude(storeSlot_), store.latitude(storeSlot_), store.altitude(storeSlot_));
+    }
+    if (changes & PendingHeading) {
+        emit headingChanged(store.heading(storeSlot_));
+    }
+    for (const QString& key : keys) {
+        emit propertyChanged(key, getProperty(key));
+    }
+}
+
 QVariant GeoEntity::getProperty(const QString& key) const
 {
+    const EntityStore::Column column = EntityStore::columnForKey(key);
+    if (column != EntityStore::NoColumn) {
+        return EntityStore::instance().columnValue(storeSlot_, column);
+    }
     return properties_.value(key, QVariant());
 }
 
+QMap<QString, QVariant> GeoEntity::getAllProperties() const
+{
+    QMap<QString, QVariant> result = properties_;
+    const EntityStore& store = EntityStore::instance();
+    for (quint8 bit = EntityStore::SizeColumn; bit <= EntityStore::WaypointOrderColumn; bit <<= 1) {
+        const EntityStore::Column column = static_cast<EntityStore::Column>(bit);
+        if (store.hasColumn(storeSlot_, column)) {
+            result.insert(EntityStore::keyForColumn(column), store.columnValue(storeSlot_, column));
+        }
+    }
+    return result;
+}
+
 /**
  * @brief 初始化实体资源与节点
  * 
@@ -143,38 +262,40 @@ void GeoEntity::initialize()
             rootNode_ = existingPat;
             node_ = contentNode_.get();
 
-            highlightNode_ = buildHighlightGeometry(highlightSize);
+            highlightNode_ = HighlightCache::instance().node(highlightSize);
             if (highlightNode_) {
-                highlightNode_->setNodeMask(0x0);
                 rootNode_->insertChild(0, highlightNode_.get());
             }
         } else if (entityType_ == "waypoint") {
             rootNode_ = createPATNode();
-            highlightNode_ = buildHighlightGeometry(highlightSize);
+            highlightNode_ = HighlightCache::instance().node(highlightSize);
             if (highlightNode_) {
-                highlightNode_->setNodeMask(0x0);
                 rootNode_->addChild(highlightNode_);
             }
 
-            osg::ref_ptr<osg::Group> group = new osg::Group();
+            osg::ref_ptr<osg::Group> group = EntityNodePool::instance().acquireGroup(entityType_);
             group->addChild(rootNode_.get());
             group->addChild(contentNode_.get());
             node_ = group.get();
         } else {
             rootNode_ = createPATNode();
-            highlightNode_ = buildHighlightGeometry(highlightSize);
+            highlightNode_ = HighlightCache::instance().node(highlightSize);
             if (highlightNode_) {
-                highlightNode_->setNodeMask(0x0);
                 rootNode_->addChild(highlightNode_);
             }
             rootNode_->addChild(contentNode_.get());
             node_ = rootNode_.get();
         }
+        lastHighlightSize_ = highlightSize;
+
+        // 高亮状态保存在PAT的用户数据中，由共享高亮节点的裁剪回调读取
+        highlightFlag_ = new osg::BoolValueObject("highlight", false);
+        rootNode_->setUserData(highlightFlag_.get());
 
         // 设置初始状态
         setVisible(true);
         setSelected(false);
-        hovered_ = false;
+        EntityStore::instance().setFlag(storeSlot_, EntityStore::Hovered, false);
         updateHighlightState();
         
         // 设置节点的初始变换（如果控制PAT节点）
@@ -209,7 +330,7 @@ void GeoEntity::update()
  * 
  * 默认实现流程：
  * 1. 调用 onBeforeCleanup() 回调，供子类清理特定资源（如高亮节点、子节点）
- * 2. 清除节点引用（node_ = nullptr）
+ * 2. 清除节点引用（node_ = nullptr），并把节点归还到EntityNodePool供下次创建实体时复用
  * 3. 调用 onAfterCleanup() 回调，供子类做额外的清理工作
  * 
  * @note 子类通常只需重写 onBeforeCleanup() 和 onAfterCleanup()，
@@ -225,16 +346,41 @@ void GeoEntity::cleanup()
     if (rootNode_ && highlightNode_) {
         rootNode_->removeChild(highlightNode_.get());
     }
+    if (rootNode_) {
+        rootNode_->setUserData(nullptr);
+    }
+
+    // 先取出节点并断开实体自身的引用，节点池只接收没有其他持有者的节点
+    // 子类在createNode()中自行搭建的PAT（内容节点即根节点）连同子节点整组归还
+    const bool ownsBundle = rootNode_.valid() && contentNode_ == rootNode_.get();
+    osg::ref_ptr<osg::Node> wrapperNode;
+    if (node_ != rootNode_.get()) {
+        wrapperNode = node_;
+    }
+    osg::ref_ptr<osg::Node> rootNode = rootNode_.get();
+    osg::ref_ptr<osg::Node> contentNode;
+    if (!ownsBundle) {
+        contentNode = contentNode_;
+    }
 
     highlightNode_ = nullptr;
+    highlightFlag_ = nullptr;
     contentNode_ = nullptr;
     rootNode_ = nullptr;
-    hovered_ = false;
-    selected_ = false;
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Hovered, false);
+    EntityStore::instance().setFlag(storeSlot_, EntityStore::Selected, false);
     lastHighlightSize_ = 0.0;
 
     // 清除节点引用
     node_ = nullptr;
+
+    // 按从外到内的顺序归还：外层组清空子节点后，根节点与内容节点才没有父节点
+    EntityNodePool& pool = EntityNodePool::instance();
+    pool.release(entityType_, wrapperNode.get());
+    wrapperNode = nullptr;
+    pool.release(entityType_, rootNode.get(), ownsBundle);
+    rootNode = nullptr;
+    pool.release(entityType_, contentNode.get());
     
     // 子类额外清理
     onAfterCleanup();
@@ -263,7 +409,7 @@ void GeoEntity::updateNode()
  * 
  * 如果节点是 PositionAttitudeTransform 类型，则：
  * 1. 将实体的地理坐标（经纬度、高度）转换为 OSG 世界坐标
- * 2. 根据航向角（heading_）计算旋转四元数（绕Z轴旋转）
+ * 2. 根据航向角计算旋转四元数（绕Z轴旋转）
  * 3. 设置 PAT 节点的位置和姿态
  * 
  * @param node 要设置的节点（如果是 PAT 则设置，否则忽略）
@@ -279,11 +425,14 @@ void GeoEntity::setupNodeTransform(osg::Node* node)
     osg::PositionAttitudeTransform* pat = dynamic_cast<osg::PositionAttitudeTransform*>(node);
     if (pat) {
         // 更新位置：使用工具函数进行地理坐标到世界坐标的转换
-        osg::Vec3d worldPos = GeoUtils::geoToWorldCoordinates(longitude_, latitude_, altitude_);
+        const EntityStore& store = EntityStore::instance();
+        osg::Vec3d worldPos = GeoUtils::geoToWorldCoordinates(store.longitude(storeSlot_),
+                                                              store.latitude(storeSlot_),
+                                                              store.altitude(storeSlot_));
         pat->setPosition(worldPos);
         
         // 更新旋转：将航向角（度）转换为弧度，创建绕Z轴的旋转四元数
-        double angleRad = heading_ * M_PI / 180.0;
+        double angleRad = store.heading(storeSlot_) * M_PI / 180.0;
         osg::Quat rotation(angleRad, osg::Vec3d(0.0, 0.0, 1.0));
         pat->setAttitude(rotation);
     }
@@ -292,7 +441,8 @@ void GeoEntity::setupNodeTransform(osg::Node* node)
 /**
  * @brief 创建并初始化 PositionAttitudeTransform 节点
  * 
- * 创建 PAT 节点并自动设置初始位置和旋转，子类可直接使用。
+ * 从EntityNodePool获取 PAT 节点并自动设置初始位置和旋转，子类可直接使用。
+ * 子类自行搭建并整组归还的节点可能带有上次的子节点，子类可以直接重用。
  * 
  * @return 已设置好变换的 PAT 节点（位置和旋转已根据实体状态初始化）
  * 
@@ -308,7 +458,7 @@ void GeoEntity::setupNodeTransform(osg::Node* node)
  */
 osg::ref_ptr<osg::PositionAttitudeTransform> GeoEntity::createPATNode()
 {
-    osg::ref_ptr<osg::PositionAttitudeTransform> pat = new osg::PositionAttitudeTransform();
+    osg::ref_ptr<osg::PositionAttitudeTransform> pat = EntityNodePool::instance().acquireTransform(entityType_);
     setupNodeTransform(pat.get());
     return pat;
 }
@@ -319,84 +469,34 @@ void GeoEntity::updateHighlightState()
         return;
     }
 
-    bool shouldShow = visible_ && (selected_ || hovered_);
+    bool shouldShow = isRendered() && (isSelected() || isHovered());
     double highlightSize = resolveHighlightSize();
 
+    // 只有尺寸变化时才更换共享边框节点；悬停/选中只改写高亮标志
     if (!highlightNode_ || std::abs(highlightSize - lastHighlightSize_) > 1e-3) {
-        if (highlightNode_) {
-            rootNode_->removeChild(highlightNode_.get());
-        }
-        highlightNode_ = buildHighlightGeometry(highlightSize);
-        if (highlightNode_) {
-            rootNode_->insertChild(0, highlightNode_.get());
-            lastHighlightSize_ = highlightSize;
-        } else {
-            lastHighlightSize_ = highlightSize;
+        osg::ref_ptr<osg::Geode> sharedNode = HighlightCache::instance().node(highlightSize);
+        if (sharedNode != highlightNode_) {
+            if (highlightNode_) {
+                rootNode_->removeChild(highlightNode_.get());
+            }
+            highlightNode_ = sharedNode;
+            if (highlightNode_) {
+                rootNode_->insertChild(0, highlightNode_.get());
+            }
         }
+        lastHighlightSize_ = highlightSize;
     }
 
-    if (highlightNode_) {
-        highlightNode_->setNodeMask(shouldShow ? 0xffffffff : 0x0);
+    if (highlightFlag_) {
+        highlightFlag_->setValue(shouldShow);
     }
 }
 
-osg::ref_ptr<osg::Geode> GeoEntity::buildHighlightGeometry(double size) const
-{
-    if (size <= 0.0) {
-        return nullptr;
-    }
-
-    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
-    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
-
-    // if (entityType_ == "waypoint") {
-    //     const int segments = 64;
-    //     for (int i = 0; i <= segments; ++i) {
-    //         double angle = (2.0 * M_PI * i) / static_cast<double>(segments);
-    //         double x = std::cos(angle) * size;
-    //         double z = std::sin(angle) * size;
-    //         vertices->push_back(osg::Vec3(x, 0.0, z));
-    //     }
-    //     geometry->setVertexArray(vertices.get());
-    //     geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, vertices->size()));
-    // }  
-
-        float borderSize = static_cast<float>(size * 1.1);
-        float borderHalf = borderSize * 0.5f;
-        vertices->push_back(osg::Vec3(-borderHalf, 0.0f, -borderHalf));
-        vertices->push_back(osg::Vec3(borderHalf, 0.0f, -borderHalf));
-        vertices->push_back(osg::Vec3(borderHalf, 0.0f, borderHalf));
-        vertices->push_back(osg::Vec3(-borderHalf, 0.0f, borderHalf));
-        vertices->push_back(osg::Vec3(-borderHalf, 0.0f, -borderHalf));
-        geometry->setVertexArray(vertices.get());
-        geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, vertices->size()));
-     
-
-    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
-    colors->push_back(osg::Vec4(1.0f, 0.1f, 0.1f, 1.0f));
-    geometry->setColorArray(colors.get(), osg::Array::BIND_OVERALL);
-
-    osg::ref_ptr<osg::StateSet> stateSet = geometry->getOrCreateStateSet();
-    stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
-    stateSet->setMode(GL_BLEND, osg::StateAttribute::ON);
-    stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
-    stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
-    stateSet->setAttributeAndModes(new osg::LineWidth(3.0f), osg::StateAttribute::ON);
-
-    geometry->setUseDisplayList(false);
-    geometry->setUseVertexBufferObjects(true);
-    geode->setCullingActive(false);
-
-    geode->addDrawable(geometry.get());
-    return geode.get();
-}
-
 double GeoEntity::resolveHighlightSize() const
 {
-    double highlightSize = properties_.value("highlightSize").toDouble();
+    double highlightSize = getHighlightSize();
     if (highlightSize <= 0.0) {
-        double baseSize = properties_.value("size").toDouble();
+        double baseSize = getSize();
         if (baseSize > 0.0) {
             highlightSize = baseSize;
         } else {
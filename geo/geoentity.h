@@ -5,15 +5,21 @@
 #include <QString>
 #include <QVariant>
 #include <QMap>
+#include <QStringList>
 #include <QUuid>
+#include <QVector>
 #include <QColor>
+#include <QRectF>
 #include <osg/Node>
 #include <osg/PositionAttitudeTransform>
 #include <osg/Geometry>
 #include <osg/Geode>
+#include <osg/ValueObject>
 #include <osgEarth/GeoData>
 #include <osgEarth/SpatialReference>
 #include <cmath>
+#include "entitystore.h"
+#include "entityhandle.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -39,6 +45,10 @@
  * - 状态管理（可见性和选中状态）
  * - 属性管理（动态属性设置）
  * - 节点管理（OSG渲染节点）
+ *
+ * 位置、航向、状态标志与常用属性（size、highlightSize、modelId、routeGroupId、
+ * waypointGroupId、waypointOrder）保存在EntityStore的列中，本类按槽位下标读写，
+ * 其余属性仍保存在属性表中。
  * 
  * **继承关系：**
  * ```
@@ -59,7 +69,7 @@ public:
     GeoEntity(const QString& name, const QString& type,
               double longitude, double latitude, double altitude,
               const QString& uidOverride = QString(), QObject* parent = nullptr);
-    virtual ~GeoEntity() = default;
+    virtual ~GeoEntity();
 
     // 基本信息
     /** @brief 获取实体实例的稳定唯一UID（统一标识符，替代原entityId） */
@@ -88,15 +98,24 @@ public:
      * @param headingDegrees 航向角（度），0表示正北，顺时针为正
      */
     void setHeading(double headingDegrees);
-    double getHeading() const { return heading_; }
+    double getHeading() const { return EntityStore::instance().heading(storeSlot_); }
     
     /** @brief 设置可见性 */
     void setVisible(bool visible);
-    bool isVisible() const { return visible_; }
+    bool isVisible() const { return EntityStore::instance().testFlag(storeSlot_, EntityStore::Visible); }
+    /**
+     * @brief 设置是否被聚合（远距离时由聚合图层以聚合标记代为显示）
+     *
+     * 聚合状态与可见性相互独立：被聚合的实体仍然可见，只是暂不单独绘制。
+     */
+    void setClustered(bool clustered);
+    bool isClustered() const { return EntityStore::instance().testFlag(storeSlot_, EntityStore::Clustered); }
+    /** @brief 实体当前是否单独绘制（可见且未被聚合） */
+    bool isRendered() const { return EntityStore::instance().isRendered(storeSlot_); }
     
     /** @brief 设置选中状态（子类可重写用于高亮等效果） */
     virtual void setSelected(bool selected);
-    bool isSelected() const { return selected_; }
+    bool isSelected() const { return EntityStore::instance().testFlag(storeSlot_, EntityStore::Selected); }
     
     /** @brief 获取渲染节点 */
     osg::ref_ptr<osg::Node> getNode() const { return node_; }
@@ -107,12 +126,58 @@ public:
     void setProperty(const QString& key, const QVariant& value);
     /** @brief 读取自定义属性 */
     QVariant getProperty(const QString& key) const;
-    QMap<QString, QVariant> getAllProperties() const { return properties_; }
+    /** @brief 读取全部属性（含类型化列中已设置的属性） */
+    QMap<QString, QVariant> getAllProperties() const;
+
+    // 类型化属性（直接读取EntityStore的列，未设置时为0或空字符串）
+    double getSize() const { return EntityStore::instance().sizeValue(storeSlot_); }
+    double getHighlightSize() const { return EntityStore::instance().highlightSize(storeSlot_); }
+    QString getModelId() const { return EntityStore::instance().modelId(storeSlot_); }
+    QString getRouteGroupId() const { return EntityStore::instance().routeGroupId(storeSlot_); }
+    QString getWaypointGroupId() const { return EntityStore::instance().waypointGroupId(storeSlot_); }
+    int getWaypointOrder() const { return EntityStore::instance().waypointOrder(storeSlot_); }
+
+    /** @brief 实体在EntityStore中的槽位下标（实体析构前有效，其他实体析构时可能变化） */
+    int storeSlot() const { return storeSlot_; }
+    /** @brief 实体句柄（由GeoEntityManager登记时分配，删除后为空句柄） */
+    EntityHandle handle() const { return handle_; }
+
+    /**
+     * @brief 开始延迟变化通知（可嵌套，由GeoEntityManager::beginBatch调用）
+     *
+     * 延迟期间setPosition/setHeading/setProperty照常写入EntityStore并刷新节点，
+     * 但不立即发出positionChanged/headingChanged/propertyChanged，只在实体上记录待通知的变化；
+     * 同一实体多次写入同一项只通知一次（位置、航向取最终值，属性按键合并）。
+     */
+    static void beginDeferredNotifications();
+    /**
+     * @brief 结束延迟变化通知
+     * @return 最外层结束时返回有待通知变化的实体（按首次变化的顺序），否则返回空列表
+     * @note 调用方需对返回的实体逐个调用flushDeferredNotifications()
+     */
+    static QVector<GeoEntity*> endDeferredNotifications();
+    /** @brief 当前是否处于延迟通知期间 */
+    static bool isDeferringNotifications() { return deferDepth_ > 0; }
+    /** @brief 发出延迟期间合并后的变化信号（每项变化至多一次） */
+    void flushDeferredNotifications();
 
     /** @brief 设置悬停状态 */
     void setHovered(bool hovered);
     /** @brief 是否处于悬停状态 */
-    bool isHovered() const { return hovered_; }
+    bool isHovered() const { return EntityStore::instance().testFlag(storeSlot_, EntityStore::Hovered); }
+
+    /** @brief 实体是否带有文字标签（带标签的实体参与标签避让） */
+    virtual bool hasLabel() const { return false; }
+    /**
+     * @brief 标签在屏幕上的包围矩形
+     * @param metersPerPixel 实体处一个像素对应的米数（世界尺寸的标签据此换算）
+     * @return 相对实体屏幕位置的矩形（像素，Qt坐标，Y向下）；空矩形表示标签过小不必显示
+     */
+    virtual QRectF labelScreenRect(double metersPerPixel) const { Q_UNUSED(metersPerPixel); return QRectF(); }
+    /** @brief 显示/隐藏标签（由标签避让与距离LOD控制，与实体可见性相互独立） */
+    void setLabelVisible(bool visible);
+    /** @brief 标签是否显示 */
+    bool isLabelVisible() const { return EntityStore::instance().testFlag(storeSlot_, EntityStore::LabelVisible); }
     
     // 生命周期（基类提供默认实现，子类可重写扩展）
     /** 
@@ -142,6 +207,9 @@ signals:
     void headingChanged(double heading);
     void visibilityChanged(bool visible);
     void selectionChanged(bool selected);
+    void hoverChanged(bool hovered);
+    void labelVisibilityChanged(bool visible);
+    void clusteredChanged(bool clustered);
     void propertyChanged(const QString& key, const QVariant& value);
 
 protected:
@@ -150,17 +218,16 @@ protected:
     QString entityName_;
     QString entityType_;
     
-    double longitude_, latitude_, altitude_;
-    double heading_;
-    bool visible_;
-    bool selected_;
-    bool hovered_;
+    // EntityStore中的槽位（位置、航向、状态标志与类型化属性）
+    int storeSlot_;
     
+    // 类型化列以外的属性
     QMap<QString, QVariant> properties_;
     osg::ref_ptr<osg::Node> node_;
     osg::ref_ptr<osg::Node> contentNode_;
     osg::ref_ptr<osg::PositionAttitudeTransform> rootNode_;
-    osg::ref_ptr<osg::Geode> highlightNode_;
+    osg::ref_ptr<osg::Geode> highlightNode_;          // 同尺寸档位实体共享的高亮边框节点（HighlightCache）
+    osg::ref_ptr<osg::BoolValueObject> highlightFlag_; // 高亮标志（PAT的用户数据）
     double lastHighlightSize_;
     
     // 子类需要实现的纯虚函数
@@ -175,6 +242,8 @@ protected:
     virtual void onBeforeCleanup() {}
     /** @brief 清理后的回调，子类可重写做额外清理 */
     virtual void onAfterCleanup() {}
+    /** @brief 标签显示状态变化的回调，子类在此开关标签节点 */
+    virtual void onLabelVisibilityChanged(bool visible) { Q_UNUSED(visible); }
     
     // 节点变换辅助方法
     /** 
@@ -197,9 +266,27 @@ protected:
     osg::ref_ptr<osg::PositionAttitudeTransform> createPATNode();
 
 private:
+    friend class EntitySlotMap;
+
+    /** @brief 待通知的变化 */
+    enum PendingChange : quint8 {
+        PendingPosition = 0x01,
+        PendingHeading = 0x02,
+        PendingProperty = 0x04
+    };
+
+    /** @brief 处于延迟通知期间时记录变化并返回true，调用方不再发出信号 */
+    bool deferChange(PendingChange change);
+
     void updateHighlightState();
-    osg::ref_ptr<osg::Geode> buildHighlightGeometry(double size) const;
     double resolveHighlightSize() const;
+
+    EntityHandle handle_;                        // EntitySlotMap分配的句柄
+    quint8 pendingChanges_ = 0;                  // 延迟期间待通知的变化（PendingChange位）
+    QStringList pendingKeys_;                    // 延迟期间变化过的属性键
+
+    static int deferDepth_;
+    static QVector<GeoEntity*> deferredEntities_;
 };
 
 #endif // GEOENTITY_H
@@ -7,8 +7,11 @@
 
 #include "geoentitymanager.h"
 #include "imageentity.h"
+#include "iconcache.h"
+#include "highlightcache.h"
 #include "geoutils.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include <QDebug>
 #include <QFileInfo>
 #include <QDir>
@@ -17,6 +20,7 @@
 #include "mapstatemanager.h"
 #include <osgUtil/LineSegmentIntersector>
 #include <osgViewer/Viewer>
+#include <osg/Viewport>
 #include <cmath>
 #include <limits>
 #include "waypointentity.h"
@@ -26,36 +30,16 @@
 #include <QMenu>
 #include <algorithm>
 #include <QObject>
+#include <QSignalBlocker>
+#include <QSet>
 
 namespace {
+// 航线细分允许的屏幕误差（像素）
+const double kRouteErrorPixels = 1.0;
+
 bool isFinite(double value) {
     return std::isfinite(value);
 }
-
-QVector<osg::Vec3d> generateBezierCurve(const QVector<osg::Vec3d>& controlPoints, int steps)
-{
-    QVector<osg::Vec3d> result;
-    if (controlPoints.isEmpty()) {
-        return result;
-    }
-
-    steps = qMax(1, steps);
-
-    for (int i = 0; i <= steps; ++i) {
-        double t = static_cast<double>(i) / steps;
-        QVector<osg::Vec3d> temp = controlPoints;
-        int n = temp.size();
-        while (n > 1) {
-            for (int k = 0; k < n - 1; ++k) {
-                temp[k] = temp[k] * (1.0 - t) + temp[k + 1] * t;
-            }
-            --n;
-        }
-        result.append(temp[0]);
-    }
-
-    return result;
-}
 }
 
 GeoEntityManager::GeoEntityManager(osg::Group* root, osgEarth::MapNode* mapNode, QObject *parent)
@@ -63,8 +47,6 @@ GeoEntityManager::GeoEntityManager(osg::Group* root, osgEarth::MapNode* mapNode,
     , root_(root)
     , mapNode_(mapNode)
     , entityCounter_(0)
-    , selectedEntity_(nullptr)
-    , hoveredEntity_(nullptr)
     , viewer_(nullptr)
     , mapStateManager_(nullptr)
 {
@@ -72,6 +54,9 @@ GeoEntityManager::GeoEntityManager(osg::Group* root, osgEarth::MapNode* mapNode,
     entityGroup_ = new osg::Group;
     entityGroup_->setName("EntityGroup");
     root_->addChild(entityGroup_);
+    entityGroup_->addChild(iconBatchLayer_.getNode());
+    entityGroup_->addChild(waypointBatchLayer_.getNode());
+    entityGroup_->addChild(clusterLayer_.getNode());
     
     qDebug() << "GeoEntityManager初始化完成";
 }
@@ -86,52 +71,26 @@ GeoEntity* GeoEntityManager::createEntity(const QString& entityType, const QStri
     qDebug() << "位置:" << longitude << latitude << altitude;
     
     try {
-        GeoEntity* entity = nullptr;
-        
-        // 根据实体类型创建不同的实体
-        if (entityType == "aircraft" || entityType == "image") {
-            // 从数据库查询图片路径（根据实体名称查询模型的icon字段）
-            QString imagePath = getImagePathFromDatabase(entityName);
-            if (imagePath.isEmpty()) {
-                qDebug() << "未找到图片路径:" << entityName;
-                return nullptr;
-            }
-            
-            // 创建图片实体（不再需要generateEntityId，使用uid作为统一标识符）
-            entity = new ImageEntity(entityName, imagePath, longitude, latitude, altitude, uidOverride, this);
-        } else if (entityType == "waypoint") {
-            WaypointEntity* waypointEntity = new WaypointEntity(entityName,
-                                                                longitude,
-                                                                latitude,
-                                                                altitude,
-                                                                uidOverride,
-                                                                this);
-            waypointEntity->setMapNode(mapNode_.get());
-            entity = waypointEntity;
+        // 优先使用调用方预先解析的图片路径（如方案加载时在工作线程中完成的查询），
+        // 否则从数据库查询（根据实体名称查询模型的icon字段）
+        QString imagePath = properties.value("imagePath").toString();
+        if (imagePath.isEmpty() && isImageEntityType(entityType)) {
+            imagePath = getImagePathFromDatabase(entityName);
         }
-        
+
+        GeoEntity* entity = instantiateEntity(entityType, entityName, imagePath,
+                                              longitude, latitude, altitude, uidOverride);
         if (!entity) {
-            qDebug() << "未知的实体类型:" << entityType;
             return nullptr;
         }
-        
-        // 初始化实体
-        entity->initialize();
-        
-        // 添加到场景
-        if (entity->getNode()) {
-            entityGroup_->addChild(entity->getNode());
-            entities_[entity->getUid()] = entity;
-            uidToEntity_.insert(entity->getUid(), entity);
-            
-            emit entityCreated(entity);
-            qDebug() << "实体创建成功:" << entity->getUid();
-            return entity;
-        } else {
-            qDebug() << "实体节点创建失败";
+        if (!registerEntity(entity, nullptr)) {
             delete entity;
             return nullptr;
         }
+
+        emit entityCreated(entity);
+        qDebug() << "实体创建成功:" << entity->getUid();
+        return entity;
         
     } catch (const std::exception& e) {
         qDebug() << "createEntity异常:" << e.what();
@@ -142,6 +101,158 @@ GeoEntity* GeoEntityManager::createEntity(const QString& entityType, const QStri
     }
 }
 
+QVector<GeoEntity*> GeoEntityManager::createEntities(const QVector<EntityDescriptor>& descriptors)
+{
+    QVector<GeoEntity*> created(descriptors.size(), nullptr);
+    if (descriptors.isEmpty()) {
+        return created;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 缺少图片路径的模型一次性查询
+    QStringList unresolvedNames;
+    QSet<QString> seenNames;
+    for (const EntityDescriptor& descriptor : descriptors) {
+        if (descriptor.imagePath.isEmpty() && isImageEntityType(descriptor.type)
+            && !seenNames.contains(descriptor.name)) {
+            seenNames.insert(descriptor.name);
+            unresolvedNames.append(descriptor.name);
+        }
+    }
+    const QHash<QString, QString> resolvedPaths = getImagePathsFromDatabase(unresolvedNames);
+
+    QList<GeoEntity*> createdEntities;
+    QVector<osg::ref_ptr<osg::Node>> sceneNodes;
+    sceneNodes.reserve(descriptors.size());
+    {
+        // 创建过程中的位置/属性写入合并为一次通知
+        EntityBatch batch(this);
+        for (int i = 0; i < descriptors.size(); ++i) {
+            const EntityDescriptor& descriptor = descriptors.at(i);
+            const QString imagePath = descriptor.imagePath.isEmpty()
+                                          ? resolvedPaths.value(descriptor.name)
+                                          : descriptor.imagePath;
+            GeoEntity* entity = nullptr;
+            try {
+                entity = instantiateEntity(descriptor.type, descriptor.name, imagePath,
+                                           descriptor.longitude, descriptor.latitude, descriptor.altitude,
+                                           descriptor.uid);
+            } catch (const std::exception& e) {
+                qDebug() << "createEntities异常:" << descriptor.name << e.what();
+            } catch (...) {
+                qDebug() << "createEntities未知异常:" << descriptor.name;
+            }
+            if (!entity) {
+                continue;
+            }
+            if (!registerEntity(entity, &sceneNodes)) {
+                delete entity;
+                continue;
+            }
+            created[i] = entity;
+            createdEntities.append(entity);
+        }
+
+        // 逐个实体的场景节点最后一次性挂到实体组
+        for (const osg::ref_ptr<osg::Node>& node : sceneNodes) {
+            entityGroup_->addChild(node.get());
+        }
+    }
+
+    qDebug() << "批量创建实体:" << createdEntities.size() << "/" << descriptors.size()
+             << "场景节点:" << sceneNodes.size() << "耗时(ms):" << timer.elapsed()
+             << "节点池复用率:" << EntityNodePool::instance().stats().reuseRate;
+    if (!createdEntities.isEmpty()) {
+        emit entitiesCreated(createdEntities);
+    }
+    return created;
+}
+
+bool GeoEntityManager::isImageEntityType(const QString& entityType)
+{
+    return entityType == QStringLiteral("aircraft") || entityType == QStringLiteral("image");
+}
+
+GeoEntity* GeoEntityManager::instantiateEntity(const QString& entityType, const QString& entityName,
+                                               const QString& imagePath,
+                                               double longitude, double latitude, double altitude,
+                                               const QString& uidOverride)
+{
+    GeoEntity* entity = nullptr;
+
+    // 根据实体类型创建不同的实体
+    if (isImageEntityType(entityType)) {
+        if (imagePath.isEmpty()) {
+            qDebug() << "未找到图片路径:" << entityName;
+            return nullptr;
+        }
+
+        // 创建图片实体（不再需要generateEntityId，使用uid作为统一标识符）
+        ImageEntity* imageEntity = new ImageEntity(entityName, imagePath, longitude, latitude, altitude, uidOverride, this);
+        imageEntity->setBatched(iconBatchingEnabled_);
+        entity = imageEntity;
+    } else if (entityType == "waypoint") {
+        WaypointEntity* waypointEntity = new WaypointEntity(entityName,
+                                                            longitude,
+                                                            latitude,
+                                                            altitude,
+                                                            uidOverride,
+                                                            this);
+        waypointEntity->setMapNode(mapNode_.get());
+        waypointEntity->setBatched(waypointBatchingEnabled_);
+        entity = waypointEntity;
+    }
+
+    if (!entity) {
+        qDebug() << "未知的实体类型:" << entityType;
+        return nullptr;
+    }
+
+    // 初始化实体
+    entity->initialize();
+    return entity;
+}
+
+bool GeoEntityManager::registerEntity(GeoEntity* entity, QVector<osg::ref_ptr<osg::Node>>* sceneNodes)
+{
+    // 先完成所有可能失败的检查：失败返回时实体尚未挂到任何图层或索引，调用方可以直接删除
+    if (!entity->getNode()) {
+        qDebug() << "实体节点创建失败";
+        return false;
+    }
+
+    // 添加到场景（批量绘制的图片实体由实例化图标图层绘制）
+    ImageEntity* batchedEntity = qobject_cast<ImageEntity*>(entity);
+    if (batchedEntity && !batchedEntity->isBatched()) {
+        batchedEntity = nullptr;
+    }
+    // 加入图标图层失败时图层不保留该实体
+    if (batchedEntity && !attachToIconBatch(batchedEntity)) {
+        qDebug() << "实体加入实例化图标图层失败";
+        return false;
+    }
+    WaypointEntity* batchedWaypoint = qobject_cast<WaypointEntity*>(entity);
+    if (batchedWaypoint && !batchedWaypoint->isBatched()) {
+        batchedWaypoint = nullptr;
+    }
+
+    if (batchedWaypoint) {
+        attachToWaypointBatch(batchedWaypoint);
+    } else if (!batchedEntity) {
+        if (sceneNodes) {
+            sceneNodes->append(entity->getNode());
+        } else {
+            entityGroup_->addChild(entity->getNode());
+        }
+    }
+    entities_[entity->getUid()] = entity;
+    slots_.insert(entity);
+    indexEntity(entity);
+    return true;
+}
+
 /**
  * @brief 从拖拽数据添加实体
  * 
@@ -188,7 +299,18 @@ GeoEntity* GeoEntityManager::getEntity(const QString& uid)
 
 GeoEntity* GeoEntityManager::getEntityByUid(const QString& uid) const
 {
-    return uidToEntity_.value(uid, nullptr);
+    return entities_.value(uid, nullptr);
+}
+
+GeoEntity* GeoEntityManager::getEntity(EntityHandle handle) const
+{
+    return slots_.get(handle);
+}
+
+EntityHandle GeoEntityManager::getEntityHandle(const QString& uid) const
+{
+    GeoEntity* entity = entities_.value(uid, nullptr);
+    return entity ? entity->handle() : EntityHandle();
 }
 
 QList<GeoEntity*> GeoEntityManager::getAllEntities() const
@@ -198,38 +320,49 @@ QList<GeoEntity*> GeoEntityManager::getAllEntities() const
 
 GeoEntity* GeoEntityManager::getSelectedEntity() const
 {
-    return selectedEntity_;
+    return slots_.get(selectedHandle_);
 }
 
 void GeoEntityManager::setSelectedEntity(GeoEntity* entity, bool emitSignal)
 {
-    if (selectedEntity_ == entity) {
+    GeoEntity* previous = getSelectedEntity();
+    if (previous == entity) {
         return;
     }
 
-    if (selectedEntity_) {
-        selectedEntity_->setSelected(false);
+    if (previous) {
+        previous->setSelected(false);
         if (emitSignal) {
             emit entityDeselected();
         }
     }
 
-    selectedEntity_ = entity;
-    if (hoveredEntity_ == selectedEntity_) {
-        if (hoveredEntity_) {
-            hoveredEntity_->setHovered(false);
+    selectedHandle_ = entity ? entity->handle() : EntityHandle();
+    GeoEntity* hovered = hoveredEntity();
+    if (hovered == entity) {
+        if (hovered) {
+            hovered->setHovered(false);
         }
-        hoveredEntity_ = nullptr;
+        hoveredHandle_ = EntityHandle();
     }
 
-    if (selectedEntity_) {
-        selectedEntity_->setSelected(true);
+    if (entity) {
+        entity->setSelected(true);
         if (emitSignal) {
-            emit entitySelected(selectedEntity_);
+            emit entitySelected(entity);
         }
     }
 }
 
+void GeoEntityManager::clearHovered(GeoEntity* entity)
+{
+    GeoEntity* hovered = hoveredEntity();
+    if (hovered && (!entity || hovered == entity)) {
+        hovered->setHovered(false);
+        hoveredHandle_ = EntityHandle();
+    }
+}
+
 //bool GeoEntityManager::setEntityVisible(const QString& uid, bool visible)
 //{
 //    GeoEntity* entity = getEntity(uid);
@@ -259,13 +392,10 @@ bool GeoEntityManager::setEntityVisible(const QString& uid, bool visible)
 
     entity->setVisible(visible);
     if (!visible) {
-        if (selectedEntity_ == entity) {
+        if (getSelectedEntity() == entity) {
             setSelectedEntity(nullptr);
         }
-        if (hoveredEntity_ == entity) {
-            hoveredEntity_->setHovered(false);
-            hoveredEntity_ = nullptr;
-        }
+        clearHovered(entity);
     }
 
     if (entity->getType() == QStringLiteral("line")) {
@@ -289,9 +419,47 @@ bool GeoEntityManager::setEntityVisible(const QString& uid, bool visible)
     return true;
 }
 
+void GeoEntityManager::beginBatch()
+{
+    if (batchDepth_++ == 0) {
+        GeoEntity::beginDeferredNotifications();
+    }
+}
+
+void GeoEntityManager::commitBatch()
+{
+    if (batchDepth_ <= 0 || --batchDepth_ > 0) {
+        return;
+    }
+
+    const QVector<GeoEntity*> changed = GeoEntity::endDeferredNotifications();
+    if (changed.isEmpty()) {
+        return;
+    }
+
+    QStringList uids;
+    uids.reserve(changed.size());
+    {
+        // 每个实体的合并通知只更新内部索引，期间的逐实体sceneChanged合并为提交后的一次
+        const QSignalBlocker blocker(this);
+        for (GeoEntity* entity : changed) {
+            entity->flushDeferredNotifications();
+            if (entities_.contains(entity->getUid())) {
+                uids.append(entity->getUid());
+            }
+        }
+    }
+
+    qDebug() << "批量修改提交: 实体" << changed.size() << "个";
+    if (!uids.isEmpty()) {
+        emit entitiesChanged(uids);
+    }
+    emit sceneChanged();
+}
+
 bool GeoEntityManager::isEntityVisible(const QString& uid) const
 {
-    GeoEntity* entity = uidToEntity_.value(uid, nullptr);
+    GeoEntity* entity = entities_.value(uid, nullptr);
     return entity ? entity->isVisible() : false;
 }
 
@@ -459,14 +627,11 @@ void GeoEntityManager::removeEntity(const QString& uid)
         }
 
     // 清除选中/悬停引用
-    if (selectedEntity_ == entity) {
+    if (getSelectedEntity() == entity) {
         setSelectedEntity(nullptr);
         qDebug() << "清除选中实体引用";
     }
-    if (hoveredEntity_ == entity) {
-        hoveredEntity_->setHovered(false);
-        hoveredEntity_ = nullptr;
-    }
+    clearHovered(entity);
 
     // 立即从场景中移除节点（禁用节点，防止渲染时访问）
     // 这是安全的，因为removeChild不会访问节点内容，只是移除引用
@@ -477,22 +642,19 @@ void GeoEntityManager::removeEntity(const QString& uid)
         entityGroup_->removeChild(entity->getNode());
         qDebug() << "从场景中移除实体节点";
     }
+    iconBatchLayer_.removeEntity(entity);
+    waypointBatchLayer_.removeWaypoint(qobject_cast<WaypointEntity*>(entity));
 
     // 从映射中移除（但不删除entity对象）
     entities_.remove(uid);
-    if (entity) {
-        uidToEntity_.remove(entity->getUid());
-    }
+    unindexEntity(entity);
 
-    // 保存到待删除队列，延迟真正删除（避免在渲染过程中删除对象）
-    pendingEntities_[uid] = entity;
-    if (!pendingDeletions_.contains(uid)) {
-        pendingDeletions_.enqueue(uid);
-    }
+    // 句柄立即失效，实体对象延迟到processPendingDeletions()回收（避免在渲染过程中删除对象）
+    slots_.retire(entity->handle());
 
     // 立即发出删除信号（UI可以立即更新）
     emit entityRemoved(uid);
-    qDebug() << "实体已标记为待删除:" << uid << "将在下一帧渲染后真正删除";
+    qDebug() << "实体已标记为待删除:" << uid << "将在下次回收时真正删除";
 }
 
 void GeoEntityManager::clearAllEntities()
@@ -500,13 +662,10 @@ void GeoEntityManager::clearAllEntities()
     qDebug() << "清空所有实体";
 
     // 清除选中实体引用
-    if (selectedEntity_) {
+    if (getSelectedEntity()) {
         setSelectedEntity(nullptr);
     }
-    if (hoveredEntity_) {
-        hoveredEntity_->setHovered(false);
-        hoveredEntity_ = nullptr;
-    }
+    clearHovered(nullptr);
 
     // 将所有实体添加到延迟删除队列
     QStringList entityIds = getEntityIds();
@@ -519,17 +678,21 @@ void GeoEntityManager::clearAllEntities()
                 entityGroup_->removeChild(entity->getNode());
             }
 
-            // 从映射中移除，添加到待删除队列
+            // 从映射中移除，句柄失效，等待processPendingDeletions()回收
+            // （空间索引、拾取缓冲、标签避让、聚合图层随后整体清空，不逐个移除）
             entities_.remove(entityId);
-            pendingEntities_[entityId] = entity;
-            if (!pendingDeletions_.contains(entityId)) {
-                pendingDeletions_.enqueue(entityId);
-            }
+            slots_.retire(entity->handle());
         }
     }
 
     entityCounter_ = 0;
-    qDebug() << "所有实体已标记为待删除，将在下一帧渲染后真正删除";
+    spatialIndex_.clear();
+    screenPickBuffer_.clear();
+    labelDeclutter_.clear();
+    clusterLayer_.clear();
+    iconBatchLayer_.clear();
+    waypointBatchLayer_.clear();
+    qDebug() << "所有实体已标记为待删除，将在下次回收时真正删除";
 
     for (auto it = lineEndpoints_.begin(); it != lineEndpoints_.end(); ++it) {
         disconnectLineEndpointConnections(it.value());
@@ -618,39 +781,56 @@ QString GeoEntityManager::generateEntityId(const QString& entityType, const QStr
 
 QString GeoEntityManager::getImagePathFromDatabase(const QString& entityName)
 {
-    // 从数据库查询模型的icon字段（存储的是绝对路径）
-    QSqlDatabase db = DatabaseUtils::getDatabase();
-    
-    // 确保数据库已打开
-    if (!DatabaseUtils::isDatabaseOpen()) {
-        if (!DatabaseUtils::openDatabase()) {
-            qDebug() << "无法打开数据库:" << db.lastError().text();
-            return QString();
+    // 从模型目录缓存查询icon字段（存储的是绝对路径）
+    CatalogModel model = CatalogCache::instance().modelByName(entityName);
+    if (model.id.isEmpty()) {
+        qDebug() << "未找到模型:" << entityName;
+    } else if (!model.icon.isEmpty()) {
+        // 验证文件是否存在
+        QFileInfo fileInfo(model.icon);
+        if (fileInfo.exists() && fileInfo.isFile()) {
+            qDebug() << "从数据库找到图片路径:" << model.icon;
+            return model.icon;
+        } else {
+            qDebug() << "数据库中的图片路径不存在:" << model.icon;
         }
     }
     
-    QSqlQuery query;
-    query.prepare("SELECT icon FROM ModelInformation WHERE name = ?");
-    query.addBindValue(entityName);
-    
-    if (query.exec() && query.next()) {
-        QString iconPath = query.value(0).toString();
-        if (!iconPath.isEmpty()) {
-            // 验证文件是否存在
-            QFileInfo fileInfo(iconPath);
-            if (fileInfo.exists() && fileInfo.isFile()) {
-                qDebug() << "从数据库找到图片路径:" << iconPath;
-                return iconPath;
-            } else {
-                qDebug() << "数据库中的图片路径不存在:" << iconPath;
+    qDebug() << "未找到实体对应的图片路径:" << entityName;
+    return QString();
+}
+
+QHash<QString, QString> GeoEntityManager::getImagePathsFromDatabase(const QStringList& entityNames)
+{
+    QHash<QString, QString> paths;
+    if (entityNames.isEmpty()) {
+        return paths;
+    }
+
+    // 一次查询模型目录缓存，每个图标文件只检查一次是否存在
+    const QHash<QString, CatalogModel> models = CatalogCache::instance().modelsByName(entityNames);
+    QHash<QString, bool> iconExists;
+    for (auto it = models.constBegin(); it != models.constEnd(); ++it) {
+        const QString& icon = it.value().icon;
+        if (icon.isEmpty()) {
+            continue;
+        }
+        auto exists = iconExists.constFind(icon);
+        if (exists == iconExists.constEnd()) {
+            const QFileInfo fileInfo(icon);
+            exists = iconExists.insert(icon, fileInfo.exists() && fileInfo.isFile());
+            if (!exists.value()) {
+                qDebug() << "数据库中的图片路径不存在:" << icon;
             }
         }
-    } else {
-        qDebug() << "数据库查询失败或未找到模型:" << entityName << query.lastError().text();
+        if (exists.value()) {
+            paths.insert(it.key(), icon);
+        }
     }
-    
-    qDebug() << "未找到实体对应的图片路径:" << entityName;
-    return QString();
+    if (paths.size() < entityNames.size()) {
+        qDebug() << "批量查询图片路径: 未找到" << (entityNames.size() - paths.size()) << "个模型的图片";
+    }
+    return paths;
 }
 
 QString GeoEntityManager::getImagePathFromConfig(const QString& entityName)
@@ -689,6 +869,135 @@ double GeoEntityManager::computeSelectionThreshold() const
     return thresholdMeters;
 }
 
+void GeoEntityManager::indexEntity(GeoEntity* entity)
+{
+    if (!entity || spatialIndex_.contains(entity)) {
+        return;
+    }
+
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    entity->getPosition(longitude, latitude, altitude);
+    spatialIndex_.insert(entity, longitude, latitude);
+    screenPickBuffer_.addEntity(entity);
+
+    // 位置变化时增量更新索引；实体析构时连接自动断开
+    connect(entity, &GeoEntity::positionChanged, this, [this, entity](double lon, double lat, double) {
+        spatialIndex_.update(entity, lon, lat);
+        screenPickBuffer_.updateEntity(entity);
+    });
+    connect(entity, &GeoEntity::visibilityChanged, this, [this]() {
+        screenPickBuffer_.invalidate();
+        emit sceneChanged();
+    });
+    connect(entity, &GeoEntity::positionChanged, this, &GeoEntityManager::sceneChanged);
+    connect(entity, &GeoEntity::headingChanged, this, &GeoEntityManager::sceneChanged);
+    connect(entity, &GeoEntity::selectionChanged, this, &GeoEntityManager::sceneChanged);
+    connect(entity, &GeoEntity::propertyChanged, this, &GeoEntityManager::sceneChanged);
+
+    // 标签文字变化会改变标签矩形，需要重新避让
+    labelDeclutter_.addEntity(entity);
+    connect(entity, &GeoEntity::propertyChanged, this, [this]() {
+        labelDeclutter_.invalidate();
+    });
+    // 被聚合的实体不再单独拾取与显示标签
+    connect(entity, &GeoEntity::clusteredChanged, this, [this]() {
+        screenPickBuffer_.invalidate();
+        labelDeclutter_.invalidate();
+        emit sceneChanged();
+    });
+    if (ImageEntity* image = qobject_cast<ImageEntity*>(entity)) {
+        clusterLayer_.addEntity(image, image->getImagePath());
+        auto refreshCluster = [this, image]() {
+            clusterLayer_.updateEntity(image);
+        };
+        connect(image, &GeoEntity::positionChanged, this, refreshCluster);
+        connect(image, &GeoEntity::visibilityChanged, this, refreshCluster);
+    }
+    if (WaypointEntity* waypoint = qobject_cast<WaypointEntity*>(entity)) {
+        connect(waypoint, &WaypointEntity::labelChanged, this, [this]() {
+            labelDeclutter_.invalidate();
+            emit sceneChanged();
+        });
+        // 分组航点移动时只改写所属航线的相邻航段
+        connect(waypoint, &GeoEntity::positionChanged, this, [this, waypoint]() {
+            refreshRoutePoint(waypoint);
+        });
+    }
+}
+
+void GeoEntityManager::unindexEntity(GeoEntity* entity)
+{
+    spatialIndex_.remove(entity);
+    screenPickBuffer_.removeEntity(entity);
+    labelDeclutter_.removeEntity(entity);
+    clusterLayer_.removeEntity(entity);
+}
+
+bool GeoEntityManager::attachToIconBatch(ImageEntity* entity)
+{
+    QString errorMsg;
+    if (!iconBatchLayer_.addEntity(entity, entity->getImagePath(), &errorMsg)) {
+        qDebug() << "无法加载图片:" << entity->getImagePath() << errorMsg;
+        return false;
+    }
+
+    // 任何影响绘制的状态变化只改写该实体的实例槽位
+    auto refreshSlot = [this, entity]() {
+        iconBatchLayer_.updateEntity(entity);
+    };
+    connect(entity, &GeoEntity::positionChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::headingChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::visibilityChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::selectionChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::hoverChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::propertyChanged, this, refreshSlot);
+    connect(entity, &GeoEntity::clusteredChanged, this, refreshSlot);
+    return true;
+}
+
+void GeoEntityManager::setIconBatchingEnabled(bool enabled)
+{
+    if (iconBatchingEnabled_ == enabled) {
+        return;
+    }
+    iconBatchingEnabled_ = enabled;
+    qDebug() << "实例化图标图层:" << (enabled ? "启用" : "关闭")
+             << "当前批次:" << iconBatchLayer_.stats().batchCount
+             << "实例:" << iconBatchLayer_.stats().instanceCount;
+}
+
+void GeoEntityManager::attachToWaypointBatch(WaypointEntity* waypoint)
+{
+    if (waypointBatchLayer_.contains(waypoint)) {
+        return;
+    }
+    waypointBatchLayer_.addWaypoint(waypoint);
+
+    // 位置/可见/高亮变化只改写该航点的槽位，标签变化在下一次更新遍历时统一重建
+    auto refreshSlot = [this, waypoint]() {
+        waypointBatchLayer_.updateWaypoint(waypoint);
+    };
+    connect(waypoint, &GeoEntity::positionChanged, this, refreshSlot);
+    connect(waypoint, &GeoEntity::visibilityChanged, this, refreshSlot);
+    connect(waypoint, &GeoEntity::selectionChanged, this, refreshSlot);
+    connect(waypoint, &GeoEntity::hoverChanged, this, refreshSlot);
+    connect(waypoint, &WaypointEntity::labelChanged, this, refreshSlot);
+    connect(waypoint, &GeoEntity::labelVisibilityChanged, this, refreshSlot);
+}
+
+void GeoEntityManager::setWaypointBatchingEnabled(bool enabled)
+{
+    if (waypointBatchingEnabled_ == enabled) {
+        return;
+    }
+    waypointBatchingEnabled_ = enabled;
+    qDebug() << "航点批量图层:" << (enabled ? "启用" : "关闭")
+             << "当前航点:" << waypointBatchLayer_.stats().waypointCount
+             << "字符实例:" << waypointBatchLayer_.stats().glyphInstances;
+}
+
 bool GeoEntityManager::collectPickCandidates(QPoint screenPos, QVector<PickCandidate>& outCandidates, double& thresholdMeters, bool verbose)
 {
     outCandidates.clear();
@@ -718,13 +1027,22 @@ bool GeoEntityManager::collectPickCandidates(QPoint screenPos, QVector<PickCandi
 
     double minDistance = std::numeric_limits<double>::max();
 
-    QStringList entityUids = getEntityIds();
-    for (const QString& uid : entityUids) {
-        GeoEntity* entity = getEntity(uid);
+    // 先通过空间索引取阈值范围内网格单元中的候选实体，再计算精确距离
+    QVector<GeoEntity*> nearbyEntities;
+    int visitedCells = spatialIndex_.queryRadius(mouseLongitude, mouseLatitude, thresholdMeters, nearbyEntities);
+    if (verbose) {
+        const ScreenPickBuffer::CullStats cull = screenPickBuffer_.cullStats();
+        qDebug() << "空间索引查询: 网格单元" << visitedCells << "候选实体" << nearbyEntities.size()
+                 << "/" << spatialIndex_.size()
+                 << "可能可见:" << cull.visible << "/" << cull.total;
+    }
+
+    for (GeoEntity* entity : nearbyEntities) {
         if (!entity) {
             continue;
         }
-        if (!entity->isVisible() || !entity->getNode()) {
+        // 地球背面或视锥以外的实体不可能被点中
+        if (!entity->isRendered() || !entity->getNode() || !screenPickBuffer_.isPotentiallyVisible(entity)) {
             continue;
         }
 
@@ -796,7 +1114,7 @@ void GeoEntityManager::onMousePress(QMouseEvent* event)
         }
 
         if (candidates.isEmpty()) {
-            if (selectedEntity_) {
+            if (getSelectedEntity()) {
                 setSelectedEntity(nullptr);
                 qDebug() << "取消实体选择";
             }
@@ -806,7 +1124,7 @@ void GeoEntityManager::onMousePress(QMouseEvent* event)
 
         if (candidates.size() == 1) {
             GeoEntity* entity = candidates.first().entity;
-            if (entity && selectedEntity_ != entity) {
+            if (entity && getSelectedEntity() != entity) {
                 setSelectedEntity(entity);
                 qDebug() << "选择实体:" << entity->getName() << "UID:" << entity->getUid();
             }
@@ -828,7 +1146,7 @@ void GeoEntityManager::onMousePress(QMouseEvent* event)
         QAction* chosen = menu.exec(event->globalPos());
         if (chosen) {
             GeoEntity* selected = actionMap.value(chosen, nullptr);
-            if (selected && selectedEntity_ != selected) {
+            if (selected && getSelectedEntity() != selected) {
                 setSelectedEntity(selected);
                 qDebug() << "选择实体:" << selected->getName() << "UID:" << selected->getUid();
             }
@@ -836,7 +1154,7 @@ void GeoEntityManager::onMousePress(QMouseEvent* event)
     } else if (event->button() == Qt::RightButton) {
         // 右键：先发结束标绘信号，再按需发实体菜单
         emit mapRightClicked(event->pos());
-        GeoEntity* entity = selectedEntity_;
+        GeoEntity* entity = getSelectedEntity();
         if (!entity) {
             entity = findEntityAtPosition(event->pos());
         }
@@ -865,42 +1183,90 @@ void GeoEntityManager::onMouseDoubleClick(QMouseEvent* event)
 
 void GeoEntityManager::onMouseMove(QMouseEvent* event)
 {
-    //每次移动鼠标都计算最近的实体
-    // if (!mapStateManager_) {
-    //         return;
-    //     }
-
-    // GeoEntity* entity = findEntityAtPosition(event->pos(), false);
-
-    // if (entity == selectedEntity_) {
-    //     if (hoveredEntity_ && hoveredEntity_ != selectedEntity_) {
-    //         hoveredEntity_->setHovered(false);
-    //     }
-    //     hoveredEntity_ = nullptr;
-    //     return;
-    // }
-
-    // if (entity) {
-    //     if (hoveredEntity_ != entity) {
-    //         if (hoveredEntity_) {
-    //             hoveredEntity_->setHovered(false);
-    //         }
-    //         if (entity != selectedEntity_) {
-    //             entity->setHovered(true);
-    //             hoveredEntity_ = entity;
-    //         } else {
-    //             hoveredEntity_ = nullptr;
-    //         }
-    //     }
-    // } else {
-    //     if (hoveredEntity_) {
-    //         hoveredEntity_->setHovered(false);
-    //     }
-    //     hoveredEntity_ = nullptr;
-    // }
+    updateHover(event->pos());
+}
 
+void GeoEntityManager::updateHover(QPoint screenPos)
+{
+    // 悬停只查询屏幕投影缓存（上一帧渲染后计算），不做地形射线求交
+    GeoEntity* entity = findEntityAtScreen(screenPos);
+    GeoEntity* selected = getSelectedEntity();
+    GeoEntity* hovered = hoveredEntity();
+
+    if (entity == selected) {
+        if (hovered && hovered != selected) {
+            hovered->setHovered(false);
+        }
+        hoveredHandle_ = EntityHandle();
+        return;
+    }
 
-    
+    if (entity) {
+        if (hovered != entity) {
+            if (hovered) {
+                hovered->setHovered(false);
+            }
+            entity->setHovered(true);
+            hoveredHandle_ = entity->handle();
+            emit sceneChanged();
+        }
+    } else {
+        if (hovered) {
+            hovered->setHovered(false);
+            emit sceneChanged();
+        }
+        hoveredHandle_ = EntityHandle();
+    }
+}
+
+void GeoEntityManager::updateScreenProjection()
+{
+    if (!viewer_ || !viewer_->getCamera()) {
+        return;
+    }
+    osg::Camera* camera = viewer_->getCamera();
+
+    // 透视投影下深度为d处一个像素对应 d * 2 / (P[1][1] * 视口高度) 米
+    double pixelScale = 0.0;
+    const osg::Viewport* viewport = camera->getViewport();
+    const double focal = camera->getProjectionMatrix()(1, 1);
+    if (viewport && viewport->height() > 0.0 && focal > 0.0) {
+        pixelScale = 2.0 / (focal * viewport->height());
+    }
+    const double rangeMeters = mapStateManager_ ? mapStateManager_->getRange() : 0.0;
+
+    // 先确定聚合状态：被聚合的实体不参与本次投影与标签避让
+    if (clusterLayer_.update(rangeMeters, pixelScale)) {
+        emit sceneChanged();
+    }
+    const bool projected = screenPickBuffer_.project(camera);
+
+    if (labelDeclutter_.run(screenPickBuffer_, projected, rangeMeters, pixelScale,
+                            getSelectedEntity(), hoveredEntity())) {
+        waypointBatchLayer_.setLabelsEnabled(labelDeclutter_.labelsInRange()
+                                             || labelDeclutter_.stats().shown > 0);
+        emit sceneChanged();
+    }
+
+    // 航线细分误差取视点中心处约一个像素对应的米数（航线内部分档，未跨档时不做计算）
+    if (rangeMeters > 0.0 && pixelScale > 0.0) {
+        const double toleranceMeters = rangeMeters * pixelScale * kRouteErrorPixels;
+        routeToleranceMeters_ = toleranceMeters;
+        bool routesChanged = false;
+        for (auto it = waypointGroups_.begin(); it != waypointGroups_.end(); ++it) {
+            if (it->route.valid()) {
+                routesChanged |= it->route->setErrorTolerance(toleranceMeters);
+            }
+        }
+        if (routesChanged) {
+            emit sceneChanged();
+        }
+    }
+}
+
+GeoEntity* GeoEntityManager::findEntityAtScreen(QPoint screenPos, double radiusPixels) const
+{
+    return screenPickBuffer_.pick(QPointF(screenPos), radiusPixels);
 }
 
 /**
@@ -930,7 +1296,7 @@ GeoEntity* GeoEntityManager::findEntityAtPosition(QPoint screenPos, bool verbose
 QString GeoEntityManager::createWaypointGroup(const QString& name)
 {
     QString gid = QString("wpgroup_%1").arg(++entityCounter_);
-    WaypointGroupInfo info; info.groupId = gid; info.name = name; info.routeNode = nullptr; info.routeModel = QStringLiteral("linear");
+    WaypointGroupInfo info; info.groupId = gid; info.name = name; info.routeModel = QStringLiteral("linear");
     waypointGroups_.insert(gid, info);
     return gid;
 }
@@ -946,6 +1312,7 @@ WaypointEntity* GeoEntityManager::addWaypointToGroup(const QString& groupId, dou
                                             lon, lat, alt, uidOverride, this);
     // 优先绑定 MapNode，确保 PlaceNode 立即可见
     wp->setMapNode(mapNode_.get());
+    wp->setBatched(waypointBatchingEnabled_);
     wp->initialize();
     // 标记序号
     if (label.isEmpty()) {
@@ -954,17 +1321,23 @@ WaypointEntity* GeoEntityManager::addWaypointToGroup(const QString& groupId, dou
         wp->setOrderLabel(label);
     }
 
-    if (wp->getNode()) {
+    if (wp->isBatched()) {
+        attachToWaypointBatch(wp);
+    } else if (wp->getNode()) {
         entityGroup_->addChild(wp->getNode());
     }
     it->waypoints.push_back(wp);
+    if (it->route.valid()) {
+        it->route->insertPoint(it->waypoints.size() - 1, wp);
+    }
 
     wp->setProperty("waypointGroupId", groupId);
     wp->setProperty("waypointOrder", it->waypoints.size());
 
     // 也注册到通用实体表（可选）
     entities_.insert(wp->getUid(), wp);
-    uidToEntity_.insert(wp->getUid(), wp);
+    slots_.insert(wp);
+    indexEntity(wp);
     emit entityCreated(wp);
 
     return wp;
@@ -985,6 +1358,7 @@ bool GeoEntityManager::attachWaypointToGroup(const QString& groupId, WaypointEnt
         auto currentIt = waypointGroups_.find(currentGroup);
         if (currentIt != waypointGroups_.end() && index >= 0 && index < currentIt->waypoints.size()) {
             currentIt->waypoints.removeAt(index);
+            removeRoutePoint(currentIt.value(), index);
             for (int i = 0; i < currentIt->waypoints.size(); ++i) {
                 currentIt->waypoints[i]->setOrderLabel(QString::number(i + 1));
                 currentIt->waypoints[i]->setProperty("waypointOrder", i + 1);
@@ -995,13 +1369,19 @@ bool GeoEntityManager::attachWaypointToGroup(const QString& groupId, WaypointEnt
     auto& info = waypointGroups_[groupId];
     if (!info.waypoints.contains(waypoint)) {
         info.waypoints.push_back(waypoint);
+        if (info.route.valid()) {
+            info.route->insertPoint(info.waypoints.size() - 1, waypoint);
+        }
     }
 
     waypoint->setMapNode(mapNode_.get());
     if (!waypoint->getNode()) {
+        waypoint->setBatched(waypointBatchingEnabled_);
         waypoint->initialize();
     }
-    if (waypoint->getNode() && !entityGroup_->containsNode(waypoint->getNode())) {
+    if (waypoint->isBatched()) {
+        attachToWaypointBatch(waypoint);
+    } else if (waypoint->getNode() && !entityGroup_->containsNode(waypoint->getNode())) {
         entityGroup_->addChild(waypoint->getNode());
     }
 
@@ -1020,102 +1400,6 @@ bool GeoEntityManager::removeWaypointFromGroup(const QString& groupId, int index
     return removeWaypointEntity(it->waypoints.at(index));
 }
 
-/**
- * @brief 生成线性航线节点
- * 
- * 根据航点列表生成直线连接的航线几何体。
- * 
- * @param wps 航点实体向量
- * @return 航线几何节点（Geode），失败返回nullptr
- */
-osg::ref_ptr<osg::Geode> GeoEntityManager::buildLinearRoute(const QVector<WaypointEntity*>& wps)
-{
-    if (wps.size() < 2) return nullptr;
-    osg::ref_ptr<osg::Geode> geode = new osg::Geode();
-    osg::ref_ptr<osg::Geometry> geom = new osg::Geometry();
-    osg::ref_ptr<osg::Vec3Array> verts = new osg::Vec3Array();
-
-    for (auto* wp : wps) {
-        double lon, lat, alt; wp->getPosition(lon, lat, alt);
-        osg::Vec3d world = GeoUtils::geoToWorldCoordinates(lon, lat, alt);
-        verts->push_back(world);
-    }
-    geom->setVertexArray(verts.get());
-    geom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, verts->size()));
-
-    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array();
-    colors->push_back(osg::Vec4(0.2f, 0.8f, 1.0f, 1.0f));
-    geom->setColorArray(colors.get(), osg::Array::BIND_OVERALL);
-
-    geode->addDrawable(geom.get());
-    // 提高可见性：加粗线宽、关闭光照、可选关闭深度测试
-    osg::ref_ptr<osg::LineWidth> lw = new osg::LineWidth(4.0f);
-    osg::StateSet* ss = geode->getOrCreateStateSet();
-    ss->setAttributeAndModes(lw.get(), osg::StateAttribute::ON);
-    ss->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
-    ss->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
-    ss->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
-    // 提前到最前层渲染，避免被其它对象覆盖
-    ss->setRenderBinDetails(9999, "RenderBin");
-    return geode.get();
-}
-
-/**
- * @brief 生成贝塞尔航线节点
- * 
- * 根据航点列表生成平滑的贝塞尔曲线航线几何体。
- * 使用二次贝塞尔插值算法，在相邻航点间插入中间点实现平滑。
- * 
- * @param wps 航点实体向量
- * @return 航线几何节点（Geode），失败返回nullptr
- */
-osg::ref_ptr<osg::Geode> GeoEntityManager::buildBezierRoute(const QVector<WaypointEntity*>& wps)
-{
-    // 简化：将每对相邻点间插入若干中间点进行平滑
-    if (wps.size() < 2) return buildLinearRoute(wps);
-    osg::ref_ptr<osg::Geode> geode = new osg::Geode();
-    osg::ref_ptr<osg::Geometry> geom = new osg::Geometry();
-    osg::ref_ptr<osg::Vec3Array> verts = new osg::Vec3Array();
-
-    for (int i=0;i<wps.size()-1;++i){
-        double lon1,lat1,alt1; wps[i]->getPosition(lon1,lat1,alt1);
-        double lon2,lat2,alt2; wps[i+1]->getPosition(lon2,lat2,alt2);
-        // 控制点：使用中点作为近似控制
-        double cx = (lon1+lon2)/2.0;
-        double cy = (lat1+lat2)/2.0;
-        double cz = (alt1+alt2)/2.0;
-        QVector<osg::Vec3d> controlPoints;
-        controlPoints.append(GeoUtils::geoToWorldCoordinates(lon1, lat1, alt1));
-        controlPoints.append(GeoUtils::geoToWorldCoordinates(cx, cy, cz));
-        controlPoints.append(GeoUtils::geoToWorldCoordinates(lon2, lat2, alt2));
-
-        QVector<osg::Vec3d> curve = generateBezierCurve(controlPoints, 16);
-        if (!curve.isEmpty()) {
-            if (!verts->empty()) {
-                curve.removeFirst();
-            }
-            for (const auto& pt : curve) {
-                verts->push_back(pt);
-            }
-        }
-    }
-
-    geom->setVertexArray(verts.get());
-    geom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, verts->size()));
-    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array();
-    colors->push_back(osg::Vec4(1.0f, 0.6f, 0.2f, 1.0f));
-    geom->setColorArray(colors.get(), osg::Array::BIND_OVERALL);
-    geode->addDrawable(geom.get());
-    osg::ref_ptr<osg::LineWidth> lw = new osg::LineWidth(4.0f);
-    osg::StateSet* ss = geode->getOrCreateStateSet();
-    ss->setAttributeAndModes(lw.get(), osg::StateAttribute::ON);
-    ss->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
-    ss->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
-    ss->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
-    ss->setRenderBinDetails(9999, "RenderBin");
-    return geode.get();
-}
-
 bool GeoEntityManager::generateRouteForGroup(const QString& groupId, const QString& model)
 {
     qDebug() << "[Route] 请求生成路线 groupId=" << groupId << ", model=" << model;
@@ -1123,19 +1407,68 @@ bool GeoEntityManager::generateRouteForGroup(const QString& groupId, const QStri
     if (it == waypointGroups_.end()) return false;
     qDebug() << "[Route] 航点数量=" << it->waypoints.size();
     it->routeModel = model;
-    if (it->routeNode.valid()) {
-        entityGroup_->removeChild(it->routeNode.get());
-        it->routeNode = nullptr;
-    }
-    osg::ref_ptr<osg::Geode> route = (model == "bezier") ? buildBezierRoute(it->waypoints)
-                                                           : buildLinearRoute(it->waypoints);
-    if (!route) return false;
-    it->routeNode = route;
-    entityGroup_->addChild(route.get());
-    qDebug() << "[Route] 路线已生成并添加到场景";
+    if (it->waypoints.size() < 2) {
+        releaseRoute(it.value());
+        return false;
+    }
+
+    // 航线节点常驻场景，重新生成只重写顶点数组
+    if (!it->route.valid()) {
+        it->route = new RouteGeometry(model);
+        if (routeToleranceMeters_ > 0.0) {
+            it->route->setErrorTolerance(routeToleranceMeters_);
+        }
+        entityGroup_->addChild(it->route->getNode());
+    }
+    it->route->rebuild(model, it->waypoints);
+    emit sceneChanged();
+    qDebug() << "[Route] 路线已生成，顶点数=" << it->route->stats().vertexCount;
     return true;
 }
 
+void GeoEntityManager::refreshRoutePoint(WaypointEntity* waypoint)
+{
+    const QString groupId = waypoint->getWaypointGroupId();
+    if (groupId.isEmpty()) {
+        return;
+    }
+    auto it = waypointGroups_.find(groupId);
+    if (it == waypointGroups_.end() || !it->route.valid()) {
+        return;
+    }
+
+    // waypointOrder与组内顺序保持同步，失配时退回线性查找
+    int index = waypoint->getWaypointOrder() - 1;
+    if (index < 0 || index >= it->waypoints.size() || it->waypoints.at(index) != waypoint) {
+        index = it->waypoints.indexOf(waypoint);
+    }
+    if (index >= 0) {
+        it->route->updatePoint(index, waypoint);
+    }
+}
+
+void GeoEntityManager::removeRoutePoint(WaypointGroupInfo& info, int index)
+{
+    if (!info.route.valid()) {
+        return;
+    }
+    if (info.waypoints.size() < 2) {
+        releaseRoute(info);
+        return;
+    }
+    info.route->removePoint(index);
+    emit sceneChanged();
+}
+
+void GeoEntityManager::releaseRoute(WaypointGroupInfo& info)
+{
+    if (info.route.valid()) {
+        entityGroup_->removeChild(info.route->getNode());
+        info.route = nullptr;
+        emit sceneChanged();
+    }
+}
+
 bool GeoEntityManager::bindRouteToEntity(const QString& groupId, const QString& targetEntityUid)
 {
     if (!entities_.contains(targetEntityUid)) return false;
@@ -1180,15 +1513,19 @@ WaypointEntity* GeoEntityManager::addStandaloneWaypoint(double lon, double lat,
                                             lon, lat, alt, uidOverride, this);
     // 优先绑定 MapNode，确保 PlaceNode 立即可见
     wp->setMapNode(mapNode_.get());
+    wp->setBatched(waypointBatchingEnabled_);
     wp->initialize();
     if (!labelText.isEmpty()) {
         wp->setOrderLabel(labelText);
     }
-    if (wp->getNode()) {
+    if (wp->isBatched()) {
+        attachToWaypointBatch(wp);
+    } else if (wp->getNode()) {
         entityGroup_->addChild(wp->getNode());
     }
     entities_.insert(wp->getUid(), wp);
-    uidToEntity_.insert(wp->getUid(), wp);
+    slots_.insert(wp);
+    indexEntity(wp);
     emit entityCreated(wp);
     return wp;
 }
@@ -1220,7 +1557,8 @@ LineEntity* GeoEntityManager::addLineEntity(const QString& name,
 
     entityGroup_->addChild(line->getNode());
     entities_.insert(line->getUid(), line);
-    uidToEntity_.insert(line->getUid(), line);
+    slots_.insert(line);
+    indexEntity(line);
 
     auto createEndpoint = [this, finalName](double lon, double lat, double alt, const QString& labelText) -> WaypointEntity* {
         WaypointEntity* wp = new WaypointEntity(QStringLiteral("%1-%2").arg(finalName, labelText),
@@ -1228,13 +1566,17 @@ LineEntity* GeoEntityManager::addLineEntity(const QString& name,
                                                 QString(),
                                                 this);
         wp->setMapNode(mapNode_.get());
+        wp->setBatched(waypointBatchingEnabled_);
         wp->initialize();
         wp->setOrderLabel(labelText);
-        if (wp->getNode()) {
+        if (wp->isBatched()) {
+            attachToWaypointBatch(wp);
+        } else if (wp->getNode()) {
             entityGroup_->addChild(wp->getNode());
         }
         entities_.insert(wp->getUid(), wp);
-        uidToEntity_.insert(wp->getUid(), wp);
+        slots_.insert(wp);
+        indexEntity(wp);
         return wp;
     };
 
@@ -1322,7 +1664,7 @@ LineEntity* GeoEntityManager::addLineEntity(const QString& name,
 
 //    entityGroup_->addChild(line->getNode());
 //    entities_.insert(line->getUid(), line);
-//    uidToEntity_.insert(line->getUid(), line);
+//    slots_.insert(line);
 
 //    auto createEndpoint = [this, finalName](double lon, double lat, double alt, const QString& labelText) -> WaypointEntity* {
 //        WaypointEntity* wp = new WaypointEntity(QStringLiteral("%1-%2").arg(finalName, labelText),
@@ -1336,7 +1678,7 @@ LineEntity* GeoEntityManager::addLineEntity(const QString& name,
 //            entityGroup_->addChild(wp->getNode());
 //        }
 //        entities_.insert(wp->getUid(), wp);
-//        uidToEntity_.insert(wp->getUid(), wp);
+//        slots_.insert(wp);
 //        return wp;
 //    };
 
@@ -1424,27 +1766,23 @@ bool GeoEntityManager::removeWaypointEntity(WaypointEntity* waypoint)
         return false;
     }
 
-    if (selectedEntity_ == waypoint) {
+    if (getSelectedEntity() == waypoint) {
         setSelectedEntity(nullptr);
     }
-    if (hoveredEntity_ == waypoint) {
-        hoveredEntity_ = nullptr;
-    }
-
-    if (it->routeNode.valid()) {
-        entityGroup_->removeChild(it->routeNode.get());
-        it->routeNode = nullptr;
-    }
+    clearHovered(waypoint);
 
     if (waypoint->getNode()) {
         waypoint->getNode()->setNodeMask(0x0);
         entityGroup_->removeChild(waypoint->getNode());
     }
+    waypointBatchLayer_.removeWaypoint(waypoint);
     const QString wpUid = waypoint->getUid();
     entities_.remove(wpUid);
-    uidToEntity_.remove(wpUid);
+    unindexEntity(waypoint);
 
     it->waypoints.removeAt(index);
+    // 航线只删除该航点对应的航段
+    removeRoutePoint(it.value(), index);
 
     for (int i = 0; i < it->waypoints.size(); ++i) {
         it->waypoints[i]->setOrderLabel(QString::number(i + 1));
@@ -1454,20 +1792,7 @@ bool GeoEntityManager::removeWaypointEntity(WaypointEntity* waypoint)
     waypoint->setProperty("waypointGroupId", QString());
     waypoint->setProperty("waypointOrder", QVariant());
 
-    pendingEntities_[wpUid] = waypoint;
-    if (!pendingDeletions_.contains(wpUid)) {
-        pendingDeletions_.enqueue(wpUid);
-    }
-
-    if (it->waypoints.size() >= 2) {
-        const QString model = it->routeModel.isEmpty() ? QStringLiteral("linear") : it->routeModel;
-        generateRouteForGroup(groupId, model);
-    } else {
-        if (it->routeNode.valid()) {
-            entityGroup_->removeChild(it->routeNode.get());
-            it->routeNode = nullptr;
-        }
-    }
+    slots_.retire(waypoint->handle());
 
     emit entityRemoved(wpUid);
     return true;
@@ -1487,25 +1812,18 @@ void GeoEntityManager::setMapStateManager(MapStateManager* mapStateManager)
 /**
  * @brief 处理延迟删除队列
  * 
- * 在渲染完成后调用，安全地删除已标记为待删除的实体。
- * 使用延迟删除机制避免在渲染过程中删除OSG节点导致崩溃。
+ * 结束当前纪元并删除此前退役的全部实体。
+ * 删除时实体句柄已失效、节点已从场景移除；只要不在渲染过程中调用，就不会删除正在绘制的OSG节点。
  * 
- * @note 应该在每一帧渲染完成后（frame()）调用此方法
+ * @note 每一帧渲染完成后（frame()）调用；PlanFileManager清空方案后也会立即调用，
+ *       此时退役与删除之间没有经过一帧渲染
  */
 void GeoEntityManager::processPendingDeletions()
 {
-    // qDebug() << "处理延迟删除队列，共有" << pendingDeletions_.size() << "个实体待删除";
-    
-    while (!pendingDeletions_.isEmpty()) {
-        QString uid = pendingDeletions_.dequeue();
-        
-        // 从待删除映射中获取实体
-        GeoEntity* entity = pendingEntities_.take(uid);
-        if (!entity) {
-            qDebug() << "警告：待删除实体不存在:" << uid;
-            continue;
-        }
-        
+    // 回收此前退役的实体（节点已从场景移除，句柄已失效，当前不在渲染过程中）
+    const QVector<GeoEntity*> reclaimed = slots_.reclaim();
+    for (GeoEntity* entity : reclaimed) {
+        const QString uid = entity->getUid();
         qDebug() << "开始真正删除实体:" << uid;
         
         // 现在可以安全地清理和删除实体了
@@ -1514,10 +1832,22 @@ void GeoEntityManager::processPendingDeletions()
         
         // 删除实体对象
         delete entity;
-        entity = nullptr;
         
         qDebug() << "实体完全删除完成:" << uid;
     }
-    
-    // qDebug() << "所有延迟删除完成";
+
+    // 释放已无实体引用的共享图标资源（实体节点已在cleanup()中归还节点池）
+    if (!reclaimed.isEmpty()) {
+        IconCache::instance().releaseUnused();
+        HighlightCache::instance().releaseUnused();
+        const int trimmed = EntityNodePool::instance().trim();
+        IconCache::Stats iconStats = IconCache::instance().stats();
+        qDebug() << "图标缓存: 命中" << iconStats.hits << "未命中" << iconStats.misses
+                 << "图标数" << iconStats.iconCount << "纹理字节" << iconStats.residentTextureBytes;
+        EntityNodePool::Stats poolStats = EntityNodePool::instance().stats();
+        qDebug() << "节点池: 空闲" << poolStats.pooled << poolStats.pooledByType
+                 << "获取" << poolStats.acquired << "复用" << poolStats.reused
+                 << "复用率" << poolStats.reuseRate << "丢弃" << poolStats.discarded
+                 << "本次释放空闲" << trimmed;
+    }
 }
@@ -19,10 +19,18 @@
 #include <QHash>
 #include <QMouseEvent>
 #include <QTimer>
-#include <QQueue>
 #include <osgViewer/Viewer>
 #include "geoentity.h"
 #include "LineEntity.h"
+#include "entityspatialindex.h"
+#include "screenpickbuffer.h"
+#include "iconbatchlayer.h"
+#include "waypointbatchlayer.h"
+#include "labeldeclutter.h"
+#include "entityclusterlayer.h"
+#include "entityslotmap.h"
+#include "entitynodepool.h"
+#include "routegeometry.h"
 #include <QVector>
 
 // 前置声明，避免头文件循环依赖
@@ -66,7 +74,7 @@ public:
      * @brief 创建实体
      * @param entityType 实体类型（如"aircraft"）
      * @param entityName 实体名称
-     * @param properties 实体属性
+     * @param properties 实体属性（可包含预解析的"imagePath"，避免查询数据库）
      * @param longitude 经度
      * @param latitude 纬度
      * @param altitude 高度
@@ -76,6 +84,33 @@ public:
                            const QJsonObject& properties, double longitude, double latitude, double altitude,
                            const QString& uidOverride = QString());
     
+    /**
+     * @brief 批量创建实体的描述
+     */
+    struct EntityDescriptor {
+        QString type;                ///< 实体类型（"aircraft"/"image"/"waypoint"）
+        QString name;                ///< 实体名称（图片实体同时是模型名称）
+        QString imagePath;           ///< 预解析的图片路径，为空时按名称从模型目录查询
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double altitude = 0.0;
+        QString uid;                 ///< 指定UID，为空时自动生成
+    };
+
+    /**
+     * @brief 批量创建实体（方案加载等大批量场景）
+     *
+     * 与逐个调用createEntity相比：
+     * - 缺少图片路径的模型一次性从模型目录查询，每个图标文件只检查一次
+     * - 创建过程处于批量修改期间，构造与初始化中的变化通知合并
+     * - 各实体的场景节点最后一次性挂到实体组
+     * - 不逐个发出entityCreated，结束时发出一次entitiesCreated
+     *
+     * @param descriptors 实体描述
+     * @return 与descriptors一一对应的实体指针，创建失败的位置为nullptr
+     */
+    QVector<GeoEntity*> createEntities(const QVector<EntityDescriptor>& descriptors);
+    
     /**
      * @brief 从拖拽数据添加实体
      * @param dragData 拖拽数据字符串
@@ -94,6 +129,15 @@ public:
     GeoEntity* getEntity(const QString& uid);
     /** @brief 通过稳定UID获取实体（别名，保持兼容） */
     GeoEntity* getEntityByUid(const QString& uid) const;
+    /**
+     * @brief 按句柄获取实体（O(1)，不做字符串查找）
+     * @return 句柄为空或实体已删除返回nullptr
+     */
+    GeoEntity* getEntity(EntityHandle handle) const;
+    /** @brief 获取实体句柄，实体不存在返回空句柄 */
+    EntityHandle getEntityHandle(const QString& uid) const;
+    /** @brief 句柄是否仍指向存活的实体 */
+    bool isValid(EntityHandle handle) const { return slots_.contains(handle); }
     /** @brief 获取所有实体列表 */
     QList<GeoEntity*> getAllEntities() const;
     /** @brief 获取当前选中的实体 */
@@ -118,6 +162,44 @@ public:
      */
     QStringList getEntityIdsByType(const QString& entityType) const;  // 保持方法名兼容，实际返回UID列表
     
+    /**
+     * @brief 开始批量修改（可嵌套）
+     *
+     * 批量期间实体的位置、航向与属性照常写入并刷新节点，但变化通知被合并：
+     * 最外层commitBatch()时每个实体每项变化只通知一次（空间索引、拾取缓存、聚合、航线等
+     * 内部结构各更新一次），随后发出一次entitiesChanged与一次sceneChanged。
+     * 通常使用EntityBatch在作用域内自动开始/提交。
+     */
+    void beginBatch();
+    /** @brief 提交批量修改（与beginBatch配对，最外层提交时发出合并后的通知） */
+    void commitBatch();
+    /** @brief 当前是否处于批量修改期间 */
+    bool isBatching() const { return batchDepth_ > 0; }
+
+    /**
+     * @brief 批量修改作用域
+     *
+     * 构造时调用beginBatch()，析构时调用commitBatch()：
+     * @code
+     * GeoEntityManager::EntityBatch batch(manager);
+     * for (GeoEntity* entity : entities) {
+     *     entity->setPosition(lon, lat, alt);
+     * }
+     * @endcode
+     */
+    class EntityBatch
+    {
+    public:
+        explicit EntityBatch(GeoEntityManager* manager) : manager_(manager) { if (manager_) manager_->beginBatch(); }
+        ~EntityBatch() { if (manager_) manager_->commitBatch(); }
+
+    private:
+        EntityBatch(const EntityBatch&) = delete;
+        EntityBatch& operator=(const EntityBatch&) = delete;
+
+        GeoEntityManager* manager_;
+    };
+
     /**
      * @brief 删除实体
      * @param uid 实体UID
@@ -172,10 +254,13 @@ public:
     bool isMapNavigationBlocked() const;
 
     /**
-     * @brief 处理延迟删除队列（应该在frame()完成后调用）
-     * 公共方法，供外部在渲染完成后调用
+     * @brief 处理延迟删除队列（应在渲染之外调用）
+     * 公共方法：每帧frame()完成后调用；清空方案后也会直接调用，不等待下一帧
      */
     void processPendingDeletions();
+
+    /** @brief 是否有等待回收的已删除实体 */
+    bool hasPendingDeletions() const { return slots_.hasRetired(); }
     
     /**
      * @brief 查找指定位置的实体
@@ -184,9 +269,98 @@ public:
      */
     GeoEntity* findEntityAtPosition(QPoint screenPos, bool verbose = true);
 
+    /**
+     * @brief 更新实体屏幕投影缓存并运行标签避让（应该在frame()完成后调用）
+     *
+     * 相机与实体均未变化时不做任何计算。标签显示状态变化时发出sceneChanged，下一帧生效。
+     */
+    void updateScreenProjection();
+
+    /** @brief 启用/关闭标签避让（关闭时显示所有标签），默认启用 */
+    void setLabelDeclutterEnabled(bool enabled) { labelDeclutter_.setEnabled(enabled); }
+    bool isLabelDeclutterEnabled() const { return labelDeclutter_.isEnabled(); }
+    /** @brief 设置显示普通标签的最大相机距离（米），超出时只显示选中/悬停实体的标签 */
+    void setLabelMaxRange(double rangeMeters) { labelDeclutter_.setMaxLabelRange(rangeMeters); }
+    /** @brief 标签避让统计 */
+    LabelDeclutter::Stats labelDeclutterStats() const { return labelDeclutter_.stats(); }
+
+    /**
+     * @brief 启用/关闭远距离实体聚合，默认启用
+     *
+     * 相机距离超过最小聚合距离时，相邻的图片实体合并为一个聚合标记（主要图标 + 实体数），
+     * 拉近时逐级展开。关闭后所有实体单独绘制。
+     */
+    void setClusteringEnabled(bool enabled) { clusterLayer_.setEnabled(enabled); emit sceneChanged(); }
+    bool isClusteringEnabled() const { return clusterLayer_.isEnabled(); }
+    /** @brief 设置开始聚合的最小相机距离（米），默认100公里 */
+    void setClusterMinRange(double rangeMeters) { clusterLayer_.setMinClusterRange(rangeMeters); emit sceneChanged(); }
+    /** @brief 实体聚合统计 */
+    EntityClusterLayer::Stats clusterStats() const { return clusterLayer_.stats(); }
+
+    /**
+     * @brief 在屏幕空间查找实体（基于上一帧的投影缓存，不做地形求交）
+     * @param screenPos 屏幕坐标
+     * @param radiusPixels 拾取半径（像素）
+     * @return 找到的实体指针，未找到返回nullptr
+     */
+    GeoEntity* findEntityAtScreen(QPoint screenPos, double radiusPixels = 16.0) const;
+
+    /**
+     * @brief 上次投影的可见性筛选统计（可能可见/总实体数，地平线与视锥剔除数）
+     *
+     * 拾取与标签避让只处理可能可见的实体。
+     */
+    ScreenPickBuffer::CullStats visibilityStats() const { return screenPickBuffer_.cullStats(); }
+
+    /**
+     * @brief 实体核心数据存储（位置、航向、状态标志与常用属性按列连续存放）
+     *
+     * 批量遍历（导出、统计等）可直接扫描其中的列，不必逐个访问实体对象。
+     */
+    const EntityStore& entityStore() const { return EntityStore::instance(); }
+
+    /**
+     * @brief 实体场景节点池统计（池中空闲节点数、按类型的占用、累计复用次数与复用率）
+     *
+     * 回收实体时其场景节点归还到节点池，清空后重新加载方案时大部分节点直接复用。
+     */
+    EntityNodePool::Stats nodePoolStats() const { return EntityNodePool::instance().stats(); }
+
+    /**
+     * @brief 设置是否使用实例化图标图层绘制图片实体
+     *
+     * 启用后新创建的图片实体不再各自拥有场景节点，同一图标的实体合并为一次实例化绘制；
+     * 已存在的实体保持原有绘制方式。适合数千个平台的大方案，默认关闭。
+     */
+    void setIconBatchingEnabled(bool enabled);
+    /** @brief 是否使用实例化图标图层 */
+    bool isIconBatchingEnabled() const { return iconBatchingEnabled_; }
+    /** @brief 实例化图标图层统计 */
+    IconBatchLayer::Stats iconBatchStats() const { return iconBatchLayer_.stats(); }
+
+    /**
+     * @brief 设置是否使用航点批量图层绘制航点
+     *
+     * 启用后新创建的航点不再各自创建CircleNode + PlaceNode，所有航点的圆点与序号标签
+     * 分别合并为一次实例化绘制；已存在的航点保持原有绘制方式。默认关闭。
+     */
+    void setWaypointBatchingEnabled(bool enabled);
+    /** @brief 是否使用航点批量图层 */
+    bool isWaypointBatchingEnabled() const { return waypointBatchingEnabled_; }
+    /** @brief 航点批量图层统计 */
+    WaypointBatchLayer::Stats waypointBatchStats() const { return waypointBatchLayer_.stats(); }
+
     /** @brief 处理鼠标移动事件（用于实体悬停高亮） */
     void onMouseMove(QMouseEvent* event);
 
+    /**
+     * @brief 按鼠标位置更新悬停高亮
+     *
+     * 由OsgMapWidget每帧以最新的光标位置调用一次。
+     * @param screenPos 鼠标屏幕坐标（相对于GLWidget）
+     */
+    void updateHover(QPoint screenPos);
+
     // ===== 航点/航线 API =====
     /**
      * @brief 航点组信息结构
@@ -195,8 +369,8 @@ public:
         QString groupId;
         QString name;
         QVector<class WaypointEntity*> waypoints;
-        osg::ref_ptr<osg::Geode> routeNode; // 航线绘制节点
-        QString routeModel;                 // 航线生成模型（linear|bezier）
+        osg::ref_ptr<RouteGeometry> route;  // 航线几何（常驻场景，航点变化时局部改写）
+        QString routeModel;                 // 航线生成模型（linear|rhumb|bezier）
     };
 
     /** @brief 创建航点组 */
@@ -209,8 +383,12 @@ public:
     bool removeWaypointFromGroup(const QString& groupId, int index);
     /** @brief 删除指定航点实体（自动更新所属航线） */
     bool removeWaypointEntity(class WaypointEntity* waypoint);
-    /** @brief 依据模型生成组内航线（linear|bezier） */
-    bool generateRouteForGroup(const QString& groupId, const QString& model /* 'linear' | 'bezier' */);
+    /**
+     * @brief 依据模型生成组内航线
+     *
+     * linear沿大圆、rhumb沿恒向线、bezier为平滑曲线；航段按相机距离自适应细分。
+     */
+    bool generateRouteForGroup(const QString& groupId, const QString& model /* 'linear' | 'rhumb' | 'bezier' */);
     /** @brief 将生成的航线绑定到实体（随实体移动/显示） */
     bool bindRouteToEntity(const QString& groupId, const QString& targetEntityUid);
     
@@ -250,6 +428,12 @@ signals:
      */
     void entityCreated(GeoEntity* entity);
     
+    /**
+     * @brief 批量创建实体信号（createEntities结束时发出一次，代替逐个的entityCreated）
+     * @param entities 创建成功的实体
+     */
+    void entitiesCreated(const QList<GeoEntity*>& entities);
+    
     /**
      * @brief 实体删除信号
      * @param uid 删除的实体UID
@@ -290,6 +474,22 @@ signals:
      */
     void mapRightClicked(QPoint screenPos);
 
+    /**
+     * @brief 场景内容变化信号
+     *
+     * 实体位置/航向/可见性/选中/属性/悬停变化，或航线重新生成时发出，
+     * 用于按需渲染模式下请求重绘。
+     */
+    void sceneChanged();
+
+    /**
+     * @brief 批量修改提交信号
+     *
+     * 最外层commitBatch()时发出一次，携带批量期间位置、航向或属性发生变化且仍然存在的实体UID。
+     * @param uids 变化的实体UID（按首次变化的顺序，不重复）
+     */
+    void entitiesChanged(const QStringList& uids);
+
 private:
     struct PickCandidate {
         GeoEntity* entity = nullptr;
@@ -307,39 +507,81 @@ private:
     MapStateManager* mapStateManager_;
     
     QMap<QString, GeoEntity*> entities_;  // uid -> entity
-    QHash<QString, GeoEntity*> uidToEntity_;  // 保留作为别名索引（实际与entities_相同）
+    // 实体句柄槽位表：句柄解析与删除后的延迟回收（实体在processPendingDeletions()中才真正删除）
+    EntitySlotMap slots_;
     int entityCounter_;
+
+    // 实体位置空间索引（拾取时只遍历光标附近的网格单元）
+    EntitySpatialIndex spatialIndex_;
+    // 实体屏幕投影缓存（悬停高亮使用像素空间查找）
+    ScreenPickBuffer screenPickBuffer_;
+    // 标签避让与距离LOD（基于屏幕投影缓存）
+    LabelDeclutter labelDeclutter_;
+    // 远距离实体聚合（图片实体）
+    EntityClusterLayer clusterLayer_;
+    // 实例化图标图层（批量绘制模式下的图片实体）
+    IconBatchLayer iconBatchLayer_;
+    bool iconBatchingEnabled_ = false;
+    // 航点批量图层（批量绘制模式下的航点）
+    WaypointBatchLayer waypointBatchLayer_;
+    bool waypointBatchingEnabled_ = false;
     
-    // 当前选中的实体
-    GeoEntity* selectedEntity_;
-    GeoEntity* hoveredEntity_;       // 当前悬停的实体
-    
-    // 延迟删除机制：避免在渲染过程中删除节点
-    QQueue<QString> pendingDeletions_;  // 待删除的实体UID队列
-    QMap<QString, GeoEntity*> pendingEntities_;  // 待删除的实体对象（保持引用直到真正删除）
+    // 当前选中/悬停的实体（句柄在实体删除后自动失效）
+    EntityHandle selectedHandle_;
+    EntityHandle hoveredHandle_;
+
+    /** @brief 当前悬停的实体 */
+    GeoEntity* hoveredEntity() const { return slots_.get(hoveredHandle_); }
+    /** @brief 取消悬停高亮（entity为空时取消任意实体，否则仅当其为悬停实体时取消） */
+    void clearHovered(GeoEntity* entity);
     
     /** @brief 生成唯一实体ID（已废弃，统一使用uid） */
     QString generateEntityId(const QString& entityType, const QString& entityName);
     /** @brief 根据实体名从数据库获取图片路径 */
     QString getImagePathFromDatabase(const QString& entityName);
+    /** @brief 按实体名批量获取图片路径（一次查询模型目录） */
+    QHash<QString, QString> getImagePathsFromDatabase(const QStringList& entityNames);
     /** @brief 根据实体名从配置获取图片路径（已废弃，转发到数据库查询） */
     QString getImagePathFromConfig(const QString& entityName);
     bool collectPickCandidates(QPoint screenPos, QVector<PickCandidate>& outCandidates, double& thresholdMeters, bool verbose = false);
     double computeSelectionThreshold() const;
+    /** @brief 是否为图片实体类型（"aircraft"或"image"） */
+    static bool isImageEntityType(const QString& entityType);
+    /** @brief 构造并初始化实体（不加入场景与管理表），失败返回nullptr */
+    GeoEntity* instantiateEntity(const QString& entityType, const QString& entityName, const QString& imagePath,
+                                 double longitude, double latitude, double altitude, const QString& uidOverride);
+    /**
+     * @brief 将已初始化的实体加入场景（或批量图层）、管理表与各索引
+     * @param sceneNodes 非空时需要挂到实体组的节点追加到此处，由调用方统一挂接；为空时立即挂接
+     * @return 失败返回false（此时实体未加入任何图层、管理表或索引，调用方负责删除实体）
+     */
+    bool registerEntity(GeoEntity* entity, QVector<osg::ref_ptr<osg::Node>>* sceneNodes);
+    /** @brief 将实体登记到空间索引与屏幕投影缓存，并跟随positionChanged增量更新 */
+    void indexEntity(GeoEntity* entity);
+    /** @brief 从空间索引与屏幕投影缓存移除实体 */
+    void unindexEntity(GeoEntity* entity);
+    /** @brief 将实体加入实例化图标图层，并跟随状态变化改写其槽位 */
+    bool attachToIconBatch(class ImageEntity* entity);
+    /** @brief 将航点加入航点批量图层，并跟随状态变化改写其槽位 */
+    void attachToWaypointBatch(class WaypointEntity* waypoint);
 
     bool blockMapNavigation_ = false; ///< 是否阻止地图导航
+    int batchDepth_ = 0;              ///< 批量修改嵌套深度
 
     // 航点/航线数据
     QMap<QString, WaypointGroupInfo> waypointGroups_;
     QMap<QString, QString> routeBinding_; // groupId -> targetEntityUid
+    double routeToleranceMeters_ = 0.0;   // 航线细分允许误差（由相机距离得到，0表示尚未计算）
 
     // 直线
     QMap<QString, LineEndpointInfo> lineEndpoints_;
 
-    /** @brief 生成线性航线节点 */
-    osg::ref_ptr<osg::Geode> buildLinearRoute(const QVector<class WaypointEntity*>& wps);
-    /** @brief 生成贝塞尔航线节点 */
-    osg::ref_ptr<osg::Geode> buildBezierRoute(const QVector<class WaypointEntity*>& wps);
+    /** @brief 航点移动后改写所属航线的相邻航段 */
+    void refreshRoutePoint(class WaypointEntity* waypoint);
+    /** @brief 从航线中删除一个航点，不足两个航点时移除航线节点 */
+    void removeRoutePoint(WaypointGroupInfo& info, int index);
+    /** @brief 从场景移除航线节点 */
+    void releaseRoute(WaypointGroupInfo& info);
 
     /** @brief 查找航点所属分组和序号 */
     bool findWaypointLocation(class WaypointEntity* waypoint, QString& groupIdOut, int& indexOut) const;
@@ -0,0 +1,117 @@
+/**
+ * @file glyphatlas.cpp
+ * @brief 标签字形图集实现文件
+ *
+ * 实现GlyphAtlas类的所有功能
+ */
+
+#include "glyphatlas.h"
+#include <QDebug>
+#include <QFont>
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QPainterPath>
+#include <cstring>
+
+namespace {
+
+const int kAtlasSize = 1024;           // 图集边长（32×32个单元格）
+const int kFontPixelSize = 22;         // 与航点标签TextSymbol::size一致
+
+}
+
+QFont GlyphAtlas::labelFont()
+{
+    QFont font(QStringLiteral("SimSun"));
+    font.setPixelSize(kFontPixelSize);
+    return font;
+}
+
+GlyphAtlas& GlyphAtlas::instance()
+{
+    static GlyphAtlas atlas;
+    return atlas;
+}
+
+GlyphAtlas::GlyphAtlas()
+{
+    canvas_ = QImage(kAtlasSize, kAtlasSize, QImage::Format_RGBA8888);
+    canvas_.fill(Qt::transparent);
+
+    image_ = new osg::Image;
+    image_->allocateImage(kAtlasSize, kAtlasSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    image_->setInternalTextureFormat(GL_RGBA);
+    std::memset(image_->data(), 0, image_->getTotalSizeInBytes());
+
+    texture_ = new osg::Texture2D(image_.get());
+    texture_->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+    texture_->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    texture_->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+    texture_->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+    texture_->setResizeNonPowerOfTwoHint(false);
+    texture_->setUnRefImageDataAfterApply(false);
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph(uint codePoint)
+{
+    auto it = glyphs_.constFind(codePoint);
+    if (it != glyphs_.constEnd()) {
+        return it.value();
+    }
+
+    Glyph result;
+    const int columns = kAtlasSize / kCellSize;
+    if (nextCell_ >= columns * columns) {
+        qDebug() << "GlyphAtlas: 字形图集已满，忽略字符:" << codePoint;
+        glyphs_.insert(codePoint, result);
+        return result;
+    }
+
+    const QString text = QString::fromUcs4(&codePoint, 1);
+    const QFont font = labelFont();
+    const QFontMetricsF metrics(font);
+
+    const int x = (nextCell_ % columns) * kCellSize;
+    const int y = (nextCell_ / columns) * kCellSize;
+    ++nextCell_;
+
+    // 描边 + 填充，与PlaceNode的halo/fill效果一致；基线使字形在单元格中垂直居中
+    const qreal baseline = y + (kCellSize + metrics.ascent() - metrics.descent()) / 2.0;
+    QPainterPath path;
+    path.addText(QPointF(x + kCellPadding, baseline), font, text);
+
+    QPainter painter(&canvas_);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setClipRect(QRect(x, y, kCellSize, kCellSize));
+    painter.strokePath(path, QPen(QColor(0, 0, 0, 153), 3.0));
+    painter.fillPath(path, QColor(255, 0, 0));
+    painter.end();
+
+    uploadCell(x, y);
+
+    result.valid = true;
+    result.advance = static_cast<float>(metrics.horizontalAdvance(text));
+    result.uvRect = osg::Vec4(static_cast<float>(x) / kAtlasSize,
+                              static_cast<float>(kAtlasSize - (y + kCellSize)) / kAtlasSize,
+                              static_cast<float>(x + kCellSize) / kAtlasSize,
+                              static_cast<float>(kAtlasSize - y) / kAtlasSize);
+    glyphs_.insert(codePoint, result);
+    return result;
+}
+
+void GlyphAtlas::uploadCell(int x, int y)
+{
+    // 只复制新单元格的像素；OSG图像第0行在底部
+    for (int row = y; row < y + kCellSize; ++row) {
+        std::memcpy(image_->data(x, kAtlasSize - 1 - row),
+                    canvas_.constScanLine(row) + x * 4,
+                    static_cast<size_t>(kCellSize) * 4);
+    }
+    image_->dirty();
+}
+
+void GlyphAtlas::clear()
+{
+    // 批量图层在构造时持有纹理指针，因此只释放GL对象，不替换纹理
+    texture_->releaseGLObjects();
+}
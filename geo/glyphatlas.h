@@ -0,0 +1,84 @@
+/**
+ * @file glyphatlas.h
+ * @brief 标签字形图集头文件
+ *
+ * 定义GlyphAtlas类，将标签文字的字形按需绘制到一张共享纹理中。
+ */
+
+#ifndef GLYPHATLAS_H
+#define GLYPHATLAS_H
+
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <osg/Image>
+#include <osg/Texture2D>
+#include <osg/Vec4>
+
+/**
+ * @ingroup managers
+ * @brief 标签字形图集
+ *
+ * 使用与航点PlaceNode标签相同的样式（宋体22像素、红色文字、半透明黑色描边）
+ * 用QPainter把字形绘制到固定大小的单元格中，所有批量绘制的标签共享同一张纹理。
+ * 字形在首次使用时加入，加入新字形时更新CPU图像并标记纹理重新上传。
+ *
+ * - 每个字形占用一个kCellSize×kCellSize像素的单元格，字形左侧留有kCellPadding像素边距
+ * - uvRect为OSG纹理坐标（t轴向上）
+ * - 纹理持有GL对象，应在图形上下文销毁前调用clear()
+ * - 仅在主线程使用
+ */
+class GlyphAtlas
+{
+public:
+    /** @brief 单个字形 */
+    struct Glyph {
+        bool valid = false;        ///< 图集已满或无法绘制时为false
+        osg::Vec4 uvRect;          ///< (u0, t0, u1, t1)
+        float advance = 0.0f;      ///< 排版前进宽度（像素）
+    };
+
+    static const int kCellSize = 32;      ///< 单元格边长（像素）
+    static const int kCellPadding = 4;    ///< 单元格内字形左侧边距（像素）
+
+    /** @brief 获取全局实例 */
+    static GlyphAtlas& instance();
+
+    /** @brief 标签字体（与航点PlaceNode标签一致，也用于估算标签宽度） */
+    static QFont labelFont();
+
+    /**
+     * @brief 获取字形（不存在时绘制并加入图集）
+     * @param codePoint Unicode码点
+     * @return 字形信息
+     */
+    Glyph glyph(uint codePoint);
+
+    /** @brief 图集纹理 */
+    osg::Texture2D* texture() const { return texture_.get(); }
+
+    /** @brief 已缓存的字形数 */
+    int glyphCount() const { return glyphs_.size(); }
+
+    /**
+     * @brief 释放纹理的GL对象（应在图形上下文销毁前调用）
+     *
+     * 字形与CPU端图像保留，纹理对象不变，再次绘制时从图像重新上传。
+     */
+    void clear();
+
+private:
+    GlyphAtlas();
+    GlyphAtlas(const GlyphAtlas&) = delete;
+    GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+    void uploadCell(int x, int y);
+
+    QImage canvas_;                        // CPU端图集（Qt坐标，第0行在顶部）
+    osg::ref_ptr<osg::Image> image_;       // GPU上传用图像（第0行在底部）
+    osg::ref_ptr<osg::Texture2D> texture_;
+    QHash<uint, Glyph> glyphs_;            // 码点 -> 字形
+    int nextCell_ = 0;
+};
+
+#endif // GLYPHATLAS_H
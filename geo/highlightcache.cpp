@@ -0,0 +1,131 @@
+/**
+ * @file highlightcache.cpp
+ * @brief 高亮边框共享缓存实现文件
+ *
+ * 实现HighlightCache类的所有功能
+ */
+
+#include "highlightcache.h"
+#include <osg/Geometry>
+#include <osg/LineWidth>
+#include <osg/ValueObject>
+#include <cmath>
+
+namespace {
+
+// 每倍频程的档位数
+const double kClassesPerOctave = 4.0;
+
+/**
+ * @brief 共享高亮边框的裁剪回调
+ *
+ * 同一尺寸的高亮边框节点被所有实体共享，是否绘制由父节点（实体的PAT）上的
+ * 高亮标志决定：标志为false时直接跳过，不产生绘制调用。
+ */
+class HighlightCullCallback : public osg::NodeCallback
+{
+public:
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+    {
+        const osg::NodePath& path = nv->getNodePath();
+        if (path.size() < 2) {
+            return;
+        }
+        const osg::BoolValueObject* flag = dynamic_cast<const osg::BoolValueObject*>(path[path.size() - 2]->getUserData());
+        if (flag && flag->getValue()) {
+            traverse(node, nv);
+        }
+    }
+};
+
+qint64 classIndex(double size)
+{
+    return static_cast<qint64>(std::ceil(std::log2(size) * kClassesPerOctave - 1e-9));
+}
+
+}
+
+HighlightCache& HighlightCache::instance()
+{
+    static HighlightCache cache;
+    return cache;
+}
+
+double HighlightCache::sizeClass(double size)
+{
+    if (size <= 0.0) {
+        return 0.0;
+    }
+    return std::pow(2.0, static_cast<double>(classIndex(size)) / kClassesPerOctave);
+}
+
+osg::ref_ptr<osg::Geode> HighlightCache::node(double size)
+{
+    if (size <= 0.0) {
+        return nullptr;
+    }
+
+    const qint64 index = classIndex(size);
+    auto it = nodes_.constFind(index);
+    if (it != nodes_.constEnd()) {
+        return it.value();
+    }
+
+    if (!stateSet_.valid()) {
+        stateSet_ = new osg::StateSet;
+        stateSet_->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+        stateSet_->setMode(GL_BLEND, osg::StateAttribute::ON);
+        stateSet_->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+        stateSet_->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+        stateSet_->setAttributeAndModes(new osg::LineWidth(3.0f), osg::StateAttribute::ON);
+        cullCallback_ = new HighlightCullCallback;
+    }
+
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+
+    const float borderSize = static_cast<float>(sizeClass(size) * 1.1);
+    const float borderHalf = borderSize * 0.5f;
+    vertices->push_back(osg::Vec3(-borderHalf, 0.0f, -borderHalf));
+    vertices->push_back(osg::Vec3(borderHalf, 0.0f, -borderHalf));
+    vertices->push_back(osg::Vec3(borderHalf, 0.0f, borderHalf));
+    vertices->push_back(osg::Vec3(-borderHalf, 0.0f, borderHalf));
+    vertices->push_back(osg::Vec3(-borderHalf, 0.0f, -borderHalf));
+    geometry->setVertexArray(vertices.get());
+    geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, vertices->size()));
+
+    osg::ref_ptr<osg::Vec4Array> colors = new osg::Vec4Array;
+    colors->push_back(osg::Vec4(1.0f, 0.1f, 0.1f, 1.0f));
+    geometry->setColorArray(colors.get(), osg::Array::BIND_OVERALL);
+
+    geometry->setUseDisplayList(false);
+    geometry->setUseVertexBufferObjects(true);
+
+    geode->setStateSet(stateSet_.get());
+    geode->setCullingActive(false);
+    geode->setCullCallback(cullCallback_.get());
+    geode->addDrawable(geometry.get());
+
+    nodes_.insert(index, geode);
+    return geode;
+}
+
+void HighlightCache::releaseUnused()
+{
+    // 仅被缓存自身引用（引用计数为1）的节点可以释放
+    for (auto it = nodes_.begin(); it != nodes_.end();) {
+        if (it.value()->referenceCount() <= 1) {
+            it = nodes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void HighlightCache::clear()
+{
+    nodes_.clear();
+    stateSet_ = nullptr;
+    cullCallback_ = nullptr;
+}
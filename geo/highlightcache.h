@@ -0,0 +1,63 @@
+/**
+ * @file highlightcache.h
+ * @brief 高亮边框共享缓存头文件
+ *
+ * 定义HighlightCache类，按尺寸档位共享实体的高亮边框节点。
+ */
+
+#ifndef HIGHLIGHTCACHE_H
+#define HIGHLIGHTCACHE_H
+
+#include <QHash>
+#include <osg/Geode>
+#include <osg/NodeCallback>
+#include <osg/StateSet>
+
+/**
+ * @ingroup managers
+ * @brief 高亮边框共享缓存
+ *
+ * 高亮尺寸按1/4倍频程分档（向上取整，边框不会小于实体），同一档位的所有实体共享同一个Geode
+ * （几何体、渲染状态、线宽）。节点挂有裁剪回调，按父节点（实体PAT）用户数据中的高亮标志
+ * 决定是否绘制：标志为false时直接跳过，不产生绘制调用。
+ *
+ * - 实体回收后调用releaseUnused()释放不再被任何实体引用的档位
+ * - 节点持有GL对象，应在图形上下文销毁前调用clear()
+ * - 全局唯一实例；仅在主线程使用
+ */
+class HighlightCache
+{
+public:
+    /** @brief 获取全局实例 */
+    static HighlightCache& instance();
+
+    /** @brief 尺寸档位（米） */
+    static double sizeClass(double size);
+
+    /**
+     * @brief 获取指定尺寸的共享高亮边框节点
+     * @param size 高亮尺寸（米）
+     * @return 共享节点，尺寸无效时返回空指针
+     */
+    osg::ref_ptr<osg::Geode> node(double size);
+
+    /** @brief 已缓存的档位数 */
+    int size() const { return nodes_.size(); }
+
+    /** @brief 释放不再被任何实体引用的档位 */
+    void releaseUnused();
+
+    /** @brief 释放所有缓存（应在图形上下文销毁前调用） */
+    void clear();
+
+private:
+    HighlightCache() = default;
+    HighlightCache(const HighlightCache&) = delete;
+    HighlightCache& operator=(const HighlightCache&) = delete;
+
+    QHash<qint64, osg::ref_ptr<osg::Geode>> nodes_;   // 档位（1/4倍频程序号） -> 共享节点
+    osg::ref_ptr<osg::StateSet> stateSet_;
+    osg::ref_ptr<osg::NodeCallback> cullCallback_;
+};
+
+#endif // HIGHLIGHTCACHE_H
@@ -0,0 +1,325 @@
+/**
+ * @file iconatlas.cpp
+ * @brief 模型图标纹理图集实现文件
+ *
+ * 实现IconAtlas类的所有功能
+ */
+
+#include "iconatlas.h"
+#include "../util/catalogcache.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QSaveFile>
+#include <QtMath>
+#include <osg/Image>
+#include <cstring>
+
+namespace {
+
+const int kCellSize = 128;          // 单元格边长（像素，2的幂以保证mipmap对齐）
+const int kCellPadding = 4;         // 单元格内的透明间隔
+const float kMaxMipLevel = 2.0f;    // 采样的最高mip级别：间隔每级减半，第2级仍剩1个纹素
+const int kMaxAtlasSize = 4096;     // 图集最大边长
+const int kManifestVersion = 1;
+const char kAtlasImageName[] = "iconatlas.png";
+const char kManifestName[] = "iconatlas.json";
+
+int nextPowerOfTwo(int value)
+{
+    int result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}
+
+IconAtlas& IconAtlas::instance()
+{
+    static IconAtlas atlas;
+    return atlas;
+}
+
+QString IconAtlas::cacheDirectory()
+{
+    return QCoreApplication::applicationDirPath() + "/cache";
+}
+
+QString IconAtlas::signature(const QString& imagePath)
+{
+    if (imagePath.startsWith(":/")) {
+        // 资源编译在程序中，没有修改时间，使用内容摘要
+        QFile resourceFile(imagePath);
+        if (!resourceFile.open(QIODevice::ReadOnly)) {
+            return QString();
+        }
+        return "qrc:" + QString::fromLatin1(QCryptographicHash::hash(resourceFile.readAll(),
+                                                                     QCryptographicHash::Md5).toHex());
+    }
+
+    QFileInfo fileInfo(imagePath);
+    if (!fileInfo.exists() || !fileInfo.isFile()) {
+        return QString();
+    }
+    return QString("%1:%2").arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+void IconAtlas::ensureIcons(const QStringList& extraPaths)
+{
+    const bool firstUse = !initialized_;
+    if (firstUse) {
+        initialized_ = true;
+        paths_ = CatalogCache::instance().modelIcons();
+    }
+
+    bool added = false;
+    for (const QString& path : extraPaths) {
+        if (!path.isEmpty() && !paths_.contains(path)) {
+            paths_.append(path);
+            added = true;
+        }
+    }
+    if (!firstUse && !added) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 只打包实际存在的图标，缺失的图标由调用方回退到独立纹理
+    QStringList available;
+    QHash<QString, QString> signatures;
+    for (const QString& path : paths_) {
+        QString iconSignature = signature(path);
+        if (!iconSignature.isEmpty()) {
+            available.append(path);
+            signatures.insert(path, iconSignature);
+        }
+    }
+    if (available.isEmpty()) {
+        return;
+    }
+
+    if (loadFromDisk(available, signatures)) {
+        qDebug() << "IconAtlas: 从缓存加载图集，图标数:" << regions_.size()
+                 << "耗时:" << timer.elapsed() << "ms";
+        return;
+    }
+
+    pack(available, signatures);
+    qDebug() << "IconAtlas: 重新打包图集，图标数:" << regions_.size()
+             << "耗时:" << timer.elapsed() << "ms";
+}
+
+bool IconAtlas::uvRect(const QString& imagePath, osg::Vec4& rect) const
+{
+    auto it = regions_.constFind(imagePath);
+    if (it == regions_.constEnd()) {
+        return false;
+    }
+    rect = it.value();
+    return true;
+}
+
+void IconAtlas::clear()
+{
+    // 场景中的图标节点可能仍引用图集渲染状态，先显式释放其GL对象
+    if (stateSet_.valid()) {
+        stateSet_->releaseGLObjects();
+    }
+    stateSet_ = nullptr;
+    texture_ = nullptr;
+    regions_.clear();
+    signatures_.clear();
+    paths_.clear();
+    initialized_ = false;
+    ++generation_;
+}
+
+bool IconAtlas::loadFromDisk(const QStringList& paths, const QHash<QString, QString>& signatures)
+{
+    const QString directory = cacheDirectory();
+    QFile manifestFile(directory + "/" + kManifestName);
+    if (!manifestFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QJsonObject manifest = QJsonDocument::fromJson(manifestFile.readAll()).object();
+    manifestFile.close();
+
+    if (manifest["version"].toInt() != kManifestVersion || manifest["cellSize"].toInt() != kCellSize) {
+        return false;
+    }
+
+    // 每个需要的图标都必须在缓存中且签名一致
+    const QJsonObject icons = manifest["icons"].toObject();
+    QHash<QString, osg::Vec4> regions;
+    for (const QString& path : paths) {
+        const QJsonObject entry = icons.value(path).toObject();
+        if (entry["signature"].toString() != signatures.value(path)) {
+            return false;
+        }
+        // 无法解码的图标记录为空矩形，签名不变时不再重新打包
+        const QJsonArray rect = entry["rect"].toArray();
+        if (rect.size() != 4) {
+            continue;
+        }
+        regions.insert(path, osg::Vec4(rect[0].toDouble(), rect[1].toDouble(),
+                                       rect[2].toDouble(), rect[3].toDouble()));
+    }
+
+    QImage atlasImage(directory + "/" + kAtlasImageName);
+    if (atlasImage.isNull()
+        || atlasImage.width() != manifest["width"].toInt()
+        || atlasImage.height() != manifest["height"].toInt()) {
+        return false;
+    }
+
+    regions_ = regions;
+    signatures_.clear();
+    for (const QString& path : paths) {
+        signatures_.insert(path, signatures.value(path));
+    }
+    createTexture(atlasImage);
+    return true;
+}
+
+void IconAtlas::pack(const QStringList& paths, const QHash<QString, QString>& signatures)
+{
+    const int maxCells = (kMaxAtlasSize / kCellSize) * (kMaxAtlasSize / kCellSize);
+    const int count = qMin(paths.size(), maxCells);
+    if (paths.size() > maxCells) {
+        qDebug() << "IconAtlas: 图标数超过图集容量，超出部分使用独立纹理:" << paths.size() - maxCells;
+    }
+
+    const int width = qMin(nextPowerOfTwo(qCeil(qSqrt(count)) * kCellSize), kMaxAtlasSize);
+    const int columns = width / kCellSize;
+    const int rows = (count + columns - 1) / columns;
+    const int height = qMin(nextPowerOfTwo(rows * kCellSize), kMaxAtlasSize);
+
+    QImage atlasImage(width, height, QImage::Format_ARGB32_Premultiplied);
+    atlasImage.fill(Qt::transparent);
+
+    QHash<QString, osg::Vec4> regions;
+    QHash<QString, QString> packedSignatures;
+    QPainter painter(&atlasImage);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+
+    int cell = 0;
+    for (int i = 0; i < count; ++i) {
+        const QString& path = paths.at(i);
+        packedSignatures.insert(path, signatures.value(path));
+        QImage icon(path);
+        if (icon.isNull()) {
+            qDebug() << "IconAtlas: 无法加载图标:" << path;
+            continue;
+        }
+
+        // 与独立纹理的四边形一致：图标拉伸填满单元格内部
+        const int x = (cell % columns) * kCellSize;
+        const int y = (cell / columns) * kCellSize;
+        const QRect target(x + kCellPadding, y + kCellPadding,
+                           kCellSize - 2 * kCellPadding, kCellSize - 2 * kCellPadding);
+        painter.drawImage(target, icon);
+        ++cell;
+
+        // 纹理上传时图像上下翻转，t轴从底部开始
+        const float u0 = static_cast<float>(target.left()) / width;
+        const float u1 = static_cast<float>(target.left() + target.width()) / width;
+        const float t0 = static_cast<float>(height - (target.top() + target.height())) / height;
+        const float t1 = static_cast<float>(height - target.top()) / height;
+        regions.insert(path, osg::Vec4(u0, t0, u1, t1));
+    }
+    painter.end();
+
+    regions_ = regions;
+    signatures_ = packedSignatures;
+    createTexture(atlasImage);
+    saveToDisk(atlasImage);
+}
+
+void IconAtlas::saveToDisk(const QImage& atlasImage) const
+{
+    const QString directory = cacheDirectory();
+    if (!QDir().mkpath(directory)) {
+        qDebug() << "IconAtlas: 无法创建缓存目录:" << directory;
+        return;
+    }
+
+    QSaveFile imageFile(directory + "/" + kAtlasImageName);
+    if (!imageFile.open(QIODevice::WriteOnly) || !atlasImage.save(&imageFile, "PNG") || !imageFile.commit()) {
+        qDebug() << "IconAtlas: 无法写入图集缓存:" << imageFile.fileName();
+        return;
+    }
+
+    QJsonObject icons;
+    for (auto it = signatures_.constBegin(); it != signatures_.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["signature"] = it.value();
+        osg::Vec4 rect;
+        if (uvRect(it.key(), rect)) {
+            entry["rect"] = QJsonArray{rect[0], rect[1], rect[2], rect[3]};
+        } else {
+            entry["rect"] = QJsonArray();
+        }
+        icons[it.key()] = entry;
+    }
+
+    QJsonObject manifest;
+    manifest["version"] = kManifestVersion;
+    manifest["cellSize"] = kCellSize;
+    manifest["width"] = atlasImage.width();
+    manifest["height"] = atlasImage.height();
+    manifest["icons"] = icons;
+
+    QSaveFile manifestFile(directory + "/" + kManifestName);
+    if (!manifestFile.open(QIODevice::WriteOnly)
+        || manifestFile.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact)) < 0
+        || !manifestFile.commit()) {
+        qDebug() << "IconAtlas: 无法写入图集清单:" << manifestFile.fileName();
+    }
+}
+
+void IconAtlas::createTexture(const QImage& atlasImage)
+{
+    // OSG图像的第0行在底部
+    const QImage rgba = atlasImage.convertToFormat(QImage::Format_RGBA8888).mirrored();
+
+    osg::ref_ptr<osg::Image> image = new osg::Image;
+    image->allocateImage(rgba.width(), rgba.height(), 1, GL_RGBA, GL_UNSIGNED_BYTE);
+    image->setInternalTextureFormat(GL_RGBA);
+    for (int row = 0; row < rgba.height(); ++row) {
+        std::memcpy(image->data(0, row), rgba.constScanLine(row), static_cast<size_t>(rgba.width()) * 4);
+    }
+
+    // mipmap由GPU生成；单元格为2的幂且对齐，但透明间隔每级减半，第3级起双线性采样
+    // 会取到相邻单元格的纹素，因此限制采样的最高级别，间隔始终保留至少1个纹素
+    texture_ = new osg::Texture2D(image.get());
+    texture_->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+    texture_->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    texture_->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR_MIPMAP_LINEAR);
+    texture_->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+    texture_->setMaxLOD(kMaxMipLevel);
+    texture_->setUseHardwareMipMapGeneration(true);
+    texture_->setResizeNonPowerOfTwoHint(false);
+
+    stateSet_ = new osg::StateSet;
+    stateSet_->setTextureAttributeAndModes(0, texture_.get(), osg::StateAttribute::ON);
+    stateSet_->setMode(GL_DEPTH_TEST, osg::StateAttribute::ON);
+    stateSet_->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    stateSet_->setMode(GL_BLEND, osg::StateAttribute::ON);
+    stateSet_->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+    ++generation_;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file iconatlas.h
+ * @brief 模型图标纹理图集头文件
+ *
+ * 定义IconAtlas类，将模型目录和当前方案引用的图标合并到一张带mipmap的纹理中。
+ */
+
+#ifndef ICONATLAS_H
+#define ICONATLAS_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QImage>
+#include <osg/Texture2D>
+#include <osg/StateSet>
+#include <osg/Vec4>
+
+/**
+ * @ingroup managers
+ * @brief 模型图标纹理图集
+ *
+ * 首次使用时收集ModelInformation.icon引用的所有图标（文件路径或":/images"资源），
+ * 按固定大小的单元格打包到一张2的幂尺寸的纹理中，单元格之间留有透明间隔，
+ * mipmap由GPU生成，采样限制在间隔仍不少于1个纹素的级别（kCellPadding为4像素时最高第2级），
+ * 避免缩小时混入相邻图标；更远的距离上图标略有闪烁，但不会串色。
+ *
+ * 图集图像和清单缓存在程序目录的cache/下，清单记录每个图标的签名（文件大小+修改时间，
+ * 资源为内容MD5）；启动时签名全部一致则直接加载缓存，只有图标变化或新增时才重新打包。
+ *
+ * - uvRect()返回OSG纹理坐标（t轴向上），可直接用于四边形的纹理坐标或实例化绘制
+ * - 图集重建后generation()递增，持有旧UV的调用方需重新获取
+ * - 纹理持有GL对象，应在图形上下文销毁前调用clear()；之后再次使用时重新从磁盘缓存加载
+ * - 仅在主线程使用
+ */
+class IconAtlas
+{
+public:
+    /** @brief 获取全局实例 */
+    static IconAtlas& instance();
+
+    /**
+     * @brief 确保图集覆盖模型目录中的所有图标及给定的额外图标
+     *
+     * 第一次调用时从磁盘缓存加载或重新打包；之后只有出现未覆盖的图标时才重新打包。
+     * @param extraPaths 额外的图标路径（如当前方案使用的图标）
+     */
+    void ensureIcons(const QStringList& extraPaths = QStringList());
+
+    /** @brief 图标是否在图集中 */
+    bool contains(const QString& imagePath) const { return regions_.contains(imagePath); }
+
+    /**
+     * @brief 获取图标在图集中的UV矩形
+     * @param imagePath 图标路径
+     * @param rect 输出(u0, t0, u1, t1)，(u0, t0)对应图标左下角
+     * @return 图标在图集中返回true
+     */
+    bool uvRect(const QString& imagePath, osg::Vec4& rect) const;
+
+    /** @brief 图集纹理（未构建时为空） */
+    osg::ref_ptr<osg::Texture2D> texture() const { return texture_; }
+
+    /** @brief 图集渲染状态（纹理、混合、透明渲染顺序），调用方不应修改 */
+    osg::ref_ptr<osg::StateSet> stateSet() const { return stateSet_; }
+
+    /** @brief 图集版本号，每次重建纹理后递增 */
+    int generation() const { return generation_; }
+
+    /** @brief 图集中的图标数 */
+    int iconCount() const { return regions_.size(); }
+
+    /** @brief 释放图集纹理及其GL对象（应在图形上下文销毁前调用），generation()递增 */
+    void clear();
+
+private:
+    IconAtlas() = default;
+    IconAtlas(const IconAtlas&) = delete;
+    IconAtlas& operator=(const IconAtlas&) = delete;
+
+    bool loadFromDisk(const QStringList& paths, const QHash<QString, QString>& signatures);
+    void pack(const QStringList& paths, const QHash<QString, QString>& signatures);
+    void saveToDisk(const QImage& atlasImage) const;
+    void createTexture(const QImage& atlasImage);
+
+    static QString signature(const QString& imagePath);
+    static QString cacheDirectory();
+
+    QStringList paths_;                          // 已请求的图标（不论是否成功打包）
+    QHash<QString, osg::Vec4> regions_;          // 图标路径 -> UV矩形
+    QHash<QString, QString> signatures_;         // 图标路径 -> 打包时的签名
+    osg::ref_ptr<osg::Texture2D> texture_;
+    osg::ref_ptr<osg::StateSet> stateSet_;
+    int generation_ = 0;
+    bool initialized_ = false;
+};
+
+#endif // ICONATLAS_H
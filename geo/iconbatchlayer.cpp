@@ -0,0 +1,336 @@
+/**
+ * @file iconbatchlayer.cpp
+ * @brief 实例化图标图层实现文件
+ *
+ * 实现IconBatchLayer类的所有功能
+ */
+
+#include "iconbatchlayer.h"
+#include "iconcache.h"
+#include "iconatlas.h"
+#include "geoentity.h"
+#include "geoutils.h"
+#include <osg/VertexAttribDivisor>
+#include <osg/Uniform>
+#include <QDebug>
+
+namespace {
+
+const unsigned int kTexRectAttrib = 5;
+const unsigned int kPlacementAttrib = 6;
+const unsigned int kStateAttrib = 7;
+const float kHighlightScale = 1.1f;   // 与GeoEntity高亮边框尺寸一致
+
+const char kVertexShader[] =
+    "#version 120\n"
+    "attribute vec4 iconPlacement;\n"
+    "attribute vec4 iconState;\n"
+    "attribute vec4 iconTexRect;\n"
+    "varying vec2 iconTexCoord;\n"
+    "varying vec4 iconRect;\n"
+    "varying float iconHighlight;\n"
+    "void main()\n"
+    "{\n"
+    "    float c = cos(iconState.x);\n"
+    "    float s = sin(iconState.x);\n"
+    "    float scale = iconPlacement.w * iconState.z * (1.0 + 0.1 * iconState.y);\n"
+    "    vec3 corner = gl_Vertex.xyz * scale;\n"
+    "    vec3 rotated = vec3(c * corner.x - s * corner.y, s * corner.x + c * corner.y, corner.z);\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(iconPlacement.xyz + rotated, 1.0);\n"
+    "    iconTexCoord = gl_MultiTexCoord0.xy;\n"
+    "    iconRect = iconTexRect;\n"
+    "    iconHighlight = iconState.y;\n"
+    "}\n";
+
+// 高亮时四边形放大到1.1倍，图标外的一圈绘制红色边框；图标内部按UV矩形映射到（图集）纹理
+const char kFragmentShader[] =
+    "#version 120\n"
+    "uniform sampler2D iconTexture;\n"
+    "varying vec2 iconTexCoord;\n"
+    "varying vec4 iconRect;\n"
+    "varying float iconHighlight;\n"
+    "void main()\n"
+    "{\n"
+    "    vec2 uv = (iconTexCoord - 0.5) * (1.0 + 0.1 * iconHighlight) + 0.5;\n"
+    "    if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) {\n"
+    "        vec2 edge = abs(uv - 0.5);\n"
+    "        if (max(edge.x, edge.y) < 0.535) discard;\n"
+    "        gl_FragColor = vec4(1.0, 0.1, 0.1, 1.0);\n"
+    "        return;\n"
+    "    }\n"
+    "    gl_FragColor = texture2D(iconTexture, mix(iconRect.xy, iconRect.zw, uv));\n"
+    "}\n";
+
+/**
+ * @brief 按实例数据计算批次包围盒
+ *
+ * 几何体的顶点只是单位四边形，默认包围盒会导致整批被错误裁剪。
+ */
+struct InstanceBoundsCallback : public osg::Drawable::ComputeBoundingBoxCallback
+{
+    osg::BoundingBox computeBound(const osg::Drawable& drawable) const override
+    {
+        osg::BoundingBox bounds;
+        const osg::Geometry* geometry = drawable.asGeometry();
+        const osg::Vec4Array* placements = geometry
+            ? dynamic_cast<const osg::Vec4Array*>(geometry->getVertexAttribArray(kPlacementAttrib))
+            : nullptr;
+        if (!placements) {
+            return bounds;
+        }
+        for (const osg::Vec4& placement : *placements) {
+            osg::Vec3 center(placement.x(), placement.y(), placement.z());
+            float half = placement.w() * kHighlightScale * 0.5f;
+            osg::Vec3 extent(half, half, half);
+            bounds.expandBy(center - extent);
+            bounds.expandBy(center + extent);
+        }
+        return bounds;
+    }
+};
+
+}
+
+IconBatchLayer::IconBatchLayer()
+{
+    root_ = new osg::MatrixTransform;
+    root_->setName("IconBatchLayer");
+}
+
+osg::Program* IconBatchLayer::program()
+{
+    if (!program_.valid()) {
+        program_ = new osg::Program;
+        program_->setName("IconBatchProgram");
+        program_->addShader(new osg::Shader(osg::Shader::VERTEX, kVertexShader));
+        program_->addShader(new osg::Shader(osg::Shader::FRAGMENT, kFragmentShader));
+        program_->addBindAttribLocation("iconPlacement", kPlacementAttrib);
+        program_->addBindAttribLocation("iconState", kStateAttrib);
+        program_->addBindAttribLocation("iconTexRect", kTexRectAttrib);
+    }
+    return program_.get();
+}
+
+IconBatchLayer::Batch* IconBatchLayer::createBatch(const QString& batchKey, osg::Texture2D* texture)
+{
+    Batch batch;
+    batch.geometry = new osg::Geometry;
+    batch.geometry->setUseDisplayList(false);
+    batch.geometry->setUseVertexBufferObjects(true);
+
+    // 单位四边形（与IconCache::buildQuad相同的XZ平面布局），实际尺寸由实例数据缩放
+    osg::ref_ptr<osg::Vec3Array> corners = new osg::Vec3Array;
+    corners->push_back(osg::Vec3(-0.5f, 0.0f, -0.5f));
+    corners->push_back(osg::Vec3(0.5f, 0.0f, -0.5f));
+    corners->push_back(osg::Vec3(0.5f, 0.0f, 0.5f));
+    corners->push_back(osg::Vec3(-0.5f, 0.0f, 0.5f));
+    batch.geometry->setVertexArray(corners.get());
+
+    osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array;
+    texCoords->push_back(osg::Vec2(0.0f, 0.0f));
+    texCoords->push_back(osg::Vec2(1.0f, 0.0f));
+    texCoords->push_back(osg::Vec2(1.0f, 1.0f));
+    texCoords->push_back(osg::Vec2(0.0f, 1.0f));
+    batch.geometry->setTexCoordArray(0, texCoords.get());
+
+    // 实例数据：由VertexAttribDivisor设为每实例步进一次
+    batch.placements = new osg::Vec4Array;
+    batch.states = new osg::Vec4Array;
+    batch.texRects = new osg::Vec4Array;
+    batch.geometry->setVertexAttribArray(kPlacementAttrib, batch.placements.get(), osg::Array::BIND_PER_VERTEX);
+    batch.geometry->setVertexAttribArray(kStateAttrib, batch.states.get(), osg::Array::BIND_PER_VERTEX);
+    batch.geometry->setVertexAttribArray(kTexRectAttrib, batch.texRects.get(), osg::Array::BIND_PER_VERTEX);
+
+    batch.drawArrays = new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4, 0);
+    batch.geometry->addPrimitiveSet(batch.drawArrays.get());
+    batch.geometry->setComputeBoundingBoxCallback(new InstanceBoundsCallback);
+
+    osg::ref_ptr<osg::StateSet> stateSet = new osg::StateSet;
+    stateSet->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+    stateSet->setAttributeAndModes(program(), osg::StateAttribute::ON);
+    stateSet->addUniform(new osg::Uniform("iconTexture", 0));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kPlacementAttrib, 1));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kStateAttrib, 1));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kTexRectAttrib, 1));
+    stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::ON);
+    stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    stateSet->setMode(GL_BLEND, osg::StateAttribute::ON);
+    stateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+    stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+    batch.geode = new osg::Geode;
+    batch.geode->setName(batchKey.toStdString());
+    batch.geode->setStateSet(stateSet.get());
+    batch.geode->addDrawable(batch.geometry.get());
+    root_->addChild(batch.geode.get());
+
+    qDebug() << "IconBatchLayer: 新建批次" << batchKey << "批次数:" << batches_.size() + 1;
+    return &batches_.insert(batchKey, batch).value();
+}
+
+bool IconBatchLayer::addEntity(GeoEntity* entity, const QString& imagePath, QString* errorMessage)
+{
+    if (!entity) {
+        return false;
+    }
+    if (slots_.contains(entity)) {
+        updateEntity(entity);
+        return true;
+    }
+
+    // 图集中的图标共用一个批次（按图集版本区分），其余图标按路径各自成批
+    IconAtlas& atlas = IconAtlas::instance();
+    atlas.ensureIcons();
+    osg::Vec4 texRect(0.0f, 0.0f, 1.0f, 1.0f);
+    const bool inAtlas = atlas.uvRect(imagePath, texRect);
+    const QString batchKey = inAtlas ? QStringLiteral("atlas#%1").arg(atlas.generation()) : imagePath;
+
+    Batch* batch = nullptr;
+    auto it = batches_.find(batchKey);
+    if (it != batches_.end()) {
+        batch = &it.value();
+    } else {
+        osg::ref_ptr<osg::Texture2D> texture = inAtlas
+            ? atlas.texture()
+            : IconCache::instance().texture(imagePath, errorMessage);
+        if (!texture.valid()) {
+            return false;
+        }
+        batch = createBatch(batchKey, texture.get());
+    }
+
+    // 第一个实例的位置作为图层原点，实例位置以相对偏移的单精度存储
+    if (!hasOrigin_) {
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double altitude = 0.0;
+        entity->getPosition(longitude, latitude, altitude);
+        origin_ = GeoUtils::geoToWorldCoordinates(longitude, latitude, altitude);
+        root_->setMatrix(osg::Matrix::translate(origin_));
+        hasOrigin_ = true;
+    }
+
+    int index = batch->entities.size();
+    batch->entities.append(entity);
+    batch->placements->push_back(osg::Vec4());
+    batch->states->push_back(osg::Vec4());
+    batch->texRects->push_back(texRect);
+    batch->texRects->dirty();
+    batch->drawArrays->setNumInstances(batch->entities.size());
+    batch->drawArrays->dirty();
+
+    Slot slot;
+    slot.batchKey = batchKey;
+    slot.index = index;
+    slots_.insert(entity, slot);
+
+    writeSlot(*batch, index);
+    return true;
+}
+
+void IconBatchLayer::updateEntity(GeoEntity* entity)
+{
+    auto slotIt = slots_.constFind(entity);
+    if (slotIt == slots_.constEnd()) {
+        return;
+    }
+    auto batchIt = batches_.find(slotIt->batchKey);
+    if (batchIt == batches_.end()) {
+        return;
+    }
+    writeSlot(batchIt.value(), slotIt->index);
+}
+
+void IconBatchLayer::writeSlot(Batch& batch, int index)
+{
+    GeoEntity* entity = batch.entities.value(index, nullptr);
+    if (!entity) {
+        return;
+    }
+
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    entity->getPosition(longitude, latitude, altitude);
+    osg::Vec3d offset = GeoUtils::geoToWorldCoordinates(longitude, latitude, altitude) - origin_;
+
+    float size = static_cast<float>(entity->getSize());
+    float heading = static_cast<float>(entity->getHeading() * M_PI / 180.0);
+    bool highlighted = entity->isSelected() || entity->isHovered();
+
+    (*batch.placements)[index] = osg::Vec4(offset.x(), offset.y(), offset.z(), size);
+    (*batch.states)[index] = osg::Vec4(heading,
+                                       highlighted ? 1.0f : 0.0f,
+                                       entity->isRendered() ? 1.0f : 0.0f,
+                                       0.0f);
+    batch.placements->dirty();
+    batch.states->dirty();
+    batch.geometry->dirtyBound();
+    ++slotUpdates_;
+}
+
+void IconBatchLayer::removeEntity(GeoEntity* entity)
+{
+    auto slotIt = slots_.find(entity);
+    if (slotIt == slots_.end()) {
+        return;
+    }
+    const QString batchKey = slotIt->batchKey;
+    const int index = slotIt->index;
+    slots_.erase(slotIt);
+
+    auto batchIt = batches_.find(batchKey);
+    if (batchIt == batches_.end()) {
+        return;
+    }
+    Batch& batch = batchIt.value();
+
+    // 用最后一个槽位填补空位，保持实例数组紧凑
+    const int last = batch.entities.size() - 1;
+    if (index != last) {
+        GeoEntity* moved = batch.entities[last];
+        batch.entities[index] = moved;
+        (*batch.placements)[index] = (*batch.placements)[last];
+        (*batch.states)[index] = (*batch.states)[last];
+        (*batch.texRects)[index] = (*batch.texRects)[last];
+        slots_[moved].index = index;
+    }
+    batch.entities.removeLast();
+    batch.placements->pop_back();
+    batch.states->pop_back();
+    batch.texRects->pop_back();
+
+    if (batch.entities.isEmpty()) {
+        // DrawArrays的实例数为0时会退化为普通绘制，空批次直接移除
+        root_->removeChild(batch.geode.get());
+        batches_.erase(batchIt);
+        if (batches_.isEmpty()) {
+            hasOrigin_ = false;
+        }
+        return;
+    }
+
+    batch.drawArrays->setNumInstances(batch.entities.size());
+    batch.drawArrays->dirty();
+    batch.placements->dirty();
+    batch.states->dirty();
+    batch.texRects->dirty();
+    batch.geometry->dirtyBound();
+}
+
+void IconBatchLayer::clear()
+{
+    root_->removeChildren(0, root_->getNumChildren());
+    batches_.clear();
+    slots_.clear();
+    hasOrigin_ = false;
+}
+
+IconBatchLayer::Stats IconBatchLayer::stats() const
+{
+    Stats result;
+    result.batchCount = batches_.size();
+    result.instanceCount = slots_.size();
+    result.slotUpdates = slotUpdates_;
+    return result;
+}
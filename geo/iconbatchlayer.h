@@ -0,0 +1,109 @@
+/**
+ * @file iconbatchlayer.h
+ * @brief 实例化图标图层头文件
+ *
+ * 定义IconBatchLayer类，将使用同一纹理的图标实体合并为一次实例化绘制。
+ */
+
+#ifndef ICONBATCHLAYER_H
+#define ICONBATCHLAYER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/Program>
+#include <osg/Texture2D>
+#include <osg/Vec3d>
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 实例化图标图层（可选的批量渲染路径）
+ *
+ * 每个纹理对应一个批次：一个单位四边形几何体 + 一次glDrawArraysInstanced调用。IconAtlas中的图标
+ * 共用图集纹理，因此不同机型混合显示时也只有一个批次；不在图集中的图标按路径各自成批。
+ * 每个实体占用批次中的一个槽位，实例数据保存在按实例步进（divisor = 1）的顶点属性数组中：
+ * - iconPlacement：xyz为相对图层原点的位置（避免单精度表示地心坐标的精度损失），w为边长
+ * - iconState：x为航向（弧度），y为高亮（选中或悬停），z为可见
+ * - iconTexRect：图标在纹理中的UV矩形（独立纹理为(0, 0, 1, 1)），仅在加入时写入
+ *
+ * 实体位置、航向、可见性或高亮变化时只改写该实体的槽位；删除实体时用最后一个槽位填补空位。
+ * 实体本身的PositionAttitudeTransform/高亮节点不再加入场景图，场景中只有每个纹理一个Geode。
+ *
+ * - 仅在主线程使用
+ * - 顶点/片元着色器为GLSL 1.20（兼容模式），朝向与GeoEntity::setupNodeTransform一致（绕世界Z轴）
+ */
+class IconBatchLayer
+{
+public:
+    /** @brief 图层统计 */
+    struct Stats {
+        int batchCount = 0;          ///< 批次（绘制调用）数
+        int instanceCount = 0;       ///< 实例（实体）数
+        quint64 slotUpdates = 0;     ///< 累计槽位改写次数
+    };
+
+    IconBatchLayer();
+
+    /** @brief 图层根节点（加入实体组即可） */
+    osg::Node* getNode() const { return root_.get(); }
+
+    /**
+     * @brief 将实体加入对应纹理的批次
+     * @param entity 实体
+     * @param imagePath 图标路径（同一纹理的实体共享一个批次）
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 成功返回true（纹理加载失败时返回false）
+     */
+    bool addEntity(GeoEntity* entity, const QString& imagePath, QString* errorMessage = nullptr);
+
+    /** @brief 按实体当前状态改写其槽位（实体未加入时忽略） */
+    void updateEntity(GeoEntity* entity);
+
+    /** @brief 移除实体，批次为空时一并移除 */
+    void removeEntity(GeoEntity* entity);
+
+    /** @brief 实体是否由本图层绘制 */
+    bool contains(GeoEntity* entity) const { return slots_.contains(entity); }
+
+    /** @brief 移除所有批次 */
+    void clear();
+
+    /** @brief 获取图层统计 */
+    Stats stats() const;
+
+private:
+    struct Batch {
+        osg::ref_ptr<osg::Geode> geode;
+        osg::ref_ptr<osg::Geometry> geometry;
+        osg::ref_ptr<osg::Vec4Array> placements;
+        osg::ref_ptr<osg::Vec4Array> states;
+        osg::ref_ptr<osg::Vec4Array> texRects;
+        osg::ref_ptr<osg::DrawArrays> drawArrays;
+        QVector<GeoEntity*> entities;    // 槽位 -> 实体
+    };
+
+    struct Slot {
+        QString batchKey;
+        int index = -1;
+    };
+
+    Batch* createBatch(const QString& batchKey, osg::Texture2D* texture);
+    void writeSlot(Batch& batch, int index);
+    osg::Program* program();
+
+    osg::ref_ptr<osg::MatrixTransform> root_;     // 平移到图层原点
+    osg::ref_ptr<osg::Program> program_;
+    osg::Vec3d origin_;
+    bool hasOrigin_ = false;
+
+    QHash<QString, Batch> batches_;               // 批次键（图标路径或图集版本）-> 批次
+    QHash<GeoEntity*, Slot> slots_;               // 实体 -> 槽位
+    quint64 slotUpdates_ = 0;
+};
+
+#endif // ICONBATCHLAYER_H
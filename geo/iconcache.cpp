@@ -0,0 +1,262 @@
+/**
+ * @file iconcache.cpp
+ * @brief 图标共享缓存实现文件
+ *
+ * 实现IconCache类的所有功能
+ */
+
+#include "iconcache.h"
+#include "iconatlas.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <osgDB/ReadFile>
+#include <osgDB/Registry>
+#include <osgDB/ReaderWriter>
+#include <osg/StateAttribute>
+#include <sstream>
+
+namespace {
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+}
+
+IconCache& IconCache::instance()
+{
+    static IconCache cache;
+    return cache;
+}
+
+osg::ref_ptr<osg::Image> IconCache::decode(const QString& imagePath, QString* errorMessage)
+{
+    if (!imagePath.startsWith(":/")) {
+        if (!QFileInfo::exists(imagePath)) {
+            setError(errorMessage, QString("文件不存在: %1").arg(imagePath));
+            return nullptr;
+        }
+        osg::ref_ptr<osg::Image> image = osgDB::readImageFile(imagePath.toStdString());
+        if (!image.valid()) {
+            setError(errorMessage, QString("无法加载图片: %1").arg(imagePath));
+        }
+        return image;
+    }
+
+    // Qt资源：直接从内存数据解码
+    QFile resourceFile(imagePath);
+    if (!resourceFile.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, QString("无法打开资源文件: %1").arg(imagePath));
+        return nullptr;
+    }
+    const QByteArray bytes = resourceFile.readAll();
+    resourceFile.close();
+
+    const std::string extension = QFileInfo(imagePath).suffix().toLower().toStdString();
+    osgDB::ReaderWriter* readerWriter = osgDB::Registry::instance()->getReaderWriterForExtension(extension);
+    if (!readerWriter) {
+        setError(errorMessage, QString("没有可用的图片解码插件: %1").arg(imagePath));
+        return nullptr;
+    }
+
+    std::istringstream stream(std::string(bytes.constData(), static_cast<size_t>(bytes.size())));
+    osgDB::ReaderWriter::ReadResult result = readerWriter->readImage(stream);
+    if (!result.success() || !result.getImage()) {
+        setError(errorMessage, QString("无法解码资源图片: %1").arg(imagePath));
+        return nullptr;
+    }
+
+    osg::ref_ptr<osg::Image> image = result.getImage();
+    image->setFileName(imagePath.toStdString());
+    return image;
+}
+
+osg::ref_ptr<osg::Geometry> IconCache::buildQuad(float size, const osg::Vec4& uvRect)
+{
+    osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+
+    // 创建四边形顶点
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+    vertices->push_back(osg::Vec3(-size/2, 0, -size/2));  // 左下
+    vertices->push_back(osg::Vec3(size/2, 0, -size/2));   // 右下
+    vertices->push_back(osg::Vec3(size/2, 0, size/2));    // 右上
+    vertices->push_back(osg::Vec3(-size/2, 0, size/2));   // 左上
+    geometry->setVertexArray(vertices);
+
+    // 设置纹理坐标
+    osg::ref_ptr<osg::Vec2Array> texCoords = new osg::Vec2Array;
+    texCoords->push_back(osg::Vec2(uvRect[0], uvRect[1]));  // 左下
+    texCoords->push_back(osg::Vec2(uvRect[2], uvRect[1]));  // 右下
+    texCoords->push_back(osg::Vec2(uvRect[2], uvRect[3]));  // 右上
+    texCoords->push_back(osg::Vec2(uvRect[0], uvRect[3]));  // 左上
+    geometry->setTexCoordArray(0, texCoords);
+
+    // 设置法线
+    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array;
+    normals->push_back(osg::Vec3(0.0f, 0.0f, 1.0f)); // 朝上
+    geometry->setNormalArray(normals);
+    geometry->setNormalBinding(osg::Geometry::BIND_OVERALL);
+
+    // 设置绘制方式
+    geometry->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4));
+    return geometry;
+}
+
+const IconCache::IconEntry* IconCache::entry(const QString& imagePath, QString* errorMessage)
+{
+    auto it = entries_.constFind(imagePath);
+    if (it != entries_.constEnd()) {
+        ++hits_;
+        return &it.value();
+    }
+
+    ++misses_;
+    osg::ref_ptr<osg::Image> image = decode(imagePath, errorMessage);
+    if (!image.valid()) {
+        return nullptr;
+    }
+
+    IconEntry newEntry;
+    newEntry.image = image;
+
+    // 创建纹理并绑定图片
+    newEntry.texture = new osg::Texture2D;
+    newEntry.texture->setImage(image.get());
+    newEntry.texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+    newEntry.texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+    newEntry.texture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+    newEntry.texture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+
+    // 设置纹理和渲染状态
+    newEntry.stateSet = new osg::StateSet;
+    newEntry.stateSet->setTextureAttributeAndModes(0, newEntry.texture.get(), osg::StateAttribute::ON);
+    newEntry.stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::ON);
+    newEntry.stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    newEntry.stateSet->setMode(GL_BLEND, osg::StateAttribute::ON);
+    newEntry.stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+    auto inserted = entries_.insert(imagePath, newEntry);
+    qDebug() << "IconCache: 加载图标" << imagePath << image->s() << "x" << image->t()
+             << "命中:" << hits_ << "未命中:" << misses_;
+    return &inserted.value();
+}
+
+osg::ref_ptr<osg::Image> IconCache::image(const QString& imagePath, QString* errorMessage)
+{
+    const IconEntry* iconEntry = entry(imagePath, errorMessage);
+    return iconEntry ? iconEntry->image : nullptr;
+}
+
+osg::ref_ptr<osg::Texture2D> IconCache::texture(const QString& imagePath, QString* errorMessage)
+{
+    const IconEntry* iconEntry = entry(imagePath, errorMessage);
+    return iconEntry ? iconEntry->texture : nullptr;
+}
+
+osg::ref_ptr<osg::StateSet> IconCache::stateSet(const QString& imagePath, QString* errorMessage)
+{
+    const IconEntry* iconEntry = entry(imagePath, errorMessage);
+    return iconEntry ? iconEntry->stateSet : nullptr;
+}
+
+osg::ref_ptr<osg::Geode> IconCache::createIconGeode(const QString& imagePath, float size, QString* errorMessage)
+{
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    if (!setupIconGeode(geode.get(), imagePath, size, errorMessage)) {
+        return nullptr;
+    }
+    return geode;
+}
+
+bool IconCache::setupIconGeode(osg::Geode* geode, const QString& imagePath, float size, QString* errorMessage)
+{
+    // 从空节点开始，避免复用的节点叠加上一个实体的图标
+    geode->removeDrawables(0, geode->getNumDrawables());
+
+    // 优先使用图集：不同图标的实体共享同一纹理和渲染状态
+    IconAtlas& atlas = IconAtlas::instance();
+    atlas.ensureIcons();
+    osg::Vec4 uvRect;
+    if (atlas.uvRect(imagePath, uvRect)) {
+        const QString geometryKey = QStringLiteral("atlas%1|%2|%3")
+                                        .arg(atlas.generation())
+                                        .arg(imagePath)
+                                        .arg(static_cast<double>(size));
+        osg::ref_ptr<osg::Geometry> geometry = geometries_.value(geometryKey);
+        if (!geometry.valid()) {
+            geometry = buildQuad(size, uvRect);
+            geometries_.insert(geometryKey, geometry);
+        }
+
+        geode->addDrawable(geometry.get());
+        geode->setStateSet(atlas.stateSet().get());
+        return true;
+    }
+
+    const IconEntry* iconEntry = entry(imagePath, errorMessage);
+    if (!iconEntry) {
+        return false;
+    }
+
+    const QString geometryKey = QStringLiteral("%1|%2").arg(imagePath).arg(static_cast<double>(size));
+    osg::ref_ptr<osg::Geometry> geometry = geometries_.value(geometryKey);
+    if (!geometry.valid()) {
+        geometry = buildQuad(size, osg::Vec4(0.0f, 0.0f, 1.0f, 1.0f));
+        geometries_.insert(geometryKey, geometry);
+    }
+
+    geode->addDrawable(geometry.get());
+    geode->setStateSet(iconEntry->stateSet.get());
+    return true;
+}
+
+IconCache::Stats IconCache::stats() const
+{
+    Stats result;
+    result.hits = hits_;
+    result.misses = misses_;
+    result.iconCount = entries_.size();
+    result.geometryCount = geometries_.size();
+    for (const IconEntry& iconEntry : entries_) {
+        if (iconEntry.image.valid()) {
+            result.residentTextureBytes += static_cast<qint64>(iconEntry.image->getTotalSizeInBytes());
+        }
+    }
+    return result;
+}
+
+void IconCache::releaseUnused()
+{
+    // 仅被缓存自身引用（引用计数为1）的对象可以释放
+    for (auto it = geometries_.begin(); it != geometries_.end();) {
+        if (it.value()->referenceCount() <= 1) {
+            it = geometries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it.value().stateSet->referenceCount() <= 1 && it.value().texture->referenceCount() <= 2) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void IconCache::clear()
+{
+    // 仍被场景引用的对象不会随缓存析构，先显式释放其GL对象
+    for (auto it = geometries_.constBegin(); it != geometries_.constEnd(); ++it) {
+        it.value()->releaseGLObjects();
+    }
+    for (const IconEntry& iconEntry : entries_) {
+        iconEntry.stateSet->releaseGLObjects();
+    }
+    geometries_.clear();
+    entries_.clear();
+}
@@ -0,0 +1,122 @@
+/**
+ * @file iconcache.h
+ * @brief 图标共享缓存头文件
+ *
+ * 定义IconCache类，进程内共享图标的解码图像、纹理、渲染状态和四边形几何体。
+ */
+
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <osg/Image>
+#include <osg/Texture2D>
+#include <osg/StateSet>
+#include <osg/Geometry>
+#include <osg/Geode>
+
+/**
+ * @ingroup managers
+ * @brief 图标共享缓存
+ *
+ * 同一图标路径只解码一次，所有使用该图标的实体共享同一份osg::Image、osg::Texture2D
+ * 和osg::StateSet（GPU上只有一份纹理）；相同路径和尺寸的实体还共享同一个四边形几何体。
+ *
+ * - Qt资源路径（":/"）直接从内存中的资源数据解码（osgDB ReaderWriter流接口），不再写临时文件
+ * - 普通文件路径通过osgDB::readImageFile加载
+ * - 纹理与几何体持有GL对象，应在图形上下文销毁前调用clear()
+ * - 仅在主线程使用
+ */
+class IconCache
+{
+public:
+    /** @brief 缓存统计 */
+    struct Stats {
+        quint64 hits = 0;                 ///< 命中次数
+        quint64 misses = 0;               ///< 未命中（实际解码）次数
+        int iconCount = 0;                ///< 已缓存的图标数
+        int geometryCount = 0;            ///< 已缓存的四边形几何体数
+        qint64 residentTextureBytes = 0;  ///< 已缓存图像占用的字节数（即纹理上传量）
+    };
+
+    /** @brief 获取全局实例 */
+    static IconCache& instance();
+
+    /**
+     * @brief 获取共享的图标图像
+     * @param imagePath 图标路径（文件路径或Qt资源路径）
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 图像，失败返回空指针
+     */
+    osg::ref_ptr<osg::Image> image(const QString& imagePath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 获取共享的图标纹理
+     * @param imagePath 图标路径
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 纹理，失败返回空指针
+     */
+    osg::ref_ptr<osg::Texture2D> texture(const QString& imagePath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 获取共享的图标渲染状态（纹理、混合、透明渲染顺序）
+     * @param imagePath 图标路径
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 渲染状态，失败返回空指针
+     */
+    osg::ref_ptr<osg::StateSet> stateSet(const QString& imagePath, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 创建图标节点
+     *
+     * 返回新的Geode，其中的几何体和渲染状态为共享对象，调用方不应修改。
+     * 图标在IconAtlas中时使用图集纹理和对应的UV矩形，否则使用独立纹理。
+     * @param imagePath 图标路径
+     * @param size 四边形边长（米）
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 图标节点，失败返回空指针
+     */
+    osg::ref_ptr<osg::Geode> createIconGeode(const QString& imagePath, float size, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 向已有的Geode填充图标几何体和渲染状态（用于节点池取出的节点）
+     * @param geode 目标节点（原有的可绘制对象会先被移除）
+     * @param imagePath 图标路径
+     * @param size 四边形边长（米）
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 成功返回true
+     */
+    bool setupIconGeode(osg::Geode* geode, const QString& imagePath, float size, QString* errorMessage = nullptr);
+
+    /** @brief 获取缓存统计 */
+    Stats stats() const;
+
+    /** @brief 释放不再被任何实体引用的缓存项 */
+    void releaseUnused();
+
+    /** @brief 释放所有缓存项及其GL对象（应在图形上下文销毁前调用） */
+    void clear();
+
+private:
+    struct IconEntry {
+        osg::ref_ptr<osg::Image> image;
+        osg::ref_ptr<osg::Texture2D> texture;
+        osg::ref_ptr<osg::StateSet> stateSet;
+    };
+
+    IconCache() = default;
+    IconCache(const IconCache&) = delete;
+    IconCache& operator=(const IconCache&) = delete;
+
+    const IconEntry* entry(const QString& imagePath, QString* errorMessage);
+    static osg::ref_ptr<osg::Image> decode(const QString& imagePath, QString* errorMessage);
+    static osg::ref_ptr<osg::Geometry> buildQuad(float size, const osg::Vec4& uvRect);
+
+    QHash<QString, IconEntry> entries_;                          // 图标路径 -> 共享资源
+    QHash<QString, osg::ref_ptr<osg::Geometry>> geometries_;     // "路径|尺寸" -> 共享四边形
+    quint64 hits_ = 0;
+    quint64 misses_ = 0;
+};
+
+#endif // ICONCACHE_H
@@ -43,10 +43,22 @@ public:
     // 实现基类纯虚函数
     void initialize() override;
 
+    /** @brief 图标路径 */
+    QString getImagePath() const { return imagePath_; }
+
+    /**
+     * @brief 设置是否由IconBatchLayer批量绘制（须在initialize()之前调用）
+     *
+     * 批量绘制时createNode()只返回空的占位节点，图标由图层的实例化绘制负责。
+     */
+    void setBatched(bool batched) { batched_ = batched; }
+    bool isBatched() const { return batched_; }
+
 protected:
     osg::ref_ptr<osg::Node> createNode() override;
     
     QString imagePath_;
+    bool batched_ = false;
 };
 
 #endif // IMAGEENTITY_H
@@ -0,0 +1,281 @@
+/**
+ * @file labeldeclutter.cpp
+ * @brief 标签避让实现文件
+ *
+ * 实现LabelDeclutter类的所有功能
+ */
+
+#include "labeldeclutter.h"
+#include "screenpickbuffer.h"
+#include "geoentity.h"
+#include <QElapsedTimer>
+#include <QPair>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 已放置矩形分桶的像素边长（与常见标签尺寸相当）
+const double kCellPixels = 64.0;
+// 默认的普通标签最大显示距离（米）
+const double kDefaultMaxLabelRange = 1500000.0;
+// 标签之间额外保留的间距（像素）
+const double kLabelMargin = 2.0;
+
+quint64 cellKey(int cx, int cy)
+{
+    return (static_cast<quint64>(static_cast<quint32>(cy)) << 32) | static_cast<quint32>(cx);
+}
+}
+
+LabelDeclutter::LabelDeclutter()
+    : maxLabelRange_(kDefaultMaxLabelRange)
+{
+}
+
+void LabelDeclutter::addEntity(GeoEntity* entity)
+{
+    if (!entity || registrations_.contains(entity)) {
+        return;
+    }
+    Registration& registration = registrations_[entity];
+    registration.index = entities_.size();
+    registration.sequence = nextSequence_++;
+    entities_.append(entity);
+    if (entity->isLabelVisible()) {
+        shown_.insert(entity);
+    }
+    dirty_ = true;
+}
+
+void LabelDeclutter::removeEntity(GeoEntity* entity)
+{
+    auto it = registrations_.find(entity);
+    if (it == registrations_.end()) {
+        return;
+    }
+    const int index = it->index;
+    registrations_.erase(it);
+
+    // 优先级由登记序号决定，与下标无关：用最后一个元素填补空位
+    const int last = entities_.size() - 1;
+    if (index != last) {
+        GeoEntity* moved = entities_[last];
+        entities_[index] = moved;
+        registrations_[moved].index = index;
+    }
+    entities_.removeLast();
+
+    shown_.remove(entity);
+    if (lastSelected_ == entity) {
+        lastSelected_ = nullptr;
+    }
+    if (lastHovered_ == entity) {
+        lastHovered_ = nullptr;
+    }
+    dirty_ = true;
+}
+
+void LabelDeclutter::clear()
+{
+    entities_.clear();
+    registrations_.clear();
+    nextSequence_ = 0;
+    shown_.clear();
+    placed_.clear();
+    lastSelected_ = nullptr;
+    lastHovered_ = nullptr;
+    stats_ = Stats();
+    dirty_ = true;
+}
+
+void LabelDeclutter::setEnabled(bool enabled)
+{
+    if (enabled_ == enabled) {
+        return;
+    }
+    enabled_ = enabled;
+    dirty_ = true;
+    qDebug() << "标签避让:" << (enabled ? "启用" : "关闭");
+}
+
+void LabelDeclutter::setMaxLabelRange(double rangeMeters)
+{
+    if (rangeMeters <= 0.0 || qFuzzyCompare(maxLabelRange_, rangeMeters)) {
+        return;
+    }
+    maxLabelRange_ = rangeMeters;
+    dirty_ = true;
+}
+
+bool LabelDeclutter::overlaps(const QRectF& rect) const
+{
+    const int minCx = static_cast<int>(std::floor(rect.left() / kCellPixels));
+    const int maxCx = static_cast<int>(std::floor(rect.right() / kCellPixels));
+    const int minCy = static_cast<int>(std::floor(rect.top() / kCellPixels));
+    const int maxCy = static_cast<int>(std::floor(rect.bottom() / kCellPixels));
+
+    for (int cy = minCy; cy <= maxCy; ++cy) {
+        for (int cx = minCx; cx <= maxCx; ++cx) {
+            auto cellIt = placed_.constFind(cellKey(cx, cy));
+            if (cellIt == placed_.constEnd()) {
+                continue;
+            }
+            for (const QRectF& other : cellIt.value()) {
+                if (other.intersects(rect)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+void LabelDeclutter::insertRect(const QRectF& rect)
+{
+    const int minCx = static_cast<int>(std::floor(rect.left() / kCellPixels));
+    const int maxCx = static_cast<int>(std::floor(rect.right() / kCellPixels));
+    const int minCy = static_cast<int>(std::floor(rect.top() / kCellPixels));
+    const int maxCy = static_cast<int>(std::floor(rect.bottom() / kCellPixels));
+
+    for (int cy = minCy; cy <= maxCy; ++cy) {
+        for (int cx = minCx; cx <= maxCx; ++cx) {
+            placed_[cellKey(cx, cy)].append(rect);
+        }
+    }
+}
+
+bool LabelDeclutter::applyVisibility(GeoEntity* entity, bool visible)
+{
+    if (visible) {
+        shown_.insert(entity);
+    } else {
+        shown_.remove(entity);
+    }
+    if (entity->isLabelVisible() == visible) {
+        return false;
+    }
+    entity->setLabelVisible(visible);
+    return true;
+}
+
+bool LabelDeclutter::run(const ScreenPickBuffer& buffer, bool projected, double rangeMeters, double pixelScale,
+                         GeoEntity* selected, GeoEntity* hovered)
+{
+    const bool inRange = rangeMeters <= maxLabelRange_;
+    if (!dirty_ && !projected && selected == lastSelected_ && hovered == lastHovered_ && inRange == lastInRange_) {
+        return false;
+    }
+    dirty_ = false;
+    lastSelected_ = selected;
+    lastHovered_ = hovered;
+    lastInRange_ = inRange;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool changed = false;
+    Stats result;
+    result.passes = stats_.passes + 1;
+
+    if (!enabled_) {
+        lastInRange_ = true;
+        for (GeoEntity* entity : entities_) {
+            if (entity->hasLabel()) {
+                ++result.labelled;
+                ++result.shown;
+                changed |= applyVisibility(entity, true);
+            }
+        }
+        result.lastPassMs = timer.nsecsElapsed() / 1.0e6;
+        stats_ = result;
+        return changed;
+    }
+
+    placed_.clear();
+
+    // 只处理上次投影中可能可见的实体：选中、悬停实体优先放置，其余按登记顺序
+    const QVector<GeoEntity*>& visible = buffer.visibleEntities();
+    QVector<QPair<quint64, GeoEntity*>> ranked;
+    ranked.reserve(visible.size());
+    for (GeoEntity* entity : visible) {
+        auto it = registrations_.constFind(entity);
+        if (it != registrations_.constEnd() && entity != selected && entity != hovered) {
+            ranked.append(qMakePair(it->sequence, entity));
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const QPair<quint64, GeoEntity*>& lhs, const QPair<quint64, GeoEntity*>& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    QVector<GeoEntity*> order;
+    order.reserve(ranked.size() + 2);
+    if (selected && registrations_.contains(selected)) {
+        order.append(selected);
+    }
+    if (hovered && hovered != selected && registrations_.contains(hovered)) {
+        order.append(hovered);
+    }
+    for (const auto& item : ranked) {
+        order.append(item.second);
+    }
+
+    // 上次显示标签、本次已不在可能可见列表中的实体统一隐藏
+    QSet<GeoEntity*> stale = shown_;
+    for (GeoEntity* entity : order) {
+        stale.remove(entity);
+    }
+    for (GeoEntity* entity : stale) {
+        if (!entity->hasLabel()) {
+            shown_.remove(entity);
+            continue;
+        }
+        ++result.hiddenOffscreen;
+        changed |= applyVisibility(entity, false);
+    }
+
+    for (GeoEntity* entity : order) {
+        if (!entity->hasLabel()) {
+            continue;
+        }
+        ++result.labelled;
+
+        QPointF screen;
+        double depth = 0.0;
+        if (!entity->isRendered() || !buffer.screenPosition(entity, screen, &depth)) {
+            ++result.hiddenOffscreen;
+            changed |= applyVisibility(entity, false);
+            continue;
+        }
+
+        const bool priority = entity == selected || entity == hovered;
+        if (!inRange && !priority) {
+            ++result.hiddenByRange;
+            changed |= applyVisibility(entity, false);
+            continue;
+        }
+
+        const QRectF rect = entity->labelScreenRect(depth * pixelScale);
+        if (rect.isEmpty()) {
+            ++result.hiddenByRange;
+            changed |= applyVisibility(entity, false);
+            continue;
+        }
+
+        const QRectF placedRect = rect.translated(screen).adjusted(-kLabelMargin, -kLabelMargin,
+                                                                   kLabelMargin, kLabelMargin);
+        if (!priority && overlaps(placedRect)) {
+            ++result.hiddenByOverlap;
+            changed |= applyVisibility(entity, false);
+            continue;
+        }
+
+        insertRect(placedRect);
+        ++result.shown;
+        changed |= applyVisibility(entity, true);
+    }
+
+    result.lastPassMs = timer.nsecsElapsed() / 1.0e6;
+    stats_ = result;
+    return changed;
+}
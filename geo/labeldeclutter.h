@@ -0,0 +1,112 @@
+/**
+ * @file labeldeclutter.h
+ * @brief 标签避让头文件
+ *
+ * 定义LabelDeclutter类，每帧根据实体标签的屏幕矩形隐藏相互重叠的标签，
+ * 并按相机距离整体关闭远距离时的标签。
+ */
+
+#ifndef LABELDECLUTTER_H
+#define LABELDECLUTTER_H
+
+#include <QHash>
+#include <QRectF>
+#include <QSet>
+#include <QVector>
+
+class GeoEntity;
+class ScreenPickBuffer;
+
+/**
+ * @ingroup managers
+ * @brief 标签避让（屏幕空间贪心放置 + 距离LOD）
+ *
+ * 每次运行按优先级依次放置标签：选中实体、悬停实体、其余实体（按登记顺序）。
+ * 标签矩形与已放置的标签相交时隐藏（选中/悬停实体的标签总是显示）。
+ * 已放置的矩形按固定像素网格分桶，相交测试只检查矩形覆盖的网格单元。
+ *
+ * 距离LOD：相机距离超过maxLabelRange时只显示选中/悬停实体的标签。
+ * 隐藏通过GeoEntity::setLabelVisible()关闭标签节点（节点掩码为0），不再参与剔除与绘制。
+ *
+ * - 屏幕位置来自ScreenPickBuffer上次投影的结果，相机、实体、选中/悬停、距离档位都未变化时跳过
+ * - 只遍历投影得到的可能可见实体；上次显示标签而本次不在列表中的实体在同一次运行中隐藏
+ * - 仅在主线程使用
+ */
+class LabelDeclutter
+{
+public:
+    /** @brief 上次运行的统计 */
+    struct Stats {
+        int labelled = 0;            ///< 可能可见的带标签实体数
+        int shown = 0;               ///< 显示的标签数
+        int hiddenByOverlap = 0;     ///< 因重叠隐藏
+        int hiddenByRange = 0;       ///< 因距离LOD或标签过小隐藏
+        int hiddenOffscreen = 0;     ///< 不在屏幕内（或实体不可见），含本次离开可能可见列表的实体
+        quint64 passes = 0;          ///< 累计运行次数
+        double lastPassMs = 0.0;     ///< 上次运行耗时（毫秒）
+    };
+
+    LabelDeclutter();
+
+    /** @brief 登记实体（没有标签的实体在运行时跳过） */
+    void addEntity(GeoEntity* entity);
+    /** @brief 移除实体 */
+    void removeEntity(GeoEntity* entity);
+    /** @brief 清空 */
+    void clear();
+    /** @brief 标记需要重新运行（如标签文字变化） */
+    void invalidate() { dirty_ = true; }
+
+    /** @brief 启用/关闭避让；关闭时恢复显示所有标签 */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+
+    /** @brief 设置显示普通标签的最大相机距离（米） */
+    void setMaxLabelRange(double rangeMeters);
+    double maxLabelRange() const { return maxLabelRange_; }
+
+    /** @brief 上次运行时相机距离是否在标签显示范围内 */
+    bool labelsInRange() const { return lastInRange_; }
+
+    /**
+     * @brief 运行一次避让
+     * @param buffer 已完成本帧投影的屏幕拾取缓冲
+     * @param projected 本帧是否重新投影过（相机或实体变化）
+     * @param rangeMeters 当前相机距离
+     * @param pixelScale 视点空间单位深度处一个像素对应的米数（乘以深度即为实体处的米/像素）
+     * @param selected 当前选中实体（可为nullptr）
+     * @param hovered 当前悬停实体（可为nullptr）
+     * @return 有标签的显示状态发生变化返回true（调用方需要再渲染一帧）
+     */
+    bool run(const ScreenPickBuffer& buffer, bool projected, double rangeMeters, double pixelScale,
+             GeoEntity* selected, GeoEntity* hovered);
+
+    /** @brief 获取上次运行的统计 */
+    Stats stats() const { return stats_; }
+
+private:
+    bool overlaps(const QRectF& rect) const;
+    void insertRect(const QRectF& rect);
+    bool applyVisibility(GeoEntity* entity, bool visible);
+
+    struct Registration {
+        int index = 0;                           // entities_下标
+        quint64 sequence = 0;                    // 登记序号，即普通标签的优先级
+    };
+
+    QVector<GeoEntity*> entities_;               // 登记的实体（移除时用最后一个元素填补空位）
+    QHash<GeoEntity*, Registration> registrations_;
+    quint64 nextSequence_ = 0;
+    QSet<GeoEntity*> shown_;                     // 当前显示标签的实体
+    QHash<quint64, QVector<QRectF>> placed_;     // 像素网格 -> 已放置的标签矩形
+
+    bool enabled_ = true;
+    bool dirty_ = true;
+    double maxLabelRange_;
+    bool lastInRange_ = true;
+    GeoEntity* lastSelected_ = nullptr;
+    GeoEntity* lastHovered_ = nullptr;
+    Stats stats_;
+};
+
+#endif // LABELDECLUTTER_H
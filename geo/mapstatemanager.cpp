@@ -89,8 +89,13 @@ void MapStateManager::onMousePress(QMouseEvent* event)
 void MapStateManager::onMouseMove(QMouseEvent* event)
 {
     // qDebug() << "MapStateManager::onMouseMove 被调用" << event->pos();
+    updateMousePosition(event->pos());
+}
+
+void MapStateManager::updateMousePosition(QPoint screenPos)
+{
     // 更新鼠标地理坐标
-    updateMouseGeoPosition(event->pos());
+    updateMouseGeoPosition(screenPos);
     // 更新状态
     updateState();
     
@@ -216,11 +221,11 @@ void MapStateManager::initializeMapNode()
  */
 void MapStateManager::updateMouseGeoPosition(QPoint mousePos)
 {
-    // 使用工具函数进行坐标转换
-    if (GeoUtils::screenToGeoCoordinates(viewer_, mapNode_, mousePos, 
-                                         currentState_.mouseLongitude, 
-                                         currentState_.mouseLatitude, 
-                                         currentState_.mouseAltitude)) {
+    // 使用缓存的射线求交结果进行坐标转换
+    if (castTerrainRay(mousePos,
+                       currentState_.mouseLongitude,
+                       currentState_.mouseLatitude,
+                       currentState_.mouseAltitude)) {
         // 如果获取的高度接近0（椭球面高度），使用默认高度
         if (currentState_.mouseAltitude < 100.0) {
             currentState_.mouseAltitude = MapStateConstants::DEFAULT_ALTITUDE_METERS;
@@ -262,8 +267,8 @@ osgEarth::Viewpoint MapStateManager::getCurrentViewpoint(const QString& name) co
 
 bool MapStateManager::getGeoCoordinatesFromScreen(QPoint screenPos, double& longitude, double& latitude, double& altitude)
 {
-    // 使用工具函数进行坐标转换
-    if (GeoUtils::screenToGeoCoordinates(viewer_, mapNode_, screenPos, longitude, latitude, altitude)) {
+    // 使用缓存的射线求交结果进行坐标转换（同一事件中与updateMouseGeoPosition共享）
+    if (castTerrainRay(screenPos, longitude, latitude, altitude)) {
         // 如果获取的高度接近0（椭球面高度），使用默认高度
         if (altitude < 100.0) {
             altitude = MapStateConstants::DEFAULT_ALTITUDE_METERS;
@@ -278,6 +283,42 @@ bool MapStateManager::getGeoCoordinatesFromScreen(QPoint screenPos, double& long
     }
 }
 
+/**
+ * @brief 地形射线求交（带缓存）
+ *
+ * 以屏幕坐标和当前帧号为键缓存最近一次求交结果。相机只会在frame()中变化，
+ * 因此同一帧内对相同坐标的重复查询（如鼠标事件先更新状态、再由实体管理器拾取）
+ * 直接复用上次结果，地形求交每个事件至多执行一次。
+ *
+ * @param screenPos 屏幕坐标
+ * @param longitude 输出经度
+ * @param latitude 输出纬度
+ * @param altitude 输出高度
+ * @return 求交成功返回true
+ */
+bool MapStateManager::castTerrainRay(QPoint screenPos, double& longitude, double& latitude, double& altitude)
+{
+    const osg::FrameStamp* frameStamp = viewer_ ? viewer_->getFrameStamp() : nullptr;
+    const unsigned int frameNumber = frameStamp ? frameStamp->getFrameNumber() : 0;
+
+    if (!rayCache_.valid || rayCache_.screenPos != screenPos || rayCache_.frameNumber != frameNumber) {
+        rayCache_.hit = GeoUtils::screenToGeoCoordinates(viewer_, mapNode_, screenPos,
+                                                         rayCache_.longitude,
+                                                         rayCache_.latitude,
+                                                         rayCache_.altitude);
+        rayCache_.screenPos = screenPos;
+        rayCache_.frameNumber = frameNumber;
+        rayCache_.valid = true;
+    }
+
+    if (rayCache_.hit) {
+        longitude = rayCache_.longitude;
+        latitude = rayCache_.latitude;
+        altitude = rayCache_.altitude;
+    }
+    return rayCache_.hit;
+}
+
 osgEarth::Util::EarthManipulator* MapStateManager::getEarthManipulator() const
 {
     // 使用工具函数统一获取EarthManipulator
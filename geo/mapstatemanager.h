@@ -133,6 +133,14 @@ public slots:
     // 鼠标事件处理槽函数
     void onMousePress(QMouseEvent* event);
     void onMouseMove(QMouseEvent* event);
+    /**
+     * @brief 按鼠标位置更新状态（鼠标位置采样入口）
+     *
+     * 由OsgMapWidget每帧以最新的光标位置调用一次，完成鼠标地理坐标、
+     * 9元组状态更新并发出stateChanged。
+     * @param screenPos 鼠标屏幕坐标（相对于GLWidget）
+     */
+    void updateMousePosition(QPoint screenPos);
     void onMouseRelease(QMouseEvent* event);
     void onWheelEvent(QWheelEvent* event);
 
@@ -142,8 +150,22 @@ private:
     
     // 高程查询相关
     osgEarth::MapNode* mapNode_;
+
+    // 地形射线求交缓存：同一帧内相同屏幕坐标只求交一次，
+    // 供updateMouseGeoPosition与getGeoCoordinatesFromScreen共享
+    struct TerrainRayCache {
+        bool valid = false;
+        bool hit = false;
+        QPoint screenPos;
+        unsigned int frameNumber = 0;
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double altitude = 0.0;
+    };
+    TerrainRayCache rayCache_;
     
     // 内部方法
+    bool castTerrainRay(QPoint screenPos, double& longitude, double& latitude, double& altitude);
     void updateState();  // 更新所有状态信息
     void updateMouseGeoPosition(QPoint mousePos);  // 更新鼠标地理坐标
     void initializeMapNode();  // 初始化MapNode
@@ -0,0 +1,250 @@
+/**
+ * @file routegeometry.cpp
+ * @brief 航线几何实现文件
+ *
+ * 实现RouteGeometry类的所有功能
+ */
+
+#include "routegeometry.h"
+#include "waypointentity.h"
+#include <osg/LineWidth>
+#include <osg/StateSet>
+#include <cmath>
+
+namespace {
+const osg::Vec4 kLinearColor(0.2f, 0.8f, 1.0f, 1.0f);
+const osg::Vec4 kBezierColor(1.0f, 0.6f, 0.2f, 1.0f);
+const osg::Vec4 kRhumbColor(0.6f, 1.0f, 0.4f, 1.0f);
+
+// 尚未收到相机距离时的默认允许误差（米）
+const double kDefaultToleranceMeters = 1024.0;
+const double kMinToleranceMeters = 1.0;
+const double kMaxToleranceMeters = 65536.0;
+
+// 按2的幂分档，避免相机距离的细微变化触发重新细分
+double quantizeTolerance(double toleranceMeters)
+{
+    const double clamped = qBound(kMinToleranceMeters, toleranceMeters, kMaxToleranceMeters);
+    return std::pow(2.0, std::floor(std::log2(clamped)));
+}
+}
+
+RouteGeometry::RouteGeometry(const QString& model)
+    : model_(model)
+    , tessellatorModel_(RouteTessellator::modelFromName(model))
+    , tolerance_(kDefaultToleranceMeters)
+{
+    vertices_ = new osg::Vec3Array;
+    vertices_->setDataVariance(osg::Object::DYNAMIC);
+    colors_ = new osg::Vec4Array;
+    colors_->push_back(kLinearColor);
+
+    geometry_ = new osg::Geometry;
+    geometry_->setDataVariance(osg::Object::DYNAMIC);
+    geometry_->setUseDisplayList(false);
+    geometry_->setUseVertexBufferObjects(true);
+    geometry_->setVertexArray(vertices_.get());
+    geometry_->setColorArray(colors_.get(), osg::Array::BIND_OVERALL);
+    drawArrays_ = new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, 0);
+    geometry_->addPrimitiveSet(drawArrays_.get());
+
+    geode_ = new osg::Geode;
+    geode_->setName("Route");
+    geode_->addDrawable(geometry_.get());
+    // 提高可见性：加粗线宽、关闭光照、关闭深度测试
+    osg::StateSet* ss = geode_->getOrCreateStateSet();
+    ss->setAttributeAndModes(new osg::LineWidth(4.0f), osg::StateAttribute::ON);
+    ss->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    ss->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+    ss->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+    // 提前到最前层渲染，避免被其它对象覆盖
+    ss->setRenderBinDetails(9999, "RenderBin");
+
+    applyModelColor();
+}
+
+RouteTessellator::Point RouteGeometry::pointFor(const WaypointEntity* waypoint)
+{
+    RouteTessellator::Point point;
+    waypoint->getPosition(point.longitude, point.latitude, point.altitude);
+    return point;
+}
+
+void RouteGeometry::applyModelColor()
+{
+    switch (tessellatorModel_) {
+    case RouteTessellator::Model::Bezier:
+        (*colors_)[0] = kBezierColor;
+        break;
+    case RouteTessellator::Model::Rhumb:
+        (*colors_)[0] = kRhumbColor;
+        break;
+    default:
+        (*colors_)[0] = kLinearColor;
+        break;
+    }
+    colors_->dirty();
+}
+
+bool RouteGeometry::tessellateLeg(int leg)
+{
+    if (leg < 0 || leg >= legs_.size()) {
+        return false;
+    }
+    const RouteTessellator::Point& from = points_[leg];
+    const RouteTessellator::Point& to = points_[leg + 1];
+    Leg& target = legs_[leg];
+    const int previousCount = target.vertices.size();
+    target.subdivisions = RouteTessellator::subdivisions(tessellatorModel_, from, to, tolerance_);
+    RouteTessellator::tessellate(tessellatorModel_, from, to, target.subdivisions, target.vertices);
+    ++tessellatedLegs_;
+    return target.vertices.size() != previousCount;
+}
+
+void RouteGeometry::assemble()
+{
+    // 拼接各航段的缓存结果，相邻航段共享端点
+    size_t total = 0;
+    for (const Leg& leg : legs_) {
+        total += static_cast<size_t>(leg.vertices.size()) - (total > 0 ? 1 : 0);
+    }
+    vertices_->resize(total);
+
+    size_t cursor = 0;
+    for (Leg& leg : legs_) {
+        leg.offset = static_cast<int>(cursor > 0 ? cursor - 1 : 0);
+        for (int i = (cursor > 0 ? 1 : 0); i < leg.vertices.size(); ++i) {
+            (*vertices_)[cursor++] = leg.vertices[i];
+        }
+    }
+
+    drawArrays_->setCount(static_cast<GLsizei>(vertices_->size()));
+    drawArrays_->dirty();
+    vertices_->dirty();
+    geometry_->dirtyBound();
+}
+
+void RouteGeometry::patchLeg(int leg)
+{
+    if (leg < 0 || leg >= legs_.size()) {
+        return;
+    }
+    const Leg& source = legs_[leg];
+    for (int i = 0; i < source.vertices.size(); ++i) {
+        (*vertices_)[static_cast<size_t>(source.offset + i)] = source.vertices[i];
+    }
+}
+
+void RouteGeometry::rebuild(const QString& model, const QVector<WaypointEntity*>& waypoints)
+{
+    if (model_ != model) {
+        model_ = model;
+        tessellatorModel_ = RouteTessellator::modelFromName(model);
+        applyModelColor();
+    }
+
+    points_.clear();
+    points_.reserve(waypoints.size());
+    for (const WaypointEntity* waypoint : waypoints) {
+        points_.append(pointFor(waypoint));
+    }
+
+    legs_.clear();
+    legs_.resize(qMax(0, points_.size() - 1));
+    for (int i = 0; i < legs_.size(); ++i) {
+        tessellateLeg(i);
+    }
+    ++fullRebuilds_;
+    assemble();
+}
+
+void RouteGeometry::updatePoint(int index, const WaypointEntity* waypoint)
+{
+    if (index < 0 || index >= points_.size() || !waypoint) {
+        return;
+    }
+    points_[index] = pointFor(waypoint);
+    const bool previousResized = tessellateLeg(index - 1);
+    const bool nextResized = tessellateLeg(index);
+    if (previousResized || nextResized) {
+        assemble();
+        return;
+    }
+
+    // 顶点数不变（拖动航点的常见情况）：只改写相邻两段的顶点区间
+    patchLeg(index - 1);
+    patchLeg(index);
+    vertices_->dirty();
+    geometry_->dirtyBound();
+}
+
+void RouteGeometry::insertPoint(int index, const WaypointEntity* waypoint)
+{
+    if (index < 0 || index > points_.size() || !waypoint) {
+        return;
+    }
+    points_.insert(index, pointFor(waypoint));
+    if (points_.size() < 2) {
+        return;
+    }
+
+    // 原航段 index-1 一分为二：在index处插入新航段，再细分两侧
+    legs_.insert(qMin(index, legs_.size()), Leg());
+    tessellateLeg(index - 1);
+    tessellateLeg(index);
+    assemble();
+}
+
+void RouteGeometry::removePoint(int index)
+{
+    if (index < 0 || index >= points_.size()) {
+        return;
+    }
+    const bool interior = index > 0 && index < points_.size() - 1;
+    points_.removeAt(index);
+
+    if (points_.size() < 2) {
+        legs_.clear();
+    } else {
+        // 删除起点/终点时直接去掉首/尾航段；删除中间航点时前后两段合并为一段
+        legs_.removeAt(qMin(index, legs_.size() - 1));
+        if (interior) {
+            tessellateLeg(index - 1);
+        }
+    }
+    assemble();
+}
+
+bool RouteGeometry::setErrorTolerance(double toleranceMeters)
+{
+    const double tolerance = quantizeTolerance(toleranceMeters);
+    if (tolerance == tolerance_) {
+        return false;
+    }
+    tolerance_ = tolerance;
+
+    // 只重新细分细分数发生变化的航段
+    bool changed = false;
+    for (int i = 0; i < legs_.size(); ++i) {
+        const int subdivisions = RouteTessellator::subdivisions(tessellatorModel_, points_[i], points_[i + 1], tolerance_);
+        if (subdivisions != legs_[i].subdivisions) {
+            tessellateLeg(i);
+            changed = true;
+        }
+    }
+    if (changed) {
+        assemble();
+    }
+    return changed;
+}
+
+RouteGeometry::Stats RouteGeometry::stats() const
+{
+    Stats result;
+    result.vertexCount = static_cast<int>(vertices_->size());
+    result.legCount = legs_.size();
+    result.toleranceMeters = tolerance_;
+    result.fullRebuilds = fullRebuilds_;
+    result.tessellatedLegs = tessellatedLegs_;
+    return result;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file routegeometry.h
+ * @brief 航线几何头文件
+ *
+ * 定义RouteGeometry类，航点组的航线节点常驻场景，航点移动、插入或删除时
+ * 只重新细分受影响的航段。
+ */
+
+#ifndef ROUTEGEOMETRY_H
+#define ROUTEGEOMETRY_H
+
+#include <QString>
+#include <QVector>
+#include <osg/Referenced>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Vec3d>
+#include "routetessellator.h"
+
+class WaypointEntity;
+
+/**
+ * @ingroup managers
+ * @brief 常驻航线几何（按航段缓存细分结果）
+ *
+ * 每个航段由RouteTessellator按模型（linear/geodesic沿大圆、rhumb沿恒向线、bezier）细分，
+ * 细分数由航段角距离与当前允许误差决定；细分结果按航段缓存，相邻航段共享端点，
+ * 依次拼接为一条LINE_STRIP。
+ *
+ * - 移动一个航点只重新细分相邻两段；两段顶点数不变时只改写它们在顶点数组中的区间，
+ *   否则重新拼接；插入/删除航点只细分新出现的航段
+ * - 允许误差按2的幂分档，相机距离变化未跨档时不做任何计算；跨档时只重新细分细分数变化的航段
+ * - Geode、Geometry、StateSet只在构造时创建一次，之后只改写顶点数组并标记VBO脏
+ *
+ * - 仅在主线程使用
+ */
+class RouteGeometry : public osg::Referenced
+{
+public:
+    /** @brief 统计 */
+    struct Stats {
+        int vertexCount = 0;             ///< 当前顶点数
+        int legCount = 0;                ///< 航段数
+        double toleranceMeters = 0.0;    ///< 当前生效的允许误差（分档后）
+        int fullRebuilds = 0;            ///< 整体重建次数
+        quint64 tessellatedLegs = 0;     ///< 累计细分的航段数
+    };
+
+    /**
+     * @brief 构造函数
+     * @param model 航线模型（linear|geodesic|rhumb|bezier）
+     */
+    explicit RouteGeometry(const QString& model);
+
+    /** @brief 航线节点（加入实体组即可） */
+    osg::Geode* getNode() const { return geode_.get(); }
+    /** @brief 航线模型 */
+    QString model() const { return model_; }
+    /** @brief 航点数 */
+    int pointCount() const { return points_.size(); }
+
+    /** @brief 按模型与航点列表整体重建（复用已有节点与状态） */
+    void rebuild(const QString& model, const QVector<WaypointEntity*>& waypoints);
+    /** @brief 航点移动后改写其相邻航段 */
+    void updatePoint(int index, const WaypointEntity* waypoint);
+    /** @brief 在index处插入航点 */
+    void insertPoint(int index, const WaypointEntity* waypoint);
+    /** @brief 删除index处的航点，前后航段合并为一段 */
+    void removePoint(int index);
+
+    /**
+     * @brief 设置允许的弦高误差（通常为相机距离下一个像素对应的米数）
+     * @param toleranceMeters 允许误差（米），内部按2的幂分档
+     * @return 有航段重新细分返回true
+     */
+    bool setErrorTolerance(double toleranceMeters);
+
+    /** @brief 获取统计 */
+    Stats stats() const;
+
+protected:
+    ~RouteGeometry() override = default;
+
+private:
+    struct Leg {
+        int subdivisions = 0;
+        int offset = 0;                  // 第一个顶点在拼接后顶点数组中的下标
+        QVector<osg::Vec3d> vertices;    // 细分结果（含两端点，世界坐标）
+    };
+
+    static RouteTessellator::Point pointFor(const WaypointEntity* waypoint);
+    /** @brief 重新细分航段，返回顶点数是否变化 */
+    bool tessellateLeg(int leg);
+    void applyModelColor();
+    /** @brief 拼接所有航段（顶点数变化时） */
+    void assemble();
+    /** @brief 顶点数不变时只改写该航段在拼接数组中的区间 */
+    void patchLeg(int leg);
+
+    QString model_;
+    RouteTessellator::Model tessellatorModel_;
+    double tolerance_;                   // 分档后的允许误差（米）
+    osg::ref_ptr<osg::Geode> geode_;
+    osg::ref_ptr<osg::Geometry> geometry_;
+    osg::ref_ptr<osg::Vec3Array> vertices_;
+    osg::ref_ptr<osg::Vec4Array> colors_;
+    osg::ref_ptr<osg::DrawArrays> drawArrays_;
+
+    QVector<RouteTessellator::Point> points_;    // 航点经纬度
+    QVector<Leg> legs_;                          // 航段 i 连接航点 i 与 i + 1
+    int fullRebuilds_ = 0;
+    quint64 tessellatedLegs_ = 0;
+};
+
+#endif // ROUTEGEOMETRY_H
@@ -0,0 +1,155 @@
+/**
+ * @file routetessellator.cpp
+ * @brief 航段细分实现文件
+ *
+ * 实现RouteTessellator类的所有功能
+ */
+
+#include "routetessellator.h"
+#include "geoutils.h"
+#include <QtGlobal>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+const double kEarthRadiusMeters = 6371000.0;
+const double kMinToleranceMeters = 0.5;
+// 恒向线计算中避开极点的纬度上限（度）
+const double kRhumbMaxLatitude = 89.9;
+
+double toRadians(double degrees) { return degrees * M_PI / 180.0; }
+double toDegrees(double radians) { return radians * 180.0 / M_PI; }
+
+// 经度差规约到[-180, 180]，跨越日期变更线时走短的一侧
+double wrapLongitudeDelta(double delta)
+{
+    while (delta > 180.0) delta -= 360.0;
+    while (delta < -180.0) delta += 360.0;
+    return delta;
+}
+
+osg::Vec3d unitVector(const RouteTessellator::Point& p)
+{
+    const double lon = toRadians(p.longitude);
+    const double lat = toRadians(p.latitude);
+    return osg::Vec3d(std::cos(lat) * std::cos(lon), std::cos(lat) * std::sin(lon), std::sin(lat));
+}
+
+double mercatorY(double latitudeDegrees)
+{
+    const double lat = toRadians(qBound(-kRhumbMaxLatitude, latitudeDegrees, kRhumbMaxLatitude));
+    return std::log(std::tan(M_PI / 4.0 + lat / 2.0));
+}
+}
+
+RouteTessellator::Model RouteTessellator::modelFromName(const QString& name)
+{
+    if (name == QStringLiteral("bezier")) {
+        return Model::Bezier;
+    }
+    if (name == QStringLiteral("rhumb")) {
+        return Model::Rhumb;
+    }
+    return Model::Geodesic;
+}
+
+double RouteTessellator::centralAngle(const Point& from, const Point& to)
+{
+    const osg::Vec3d a = unitVector(from);
+    const osg::Vec3d b = unitVector(to);
+    // atan2形式在极小与接近180°的角度下都稳定
+    return std::atan2((a ^ b).length(), a * b);
+}
+
+int RouteTessellator::subdivisions(Model model, const Point& from, const Point& to, double toleranceMeters)
+{
+    const double tolerance = qMax(kMinToleranceMeters, toleranceMeters);
+    const double ratio = qMin(1.0, tolerance / kEarthRadiusMeters);
+    const double maxStep = 2.0 * std::acos(1.0 - ratio);
+
+    double angle = centralAngle(from, to);
+    if (model == Model::Rhumb) {
+        // 恒向线比大圆长，按恒向线长度估算
+        const double dLat = toRadians(to.latitude - from.latitude);
+        const double dPsi = mercatorY(to.latitude) - mercatorY(from.latitude);
+        const double q = std::fabs(dPsi) > 1e-12 ? dLat / dPsi : std::cos(toRadians(from.latitude));
+        const double dLon = toRadians(wrapLongitudeDelta(to.longitude - from.longitude));
+        angle = std::sqrt(dLat * dLat + q * q * dLon * dLon);
+    }
+
+    int count = maxStep > 0.0 ? static_cast<int>(std::ceil(angle / maxStep)) : kMaxSubdivisions;
+    count = qBound(1, count, kMaxSubdivisions);
+    if (model == Model::Bezier) {
+        count = qMax(2, count);
+    }
+    return count;
+}
+
+void RouteTessellator::tessellate(Model model, const Point& from, const Point& to, int subdivisions,
+                                  QVector<osg::Vec3d>& out)
+{
+    const int count = qBound(1, subdivisions, kMaxSubdivisions);
+    out.clear();
+    out.reserve(count + 1);
+
+    switch (model) {
+    case Model::Geodesic: {
+        const osg::Vec3d a = unitVector(from);
+        const osg::Vec3d b = unitVector(to);
+        const double omega = std::atan2((a ^ b).length(), a * b);
+        const double sinOmega = std::sin(omega);
+        for (int i = 0; i <= count; ++i) {
+            const double t = static_cast<double>(i) / count;
+            osg::Vec3d p;
+            if (sinOmega < 1e-9) {
+                p = a * (1.0 - t) + b * t;
+                p.normalize();
+            } else {
+                p = a * (std::sin((1.0 - t) * omega) / sinOmega) + b * (std::sin(t * omega) / sinOmega);
+            }
+            const double lat = toDegrees(std::asin(qBound(-1.0, p.z(), 1.0)));
+            const double lon = toDegrees(std::atan2(p.y(), p.x()));
+            const double alt = from.altitude + (to.altitude - from.altitude) * t;
+            out.append(GeoUtils::geoToWorldCoordinates(lon, lat, alt));
+        }
+        break;
+    }
+    case Model::Rhumb: {
+        const double psi1 = mercatorY(from.latitude);
+        const double psi2 = mercatorY(to.latitude);
+        const double dLon = wrapLongitudeDelta(to.longitude - from.longitude);
+        for (int i = 0; i <= count; ++i) {
+            const double t = static_cast<double>(i) / count;
+            const double psi = psi1 + (psi2 - psi1) * t;
+            const double lat = toDegrees(2.0 * std::atan(std::exp(psi)) - M_PI / 2.0);
+            const double lon = from.longitude + dLon * t;
+            const double alt = from.altitude + (to.altitude - from.altitude) * t;
+            out.append(GeoUtils::geoToWorldCoordinates(lon, lat, alt));
+        }
+        break;
+    }
+    case Model::Bezier: {
+        // 控制点：使用经纬度中点作为近似控制
+        const osg::Vec3d p0 = GeoUtils::geoToWorldCoordinates(from.longitude, from.latitude, from.altitude);
+        const osg::Vec3d p2 = GeoUtils::geoToWorldCoordinates(to.longitude, to.latitude, to.altitude);
+        const osg::Vec3d p1 = GeoUtils::geoToWorldCoordinates((from.longitude + to.longitude) / 2.0,
+                                                              (from.latitude + to.latitude) / 2.0,
+                                                              (from.altitude + to.altitude) / 2.0);
+        for (int i = 0; i <= count; ++i) {
+            const double t = static_cast<double>(i) / count;
+            const double u = 1.0 - t;
+            out.append(p0 * (u * u) + p1 * (2.0 * u * t) + p2 * (t * t));
+        }
+        break;
+    }
+    }
+
+    if (model != Model::Bezier) {
+        // 两端点使用原始坐标，避免三角函数往返与极点截断带来的偏差，保证相邻航段首尾相接
+        out.first() = GeoUtils::geoToWorldCoordinates(from.longitude, from.latitude, from.altitude);
+        out.last() = GeoUtils::geoToWorldCoordinates(to.longitude, to.latitude, to.altitude);
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file routetessellator.h
+ * @brief 航段细分头文件
+ *
+ * 定义RouteTessellator类，按大圆（测地线）、恒向线或贝塞尔模型细分航段，
+ * 细分数由航段角距离与允许的弦高误差决定。
+ */
+
+#ifndef ROUTETESSELLATOR_H
+#define ROUTETESSELLATOR_H
+
+#include <QString>
+#include <QVector>
+#include <osg/Vec3d>
+
+/**
+ * @ingroup managers
+ * @brief 航段细分（无状态工具类）
+ *
+ * - geodesic：沿球面大圆插值（球面线性插值），长航段不再穿过地球内部
+ * - rhumb：沿恒向线插值（墨卡托投影下为直线，航向不变）
+ * - bezier：以经纬度中点为控制点的二次贝塞尔曲线（世界坐标）
+ *
+ * 细分数：相邻采样点之间的弦相对球面的最大偏离为 R * (1 - cos(δ/2))，
+ * 令其不超过允许误差得到最大采样角 δ，细分数为 ceil(航段角距离 / δ)。
+ * 允许误差通常取当前相机距离下一个像素对应的米数，因此近看时细分更密，远看时更稀。
+ *
+ * 高度在航段内线性插值；插值点经GeoUtils::geoToWorldCoordinates转换到世界坐标（椭球）。
+ */
+class RouteTessellator
+{
+public:
+    /** @brief 航线模型 */
+    enum class Model {
+        Geodesic,
+        Rhumb,
+        Bezier
+    };
+
+    /** @brief 航段端点 */
+    struct Point {
+        double longitude = 0.0;
+        double latitude = 0.0;
+        double altitude = 0.0;
+    };
+
+    static const int kMaxSubdivisions = 512;   ///< 单个航段的细分上限
+
+    /** @brief 由模型名（linear|geodesic|rhumb|bezier）得到模型，linear按大圆处理 */
+    static Model modelFromName(const QString& name);
+
+    /** @brief 两点之间的球面角距离（弧度） */
+    static double centralAngle(const Point& from, const Point& to);
+
+    /**
+     * @brief 计算航段细分数
+     * @param model 航线模型
+     * @param from 起点
+     * @param to 终点
+     * @param toleranceMeters 允许的弦高误差（米）
+     * @return 细分数（至少为1，贝塞尔至少为2）
+     */
+    static int subdivisions(Model model, const Point& from, const Point& to, double toleranceMeters);
+
+    /**
+     * @brief 细分航段
+     * @param model 航线模型
+     * @param from 起点
+     * @param to 终点
+     * @param subdivisions 细分数
+     * @param out 输出世界坐标（清空后写入 subdivisions + 1 个点，含两端点）
+     */
+    static void tessellate(Model model, const Point& from, const Point& to, int subdivisions,
+                           QVector<osg::Vec3d>& out);
+};
+
+#endif // ROUTETESSELLATOR_H
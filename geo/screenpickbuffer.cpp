@@ -0,0 +1,317 @@
+/**
+ * @file screenpickbuffer.cpp
+ * @brief 屏幕空间拾取缓冲实现文件
+ *
+ * 实现ScreenPickBuffer类的所有功能
+ */
+
+#include "screenpickbuffer.h"
+#include "geoentity.h"
+#include "geoutils.h"
+#include <osg/Viewport>
+#include <cmath>
+#include <limits>
+
+namespace {
+// 屏幕分桶的像素边长，应不小于常用拾取半径
+const double kCellPixels = 32.0;
+// 视锥筛选外扩的像素数：锚点略在屏幕外的实体，其图标或标签仍可能部分可见
+const double kCullMarginPixels = 64.0;
+// WGS84椭球长半轴与短半轴（米）
+const double kWgs84SemiMajor = 6378137.0;
+const double kWgs84SemiMinor = 6356752.314245;
+
+// 缩放到单位球空间（椭球变为单位球）
+osg::Vec3d toUnitSphere(const osg::Vec3d& world)
+{
+    return osg::Vec3d(world.x() / kWgs84SemiMajor, world.y() / kWgs84SemiMajor, world.z() / kWgs84SemiMinor);
+}
+}
+
+ScreenPickBuffer::ScreenPickBuffer()
+{
+}
+
+quint64 ScreenPickBuffer::cellKey(int cx, int cy) const
+{
+    return (static_cast<quint64>(static_cast<quint32>(cy)) << 32) | static_cast<quint32>(cx);
+}
+
+void ScreenPickBuffer::refreshWorld(Entry& entry) const
+{
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    entry.entity->getPosition(longitude, latitude, altitude);
+    entry.world = GeoUtils::geoToWorldCoordinates(longitude, latitude, altitude);
+}
+
+bool ScreenPickBuffer::isBelowHorizon(const osg::Vec3d& scaledEye, double eyeHorizonSq, const osg::Vec3d& world)
+{
+    // 在单位球空间中，视点到地平线切点的距离平方为 |E|^2 - 1；
+    // 目标点在视点与地平线切平面之后且落在切锥之内时被椭球遮挡
+    const osg::Vec3d toTarget = toUnitSphere(world) - scaledEye;
+    const double projection = -(toTarget * scaledEye);
+    if (projection <= eyeHorizonSq) {
+        return false;
+    }
+    return projection * projection / toTarget.length2() > eyeHorizonSq;
+}
+
+void ScreenPickBuffer::addEntity(GeoEntity* entity)
+{
+    if (!entity) {
+        return;
+    }
+    if (entryIndex_.contains(entity)) {
+        updateEntity(entity);
+        return;
+    }
+
+    Entry entry;
+    entry.entity = entity;
+    refreshWorld(entry);
+    entryIndex_.insert(entity, entries_.size());
+    entries_.append(entry);
+    dirty_ = true;
+}
+
+void ScreenPickBuffer::updateEntity(GeoEntity* entity)
+{
+    auto it = entryIndex_.constFind(entity);
+    if (it == entryIndex_.constEnd()) {
+        return;
+    }
+    refreshWorld(entries_[it.value()]);
+    dirty_ = true;
+}
+
+void ScreenPickBuffer::removeEntity(GeoEntity* entity)
+{
+    auto it = entryIndex_.find(entity);
+    if (it == entryIndex_.end()) {
+        return;
+    }
+
+    const int index = it.value();
+    const int lastIndex = entries_.size() - 1;
+    entryIndex_.erase(it);
+
+    // 同步维护屏幕分桶，保证下一次投影前的拾取也不会返回已移除的实体
+    auto cellOf = [this](const Entry& entry) {
+        return cellKey(static_cast<int>(std::floor(entry.screen.x() / kCellPixels)),
+                       static_cast<int>(std::floor(entry.screen.y() / kCellPixels)));
+    };
+    if (entries_[index].onScreen) {
+        auto cellIt = screenCells_.find(cellOf(entries_[index]));
+        if (cellIt != screenCells_.end()) {
+            cellIt.value().removeOne(index);
+        }
+        --onScreenCount_;
+    }
+    if (entries_[index].potentiallyVisible) {
+        // 可能可见列表延迟到下次读取或投影时统一过滤，避免每次移除都线性查找
+        visibleStale_ = true;
+    }
+    if (index != lastIndex) {
+        if (entries_[lastIndex].onScreen) {
+            auto cellIt = screenCells_.find(cellOf(entries_[lastIndex]));
+            if (cellIt != screenCells_.end()) {
+                int pos = cellIt.value().indexOf(lastIndex);
+                if (pos >= 0) {
+                    cellIt.value()[pos] = index;
+                }
+            }
+        }
+        entries_[index] = entries_[lastIndex];
+        entryIndex_[entries_[index].entity] = index;
+    }
+    entries_.removeLast();
+}
+
+void ScreenPickBuffer::clear()
+{
+    entries_.clear();
+    entryIndex_.clear();
+    screenCells_.clear();
+    visibleEntities_.clear();
+    visibleStale_ = false;
+    onScreenCount_ = 0;
+    dirty_ = true;
+}
+
+const QVector<GeoEntity*>& ScreenPickBuffer::visibleEntities() const
+{
+    if (visibleStale_) {
+        // 只按指针查找，不访问可能已删除的实体
+        QVector<GeoEntity*> kept;
+        kept.reserve(visibleEntities_.size());
+        for (GeoEntity* entity : visibleEntities_) {
+            auto it = entryIndex_.constFind(entity);
+            if (it != entryIndex_.constEnd() && entries_[it.value()].potentiallyVisible) {
+                kept.append(entity);
+            }
+        }
+        visibleEntities_.swap(kept);
+        visibleStale_ = false;
+    }
+    return visibleEntities_;
+}
+
+bool ScreenPickBuffer::project(osg::Camera* camera)
+{
+    if (!camera || !camera->getViewport()) {
+        return false;
+    }
+
+    const osg::Viewport* viewport = camera->getViewport();
+    const osg::Matrixd view = camera->getViewMatrix();
+    const osg::Matrixd projectionWindow = camera->getProjectionMatrix() * viewport->computeWindowMatrix();
+    const osg::Matrixd viewProjectionWindow = view * projectionWindow;
+    const int viewportHeight = static_cast<int>(viewport->height());
+
+    if (!dirty_ && viewportHeight == lastViewportHeight_ && viewProjectionWindow == lastProjection_) {
+        return false;
+    }
+    lastProjection_ = viewProjectionWindow;
+    lastViewportHeight_ = viewportHeight;
+    dirty_ = false;
+
+    const osg::Vec3d eye = osg::Matrixd::inverse(view).getTrans();
+    const osg::Vec3d scaledEye = toUnitSphere(eye);
+    const double eyeHorizonSq = scaledEye.length2() - 1.0;
+    const double minX = viewport->x();
+    const double maxX = viewport->x() + viewport->width();
+    const double minY = viewport->y();
+    const double maxY = viewport->y() + viewport->height();
+
+    screenCells_.clear();
+    visibleEntities_.clear();
+    visibleStale_ = false;
+    onScreenCount_ = 0;
+    CullStats stats;
+    stats.total = entries_.size();
+    stats.passes = cullStats_.passes + 1;
+
+    for (int i = 0; i < entries_.size(); ++i) {
+        Entry& entry = entries_[i];
+        entry.onScreen = false;
+        entry.potentiallyVisible = false;
+        if (!entry.entity->isRendered()) {
+            ++stats.hidden;
+            continue;
+        }
+
+        // 地球背面：被WGS84椭球遮挡（视点在椭球内部时不做地平线剔除）
+        if (eyeHorizonSq > 0.0 && isBelowHorizon(scaledEye, eyeHorizonSq, entry.world)) {
+            ++stats.horizonCulled;
+            continue;
+        }
+
+        // 相机背后（OSG相机朝-Z方向观察）
+        const osg::Vec3d eyeSpace = entry.world * view;
+        if (eyeSpace.z() >= 0.0) {
+            ++stats.frustumCulled;
+            continue;
+        }
+
+        const osg::Vec3d window = eyeSpace * projectionWindow;
+        if (window.x() < minX - kCullMarginPixels || window.x() > maxX + kCullMarginPixels
+            || window.y() < minY - kCullMarginPixels || window.y() > maxY + kCullMarginPixels) {
+            ++stats.frustumCulled;
+            continue;
+        }
+        entry.potentiallyVisible = true;
+        visibleEntities_.append(entry.entity);
+
+        if (window.x() < minX || window.x() > maxX || window.y() < minY || window.y() > maxY) {
+            continue;
+        }
+
+        // 转换为Qt窗口坐标（Y=0在顶部），与GeoUtils::screenToGeoCoordinates的翻转保持一致
+        entry.screen = QPointF(window.x(), viewportHeight - window.y() - 1);
+        entry.depth = -eyeSpace.z();
+        entry.onScreen = true;
+        ++onScreenCount_;
+
+        screenCells_[cellKey(static_cast<int>(std::floor(entry.screen.x() / kCellPixels)),
+                             static_cast<int>(std::floor(entry.screen.y() / kCellPixels)))].append(i);
+    }
+
+    stats.visible = visibleEntities_.size();
+    cullStats_ = stats;
+    return true;
+}
+
+bool ScreenPickBuffer::isPotentiallyVisible(GeoEntity* entity) const
+{
+    if (cullStats_.passes == 0) {
+        return true;
+    }
+    auto it = entryIndex_.constFind(entity);
+    return it != entryIndex_.constEnd() && entries_[it.value()].potentiallyVisible;
+}
+
+ScreenPickBuffer::CullStats ScreenPickBuffer::cullStats() const
+{
+    CullStats result = cullStats_;
+    result.total = entries_.size();
+    result.visible = visibleEntities().size();
+    return result;
+}
+
+bool ScreenPickBuffer::screenPosition(GeoEntity* entity, QPointF& outScreen, double* outDepth) const
+{
+    auto it = entryIndex_.constFind(entity);
+    if (it == entryIndex_.constEnd()) {
+        return false;
+    }
+    const Entry& entry = entries_[it.value()];
+    if (!entry.onScreen) {
+        return false;
+    }
+    outScreen = entry.screen;
+    if (outDepth) {
+        *outDepth = entry.depth;
+    }
+    return true;
+}
+
+GeoEntity* ScreenPickBuffer::pick(const QPointF& screenPos, double radiusPixels, double* outDistancePixels) const
+{
+    if (screenCells_.isEmpty() || radiusPixels <= 0.0) {
+        return nullptr;
+    }
+
+    const int minCx = static_cast<int>(std::floor((screenPos.x() - radiusPixels) / kCellPixels));
+    const int maxCx = static_cast<int>(std::floor((screenPos.x() + radiusPixels) / kCellPixels));
+    const int minCy = static_cast<int>(std::floor((screenPos.y() - radiusPixels) / kCellPixels));
+    const int maxCy = static_cast<int>(std::floor((screenPos.y() + radiusPixels) / kCellPixels));
+
+    GeoEntity* best = nullptr;
+    double bestDistanceSq = radiusPixels * radiusPixels;
+
+    for (int cy = minCy; cy <= maxCy; ++cy) {
+        for (int cx = minCx; cx <= maxCx; ++cx) {
+            auto cellIt = screenCells_.constFind(cellKey(cx, cy));
+            if (cellIt == screenCells_.constEnd()) {
+                continue;
+            }
+            for (int index : cellIt.value()) {
+                const Entry& entry = entries_[index];
+                const double dx = entry.screen.x() - screenPos.x();
+                const double dy = entry.screen.y() - screenPos.y();
+                const double distanceSq = dx * dx + dy * dy;
+                if (distanceSq <= bestDistanceSq) {
+                    bestDistanceSq = distanceSq;
+                    best = entry.entity;
+                }
+            }
+        }
+    }
+
+    if (best && outDistancePixels) {
+        *outDistancePixels = std::sqrt(bestDistanceSq);
+    }
+    return best;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file screenpickbuffer.h
+ * @brief 屏幕空间拾取缓冲头文件
+ *
+ * 定义ScreenPickBuffer类，缓存每帧实体在屏幕上的投影位置，
+ * 使悬停高亮只需在像素空间做最近点查找，无需地形射线求交。
+ */
+
+#ifndef SCREENPICKBUFFER_H
+#define SCREENPICKBUFFER_H
+
+#include <QHash>
+#include <QVector>
+#include <QPointF>
+#include <osg/Camera>
+#include <osg/Matrixd>
+#include <osg/Vec3d>
+
+class GeoEntity;
+
+/**
+ * @ingroup managers
+ * @brief 屏幕空间拾取缓冲
+ *
+ * 保存实体的世界坐标（仅在位置变化时重新计算），每帧渲染后根据相机的
+ * View * Projection * Window 矩阵投影到屏幕，并按固定像素网格分桶。
+ * 相机与实体都未变化时跳过投影。
+ *
+ * 投影同时完成一次CPU端可见性筛选：先按WGS84椭球做地平线剔除，再按视锥（外扩少量像素）剔除，
+ * 通过的实体组成紧凑的可能可见列表，拾取、标签避让等逐帧逻辑只遍历该列表而不是全部实体。
+ *
+ * - 屏幕坐标采用Qt约定（Y=0在顶部），与鼠标事件坐标一致
+ * - 位于相机背后或地球背面的实体不参与拾取
+ */
+class ScreenPickBuffer
+{
+public:
+    /** @brief 上次投影的可见性筛选统计 */
+    struct CullStats {
+        int total = 0;               ///< 登记的实体数
+        int visible = 0;             ///< 可能可见的实体数
+        int hidden = 0;              ///< 不可见或被聚合
+        int horizonCulled = 0;       ///< 位于地平线以下（地球背面）
+        int frustumCulled = 0;       ///< 位于视锥以外
+        quint64 passes = 0;          ///< 累计投影次数
+    };
+
+    ScreenPickBuffer();
+
+    /** @brief 添加实体（已存在时刷新其世界坐标） */
+    void addEntity(GeoEntity* entity);
+    /** @brief 实体位置变化后刷新其世界坐标 */
+    void updateEntity(GeoEntity* entity);
+    /** @brief 移除实体（立即生效，避免拾取到待删除实体） */
+    void removeEntity(GeoEntity* entity);
+    /** @brief 清空缓冲 */
+    void clear();
+    /** @brief 标记需要重新投影（如实体可见性变化） */
+    void invalidate() { dirty_ = true; }
+
+    /**
+     * @brief 按当前相机投影所有实体
+     * @param camera 渲染相机
+     * @return 实际执行了投影返回true，相机与实体均未变化返回false
+     */
+    bool project(osg::Camera* camera);
+
+    /**
+     * @brief 在屏幕空间查找最近的实体
+     * @param screenPos Qt窗口坐标
+     * @param radiusPixels 拾取半径（像素）
+     * @param outDistancePixels 输出最近距离（可为nullptr）
+     * @return 半径内最近的可见实体，未找到返回nullptr
+     */
+    GeoEntity* pick(const QPointF& screenPos, double radiusPixels, double* outDistancePixels = nullptr) const;
+
+    /**
+     * @brief 查询实体上次投影的屏幕位置
+     * @param entity 实体
+     * @param outScreen 输出Qt窗口坐标
+     * @param outDepth 输出视点空间深度（米，可为nullptr）
+     * @return 实体在屏幕内返回true
+     */
+    bool screenPosition(GeoEntity* entity, QPointF& outScreen, double* outDepth = nullptr) const;
+
+    /** @brief 上次投影中位于屏幕内的实体数量 */
+    int onScreenCount() const { return onScreenCount_; }
+
+    /**
+     * @brief 上次投影得到的可能可见实体（地平线以上且在视锥内）
+     *
+     * 移除实体时只做标记，首次读取时一次性滤掉已移除的实体。
+     */
+    const QVector<GeoEntity*>& visibleEntities() const;
+    /**
+     * @brief 实体在上次投影中是否可能可见
+     *
+     * 尚未投影过时总是返回true，调用方无需区分。
+     */
+    bool isPotentiallyVisible(GeoEntity* entity) const;
+
+    /** @brief 获取上次投影的可见性筛选统计 */
+    CullStats cullStats() const;
+
+private:
+    struct Entry {
+        GeoEntity* entity = nullptr;
+        osg::Vec3d world;
+        QPointF screen;
+        double depth = 0.0;          // 视点空间深度
+        bool onScreen = false;
+        bool potentiallyVisible = false;
+    };
+
+    quint64 cellKey(int cx, int cy) const;
+    void refreshWorld(Entry& entry) const;
+    static bool isBelowHorizon(const osg::Vec3d& scaledEye, double eyeHorizonSq, const osg::Vec3d& world);
+
+    QVector<Entry> entries_;
+    QHash<GeoEntity*, int> entryIndex_;              // 实体 -> entries_下标
+    QHash<quint64, QVector<int>> screenCells_;       // 像素网格 -> entries_下标
+    osg::Matrixd lastProjection_;                    // 上次投影使用的VPW矩阵
+    int lastViewportHeight_ = 0;
+    bool dirty_ = true;
+    int onScreenCount_ = 0;
+
+    mutable QVector<GeoEntity*> visibleEntities_;    // 可能可见实体（紧凑列表）
+    mutable bool visibleStale_ = false;              // 列表中可能含有已移除的实体
+    CullStats cullStats_;
+};
+
+#endif // SCREENPICKBUFFER_H
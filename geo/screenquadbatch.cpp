@@ -0,0 +1,176 @@
+/**
+ * @file screenquadbatch.cpp
+ * @brief 屏幕空间四边形批次实现文件
+ *
+ * 实现ScreenQuadBatch类的所有功能
+ */
+
+#include "screenquadbatch.h"
+#include <osg/NodeCallback>
+#include <osg/Program>
+#include <osg/Uniform>
+#include <osg/VertexAttribDivisor>
+#include <osgUtil/CullVisitor>
+
+namespace {
+
+const unsigned int kAnchorAttrib = 5;
+const unsigned int kRectAttrib = 6;
+const unsigned int kTexRectAttrib = 7;
+
+const char kQuadVertexShader[] =
+    "#version 120\n"
+    "uniform vec2 viewportSize;\n"
+    "attribute vec4 quadAnchor;\n"
+    "attribute vec4 quadRect;\n"
+    "attribute vec4 quadTexRect;\n"
+    "varying vec2 quadTexCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    vec4 clip = gl_ModelViewProjectionMatrix * vec4(quadAnchor.xyz, 1.0);\n"
+    "    vec2 pixel = (quadRect.xy + gl_Vertex.xy * quadRect.zw) * quadAnchor.w;\n"
+    "    clip.xy += pixel * 2.0 / viewportSize * clip.w;\n"
+    "    gl_Position = clip;\n"
+    "    quadTexCoord = mix(quadTexRect.xy, quadTexRect.zw, gl_Vertex.xy);\n"
+    "}\n";
+
+const char kQuadFragmentShader[] =
+    "#version 120\n"
+    "uniform sampler2D quadTexture;\n"
+    "varying vec2 quadTexCoord;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_FragColor = texture2D(quadTexture, quadTexCoord);\n"
+    "}\n";
+
+/**
+ * @brief 每帧把当前视口尺寸写入着色器（像素偏移换算到裁剪空间）
+ */
+class ViewportUniformCallback : public osg::NodeCallback
+{
+public:
+    explicit ViewportUniformCallback(osg::Uniform* uniform) : uniform_(uniform) {}
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+    {
+        osgUtil::CullVisitor* cv = dynamic_cast<osgUtil::CullVisitor*>(nv);
+        if (cv && cv->getViewport()) {
+            uniform_->set(osg::Vec2(cv->getViewport()->width(), cv->getViewport()->height()));
+        }
+        traverse(node, nv);
+    }
+
+private:
+    osg::ref_ptr<osg::Uniform> uniform_;
+};
+
+// 所有批次共用同一个着色器程序
+osg::Program* quadProgram()
+{
+    static osg::ref_ptr<osg::Program> program;
+    if (!program.valid()) {
+        program = new osg::Program;
+        program->setName("ScreenQuadProgram");
+        program->addShader(new osg::Shader(osg::Shader::VERTEX, kQuadVertexShader));
+        program->addShader(new osg::Shader(osg::Shader::FRAGMENT, kQuadFragmentShader));
+        program->addBindAttribLocation("quadAnchor", kAnchorAttrib);
+        program->addBindAttribLocation("quadRect", kRectAttrib);
+        program->addBindAttribLocation("quadTexRect", kTexRectAttrib);
+    }
+    return program.get();
+}
+
+}
+
+ScreenQuadBatch::ScreenQuadBatch(const char* name, osg::Texture2D* texture, int renderBin)
+{
+    osg::ref_ptr<osg::Vec3Array> corners = new osg::Vec3Array;
+    corners->push_back(osg::Vec3(0.0f, 0.0f, 0.0f));
+    corners->push_back(osg::Vec3(1.0f, 0.0f, 0.0f));
+    corners->push_back(osg::Vec3(1.0f, 1.0f, 0.0f));
+    corners->push_back(osg::Vec3(0.0f, 1.0f, 0.0f));
+
+    geometry_ = new osg::Geometry;
+    geometry_->setUseDisplayList(false);
+    geometry_->setUseVertexBufferObjects(true);
+    geometry_->setCullingActive(false);
+    geometry_->setVertexArray(corners.get());
+
+    anchors_ = new osg::Vec4Array;
+    rects_ = new osg::Vec4Array;
+    texRects_ = new osg::Vec4Array;
+    geometry_->setVertexAttribArray(kAnchorAttrib, anchors_.get(), osg::Array::BIND_PER_VERTEX);
+    geometry_->setVertexAttribArray(kRectAttrib, rects_.get(), osg::Array::BIND_PER_VERTEX);
+    geometry_->setVertexAttribArray(kTexRectAttrib, texRects_.get(), osg::Array::BIND_PER_VERTEX);
+    drawArrays_ = new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4, 0);
+    geometry_->addPrimitiveSet(drawArrays_.get());
+
+    osg::ref_ptr<osg::Uniform> viewportUniform = new osg::Uniform("viewportSize", osg::Vec2(1.0f, 1.0f));
+
+    osg::StateSet* stateSet = new osg::StateSet;
+    if (texture) {
+        stateSet->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+    }
+    stateSet->setAttributeAndModes(quadProgram(), osg::StateAttribute::ON);
+    stateSet->addUniform(new osg::Uniform("quadTexture", 0));
+    stateSet->addUniform(viewportUniform.get());
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kAnchorAttrib, 1));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kRectAttrib, 1));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kTexRectAttrib, 1));
+    stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+    stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    stateSet->setMode(GL_BLEND, osg::StateAttribute::ON);
+    stateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+    stateSet->setRenderBinDetails(renderBin, "RenderBin");
+
+    // 实例分布在整个场景中，单位四边形的包围盒没有意义
+    geode_ = new osg::Geode;
+    geode_->setName(name);
+    geode_->setStateSet(stateSet);
+    geode_->setCullingActive(false);
+    geode_->setCullCallback(new ViewportUniformCallback(viewportUniform.get()));
+    geode_->addDrawable(geometry_.get());
+
+    commit();
+}
+
+void ScreenQuadBatch::append(const osg::Vec4& anchor, const osg::Vec4& rect, const osg::Vec4& texRect)
+{
+    anchors_->push_back(anchor);
+    rects_->push_back(rect);
+    texRects_->push_back(texRect);
+}
+
+void ScreenQuadBatch::clear()
+{
+    anchors_->clear();
+    rects_->clear();
+    texRects_->clear();
+}
+
+void ScreenQuadBatch::setTexture(osg::Texture2D* texture)
+{
+    geode_->getStateSet()->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+}
+
+void ScreenQuadBatch::setEnabled(bool enabled)
+{
+    if (enabled_ == enabled) {
+        return;
+    }
+    enabled_ = enabled;
+    commit();
+}
+
+void ScreenQuadBatch::commit()
+{
+    anchors_->dirty();
+    rects_->dirty();
+    texRects_->dirty();
+
+    // DrawArrays的实例数为0时会退化为普通绘制，没有实例时直接隐藏
+    const int count = size();
+    drawArrays_->setNumInstances(count);
+    drawArrays_->dirty();
+    geode_->setNodeMask(count > 0 && enabled_ ? 0xffffffff : 0x0);
+}
@@ -0,0 +1,77 @@
+/**
+ * @file screenquadbatch.h
+ * @brief 屏幕空间四边形批次头文件
+ *
+ * 定义ScreenQuadBatch类，以一次实例化绘制显示锚定在三维位置上、按像素排布的纹理四边形
+ * （标签字符、聚合标记图标等）。
+ */
+
+#ifndef SCREENQUADBATCH_H
+#define SCREENQUADBATCH_H
+
+#include <osg/Array>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/Texture2D>
+
+/**
+ * @ingroup managers
+ * @brief 屏幕空间四边形批次
+ *
+ * 每个实例一个四边形，实例数据保存在按实例步进（divisor = 1）的顶点属性数组中：
+ * - anchor：xyz为锚点（父节点坐标系，通常为图层原点的偏移），w为可见（0时四边形退化）
+ * - rect：相对锚点投影位置的像素矩形（x, y, 宽, 高），y轴向上
+ * - texRect：纹理UV矩形(u0, t0, u1, t1)
+ *
+ * 视口尺寸由剔除回调每帧写入着色器，四边形大小不随缩放变化。调用方直接改写数组后调用commit()。
+ *
+ * - 关闭深度测试，开启混合，在指定渲染层绘制
+ * - 仅在主线程使用
+ */
+class ScreenQuadBatch
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param name 节点名称
+     * @param texture 纹理（可为nullptr，之后通过setTexture设置）
+     * @param renderBin 渲染层序号
+     */
+    ScreenQuadBatch(const char* name, osg::Texture2D* texture, int renderBin);
+
+    /** @brief 批次节点 */
+    osg::Geode* getNode() const { return geode_.get(); }
+
+    osg::Vec4Array* anchors() const { return anchors_.get(); }
+    osg::Vec4Array* rects() const { return rects_.get(); }
+    osg::Vec4Array* texRects() const { return texRects_.get(); }
+
+    /** @brief 实例数 */
+    int size() const { return static_cast<int>(anchors_->size()); }
+
+    /** @brief 追加一个实例 */
+    void append(const osg::Vec4& anchor, const osg::Vec4& rect, const osg::Vec4& texRect);
+    /** @brief 清空实例 */
+    void clear();
+
+    /** @brief 更换纹理（如图集重建后） */
+    void setTexture(osg::Texture2D* texture);
+
+    /** @brief 整体开关（关闭时跳过剔除与绘制） */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled_; }
+
+    /** @brief 标记数组已修改并按数组长度更新实例数 */
+    void commit();
+
+private:
+    osg::ref_ptr<osg::Geode> geode_;
+    osg::ref_ptr<osg::Geometry> geometry_;
+    osg::ref_ptr<osg::Vec4Array> anchors_;
+    osg::ref_ptr<osg::Vec4Array> rects_;
+    osg::ref_ptr<osg::Vec4Array> texRects_;
+    osg::ref_ptr<osg::DrawArrays> drawArrays_;
+    bool enabled_ = true;
+};
+
+#endif // SCREENQUADBATCH_H
@@ -0,0 +1,356 @@
+/**
+ * @file waypointbatchlayer.cpp
+ * @brief 航点批量绘制图层实现文件
+ *
+ * 实现WaypointBatchLayer类的所有功能
+ */
+
+#include "waypointbatchlayer.h"
+#include "waypointentity.h"
+#include "glyphatlas.h"
+#include "geoutils.h"
+#include <osg/VertexAttribDivisor>
+#include <osg/Program>
+#include <QDebug>
+
+namespace {
+
+const unsigned int kDiscPlacementAttrib = 6;
+const unsigned int kDiscStateAttrib = 7;
+
+const float kDiscRadiusMeters = 200.0f;    // 与原CircleNode半径一致
+const int kLabelRenderBin = 100;           // 标签在圆点之后绘制
+
+const char kDiscVertexShader[] =
+    "#version 120\n"
+    "uniform vec3 layerOrigin;\n"
+    "attribute vec4 discPlacement;\n"
+    "attribute vec4 discState;\n"
+    "varying vec2 discCoord;\n"
+    "varying float discHighlight;\n"
+    "void main()\n"
+    "{\n"
+    "    vec3 up = normalize(layerOrigin + discPlacement.xyz);\n"
+    "    vec3 east = cross(vec3(0.0, 0.0, 1.0), up);\n"
+    "    east = length(east) > 1e-6 ? normalize(east) : vec3(1.0, 0.0, 0.0);\n"
+    "    vec3 north = cross(up, east);\n"
+    "    float radius = discPlacement.w * discState.y * (1.0 + 0.5 * discState.x);\n"
+    "    vec3 position = discPlacement.xyz + (east * gl_Vertex.x + north * gl_Vertex.y) * radius;\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vec4(position, 1.0);\n"
+    "    discCoord = gl_Vertex.xy;\n"
+    "    discHighlight = discState.x;\n"
+    "}\n";
+
+// 高亮时半径放大1.5倍，原半径以外绘制白色圆环
+const char kDiscFragmentShader[] =
+    "#version 120\n"
+    "varying vec2 discCoord;\n"
+    "varying float discHighlight;\n"
+    "void main()\n"
+    "{\n"
+    "    float d = length(discCoord);\n"
+    "    if (d > 1.0) discard;\n"
+    "    float r = d * (1.0 + 0.5 * discHighlight);\n"
+    "    gl_FragColor = r > 1.0 ? vec4(1.0, 1.0, 1.0, 1.0) : vec4(1.0, 0.0, 0.0, 1.0);\n"
+    "}\n";
+
+/**
+ * @brief 更新遍历时重建有变化的标签
+ */
+class LabelFlushCallback : public osg::NodeCallback
+{
+public:
+    explicit LabelFlushCallback(WaypointBatchLayer* layer) : layer_(layer) {}
+
+    void detach() { layer_ = nullptr; }
+
+    void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+    {
+        if (layer_) {
+            layer_->flushLabels();
+        }
+        traverse(node, nv);
+    }
+
+private:
+    WaypointBatchLayer* layer_;
+};
+
+osg::ref_ptr<osg::Vec3Array> unitQuad()
+{
+    osg::ref_ptr<osg::Vec3Array> corners = new osg::Vec3Array;
+    corners->push_back(osg::Vec3(-1.0f, -1.0f, 0.0f));
+    corners->push_back(osg::Vec3(1.0f, -1.0f, 0.0f));
+    corners->push_back(osg::Vec3(1.0f, 1.0f, 0.0f));
+    corners->push_back(osg::Vec3(-1.0f, 1.0f, 0.0f));
+    return corners;
+}
+
+}
+
+WaypointBatchLayer::WaypointBatchLayer()
+    : labels_("WaypointLabels", GlyphAtlas::instance().texture(), kLabelRenderBin)
+{
+    root_ = new osg::MatrixTransform;
+    root_->setName("WaypointBatchLayer");
+    updateCallback_ = new LabelFlushCallback(this);
+    root_->setUpdateCallback(updateCallback_.get());
+    originUniform_ = new osg::Uniform("layerOrigin", osg::Vec3(0.0f, 0.0f, 0.0f));
+
+    buildDiscGeometry();
+    root_->addChild(labels_.getNode());
+    updateDrawCounts();
+}
+
+WaypointBatchLayer::~WaypointBatchLayer()
+{
+    // 场景图可能比图层存活更久，断开回调中的回指
+    static_cast<LabelFlushCallback*>(updateCallback_.get())->detach();
+}
+
+void WaypointBatchLayer::buildDiscGeometry()
+{
+    discGeometry_ = new osg::Geometry;
+    discGeometry_->setUseDisplayList(false);
+    discGeometry_->setUseVertexBufferObjects(true);
+    discGeometry_->setCullingActive(false);
+    discGeometry_->setVertexArray(unitQuad().get());
+
+    discPlacements_ = new osg::Vec4Array;
+    discStates_ = new osg::Vec4Array;
+    discGeometry_->setVertexAttribArray(kDiscPlacementAttrib, discPlacements_.get(), osg::Array::BIND_PER_VERTEX);
+    discGeometry_->setVertexAttribArray(kDiscStateAttrib, discStates_.get(), osg::Array::BIND_PER_VERTEX);
+    discDraw_ = new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4, 0);
+    discGeometry_->addPrimitiveSet(discDraw_.get());
+
+    osg::ref_ptr<osg::Program> program = new osg::Program;
+    program->setName("WaypointDiscProgram");
+    program->addShader(new osg::Shader(osg::Shader::VERTEX, kDiscVertexShader));
+    program->addShader(new osg::Shader(osg::Shader::FRAGMENT, kDiscFragmentShader));
+    program->addBindAttribLocation("discPlacement", kDiscPlacementAttrib);
+    program->addBindAttribLocation("discState", kDiscStateAttrib);
+
+    osg::StateSet* stateSet = new osg::StateSet;
+    stateSet->setAttributeAndModes(program.get(), osg::StateAttribute::ON);
+    stateSet->addUniform(originUniform_.get());
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kDiscPlacementAttrib, 1));
+    stateSet->setAttribute(new osg::VertexAttribDivisor(kDiscStateAttrib, 1));
+    stateSet->setMode(GL_DEPTH_TEST, osg::StateAttribute::OFF);
+    stateSet->setMode(GL_LIGHTING, osg::StateAttribute::OFF);
+    stateSet->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+    stateSet->setRenderingHint(osg::StateSet::TRANSPARENT_BIN);
+
+    // 实例分布在整个场景中，单位四边形的包围盒没有意义
+    discGeode_ = new osg::Geode;
+    discGeode_->setName("WaypointDiscs");
+    discGeode_->setStateSet(stateSet);
+    discGeode_->setCullingActive(false);
+    discGeode_->addDrawable(discGeometry_.get());
+    root_->addChild(discGeode_.get());
+}
+
+void WaypointBatchLayer::ensureOrigin(WaypointEntity* waypoint)
+{
+    if (hasOrigin_) {
+        return;
+    }
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    waypoint->getPosition(longitude, latitude, altitude);
+    origin_ = GeoUtils::geoToWorldCoordinates(longitude, latitude, altitude);
+    root_->setMatrix(osg::Matrix::translate(origin_));
+    originUniform_->set(osg::Vec3(origin_));
+    hasOrigin_ = true;
+}
+
+osg::Vec4 WaypointBatchLayer::anchorFor(WaypointEntity* waypoint) const
+{
+    double longitude = 0.0;
+    double latitude = 0.0;
+    double altitude = 0.0;
+    waypoint->getPosition(longitude, latitude, altitude);
+    osg::Vec3d offset = GeoUtils::geoToWorldCoordinates(longitude, latitude, altitude) - origin_;
+    return osg::Vec4(offset.x(), offset.y(), offset.z(), waypoint->isRendered() ? 1.0f : 0.0f);
+}
+
+osg::Vec4 WaypointBatchLayer::labelAnchorFor(WaypointEntity* waypoint) const
+{
+    osg::Vec4 anchor = anchorFor(waypoint);
+    if (!waypoint->isLabelVisible()) {
+        anchor.w() = 0.0f;
+    }
+    return anchor;
+}
+
+void WaypointBatchLayer::addWaypoint(WaypointEntity* waypoint)
+{
+    if (!waypoint) {
+        return;
+    }
+    if (slots_.contains(waypoint)) {
+        updateWaypoint(waypoint);
+        return;
+    }
+
+    ensureOrigin(waypoint);
+
+    Slot slot;
+    slot.index = waypoints_.size();
+    slot.label = waypoint->getOrderLabel();
+    waypoints_.append(waypoint);
+    discPlacements_->push_back(osg::Vec4());
+    discStates_->push_back(osg::Vec4());
+    slots_.insert(waypoint, slot);
+
+    writeDisc(slot.index);
+    labelsDirty_ = true;
+    updateDrawCounts();
+}
+
+void WaypointBatchLayer::updateWaypoint(WaypointEntity* waypoint)
+{
+    auto it = slots_.find(waypoint);
+    if (it == slots_.end()) {
+        return;
+    }
+
+    writeDisc(it->index);
+
+    if (it->label != waypoint->getOrderLabel()) {
+        it->label = waypoint->getOrderLabel();
+        labelsDirty_ = true;
+    } else if (!labelsDirty_) {
+        writeLabelAnchors(it.value(), labelAnchorFor(waypoint));
+    }
+}
+
+void WaypointBatchLayer::writeDisc(int index)
+{
+    WaypointEntity* waypoint = waypoints_.value(index, nullptr);
+    if (!waypoint) {
+        return;
+    }
+    const osg::Vec4 anchor = anchorFor(waypoint);
+    const bool highlighted = waypoint->isSelected() || waypoint->isHovered();
+    (*discPlacements_)[index] = osg::Vec4(anchor.x(), anchor.y(), anchor.z(), kDiscRadiusMeters);
+    (*discStates_)[index] = osg::Vec4(highlighted ? 1.0f : 0.0f, anchor.w(), 0.0f, 0.0f);
+    discPlacements_->dirty();
+    discStates_->dirty();
+    ++slotUpdates_;
+}
+
+void WaypointBatchLayer::writeLabelAnchors(const Slot& slot, const osg::Vec4& anchor)
+{
+    if (slot.glyphCount == 0) {
+        return;
+    }
+    for (int i = slot.firstGlyph; i < slot.firstGlyph + slot.glyphCount; ++i) {
+        (*labels_.anchors())[i] = anchor;
+    }
+    labels_.anchors()->dirty();
+}
+
+void WaypointBatchLayer::removeWaypoint(WaypointEntity* waypoint)
+{
+    auto it = slots_.find(waypoint);
+    if (it == slots_.end()) {
+        return;
+    }
+    const int index = it->index;
+    slots_.erase(it);
+
+    // 用最后一个槽位填补空位
+    const int last = waypoints_.size() - 1;
+    if (index != last) {
+        WaypointEntity* moved = waypoints_[last];
+        waypoints_[index] = moved;
+        (*discPlacements_)[index] = (*discPlacements_)[last];
+        (*discStates_)[index] = (*discStates_)[last];
+        slots_[moved].index = index;
+    }
+    waypoints_.removeLast();
+    discPlacements_->pop_back();
+    discStates_->pop_back();
+    discPlacements_->dirty();
+    discStates_->dirty();
+
+    if (waypoints_.isEmpty()) {
+        hasOrigin_ = false;
+    }
+    labelsDirty_ = true;
+    updateDrawCounts();
+}
+
+void WaypointBatchLayer::clear()
+{
+    waypoints_.clear();
+    slots_.clear();
+    discPlacements_->clear();
+    discStates_->clear();
+    discPlacements_->dirty();
+    discStates_->dirty();
+    hasOrigin_ = false;
+    labelsDirty_ = true;
+    flushLabels();
+    updateDrawCounts();
+}
+
+void WaypointBatchLayer::flushLabels()
+{
+    if (!labelsDirty_) {
+        return;
+    }
+    labelsDirty_ = false;
+    ++labelRebuilds_;
+
+    labels_.clear();
+
+    GlyphAtlas& atlas = GlyphAtlas::instance();
+    const float cellSize = static_cast<float>(GlyphAtlas::kCellSize);
+    const float cellPadding = static_cast<float>(GlyphAtlas::kCellPadding);
+
+    for (WaypointEntity* waypoint : waypoints_) {
+        Slot& slot = slots_[waypoint];
+        slot.firstGlyph = labels_.size();
+        slot.glyphCount = 0;
+
+        const osg::Vec4 anchor = labelAnchorFor(waypoint);
+        float pen = static_cast<float>(kLabelOffsetPixels);
+        for (uint codePoint : slot.label.toUcs4()) {
+            GlyphAtlas::Glyph glyph = atlas.glyph(codePoint);
+            if (!glyph.valid) {
+                continue;
+            }
+            labels_.append(anchor, osg::Vec4(pen - cellPadding, -cellSize * 0.5f, cellSize, cellSize), glyph.uvRect);
+            pen += glyph.advance;
+            ++slot.glyphCount;
+        }
+    }
+
+    labels_.commit();
+}
+
+void WaypointBatchLayer::updateDrawCounts()
+{
+    // DrawArrays的实例数为0时会退化为普通绘制，没有实例时直接隐藏
+    const int discCount = waypoints_.size();
+    discDraw_->setNumInstances(discCount);
+    discDraw_->dirty();
+    discGeode_->setNodeMask(discCount > 0 ? 0xffffffff : 0x0);
+}
+
+void WaypointBatchLayer::setLabelsEnabled(bool enabled)
+{
+    labels_.setEnabled(enabled);
+}
+
+WaypointBatchLayer::Stats WaypointBatchLayer::stats() const
+{
+    Stats result;
+    result.waypointCount = waypoints_.size();
+    result.glyphInstances = labels_.size();
+    result.labelRebuilds = labelRebuilds_;
+    result.slotUpdates = slotUpdates_;
+    return result;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file waypointbatchlayer.h
+ * @brief 航点批量绘制图层头文件
+ *
+ * 定义WaypointBatchLayer类，以一次实例化绘制显示场景中所有航点的圆点，
+ * 另一次实例化绘制显示所有航点的序号标签。
+ */
+
+#ifndef WAYPOINTBATCHLAYER_H
+#define WAYPOINTBATCHLAYER_H
+
+#include <QHash>
+#include <QVector>
+#include <osg/Geode>
+#include <osg/Geometry>
+#include <osg/MatrixTransform>
+#include <osg/NodeCallback>
+#include <osg/Uniform>
+#include <osg/Vec3d>
+#include "screenquadbatch.h"
+
+class WaypointEntity;
+
+/**
+ * @ingroup managers
+ * @brief 航点批量绘制图层（替代每个航点一个CircleNode + PlaceNode）
+ *
+ * - 圆点：单位四边形实例化绘制，在顶点着色器中展开到航点所在位置的切平面上，
+ *   片元着色器裁成圆形（半径与原CircleNode一致，200米），高亮时外加白色圆环
+ * - 标签：每个字符一个ScreenQuadBatch实例，字形来自共享的GlyphAtlas，按像素偏移排布（屏幕固定大小）
+ *
+ * 每个航点占用圆点数组的一个槽位（删除时用最后一个槽位填补）；位置/可见/高亮变化只改写该槽位
+ * 以及其标签字符所在的区间。标签文字变化或航点增删时只标记字形数组需要重建，
+ * 在下一次更新遍历时统一重建一次，批量创建航点不会产生重复重建。
+ *
+ * - 圆点与标签均关闭深度测试（与原样式一致，始终可见）
+ * - 仅在主线程使用
+ */
+class WaypointBatchLayer
+{
+public:
+    /** @brief 图层统计 */
+    struct Stats {
+        int waypointCount = 0;       ///< 航点数
+        int glyphInstances = 0;      ///< 标签字符实例数
+        int labelRebuilds = 0;       ///< 字形数组重建次数
+        quint64 slotUpdates = 0;     ///< 累计槽位改写次数
+    };
+
+    static const int kLabelOffsetPixels = 8;     ///< 标签相对航点的水平偏移（像素）
+
+    WaypointBatchLayer();
+    ~WaypointBatchLayer();
+
+    /** @brief 图层根节点（加入实体组即可） */
+    osg::Node* getNode() const { return root_.get(); }
+
+    /** @brief 加入航点（已存在时刷新） */
+    void addWaypoint(WaypointEntity* waypoint);
+    /** @brief 按航点当前状态改写其槽位（位置、可见、高亮、标签） */
+    void updateWaypoint(WaypointEntity* waypoint);
+    /** @brief 移除航点 */
+    void removeWaypoint(WaypointEntity* waypoint);
+    /** @brief 航点是否由本图层绘制 */
+    bool contains(WaypointEntity* waypoint) const { return slots_.contains(waypoint); }
+    /** @brief 移除所有航点 */
+    void clear();
+
+    /**
+     * @brief 整体开关标签绘制（距离LOD：远距离时跳过标签几何的剔除与绘制）
+     *
+     * 单个航点的标签按WaypointEntity::isLabelVisible()显示。
+     */
+    void setLabelsEnabled(bool enabled);
+    bool labelsEnabled() const { return labels_.isEnabled(); }
+
+    /** @brief 获取图层统计 */
+    Stats stats() const;
+
+    /** @brief 标签需要重建时重建字形实例数组（由根节点的更新回调调用） */
+    void flushLabels();
+
+private:
+    struct Slot {
+        int index = -1;              // 圆点槽位
+        int firstGlyph = 0;          // 标签字符区间起点（字形数组重建后有效）
+        int glyphCount = 0;
+        QString label;               // 构建字形时使用的标签文字
+    };
+
+    void writeDisc(int index);
+    void writeLabelAnchors(const Slot& slot, const osg::Vec4& anchor);
+    osg::Vec4 anchorFor(WaypointEntity* waypoint) const;
+    osg::Vec4 labelAnchorFor(WaypointEntity* waypoint) const;
+    void ensureOrigin(WaypointEntity* waypoint);
+    void updateDrawCounts();
+    void buildDiscGeometry();
+
+    osg::ref_ptr<osg::MatrixTransform> root_;
+    osg::ref_ptr<osg::NodeCallback> updateCallback_;
+    osg::ref_ptr<osg::Uniform> originUniform_;
+    osg::Vec3d origin_;
+    bool hasOrigin_ = false;
+
+    // 圆点
+    osg::ref_ptr<osg::Geode> discGeode_;
+    osg::ref_ptr<osg::Geometry> discGeometry_;
+    osg::ref_ptr<osg::Vec4Array> discPlacements_;
+    osg::ref_ptr<osg::Vec4Array> discStates_;
+    osg::ref_ptr<osg::DrawArrays> discDraw_;
+
+    // 标签
+    ScreenQuadBatch labels_;
+    bool labelsDirty_ = false;
+
+    QVector<WaypointEntity*> waypoints_;          // 圆点槽位 -> 航点
+    QHash<WaypointEntity*, Slot> slots_;
+    int labelRebuilds_ = 0;
+    quint64 slotUpdates_ = 0;
+};
+
+#endif // WAYPOINTBATCHLAYER_H
@@ -6,6 +6,10 @@
  */
 
 #include "waypointentity.h"
+#include "glyphatlas.h"
+#include "waypointbatchlayer.h"
+#include "entitynodepool.h"
+#include <QFontMetricsF>
 #include <osg/ShapeDrawable>
 #include <osg/PositionAttitudeTransform>
 #include <osg/Geometry>
@@ -101,8 +105,30 @@ void WaypointEntity::cleanup()
 
 void WaypointEntity::setOrderLabel(const QString& text)
 {
+    if (labelString_ == text) {
+        return;
+    }
     labelString_ = text;
+    labelWidthPixels_ = QFontMetricsF(GlyphAtlas::labelFont()).horizontalAdvance(labelString_);
     updateLabel();
+    emit labelChanged(labelString_);
+}
+
+QRectF WaypointEntity::labelScreenRect(double metersPerPixel) const
+{
+    Q_UNUSED(metersPerPixel);
+    if (labelString_.isEmpty()) {
+        return QRectF();
+    }
+    const double height = GlyphAtlas::kCellSize;
+    return QRectF(WaypointBatchLayer::kLabelOffsetPixels, -height * 0.5, labelWidthPixels_, height);
+}
+
+void WaypointEntity::onLabelVisibilityChanged(bool visible)
+{
+    if (placeNode_.valid()) {
+        placeNode_->setNodeMask(visible ? 0xffffffff : 0x0);
+    }
 }
 
 /**
@@ -122,6 +148,13 @@ void WaypointEntity::setOrderLabel(const QString& text)
  */
 osg::ref_ptr<osg::Node> WaypointEntity::createNode()
 {
+    if (batched_) {
+        // 圆点和标签由WaypointBatchLayer绘制，这里只保留占位节点供通用逻辑使用
+        osg::ref_ptr<osg::Group> placeholder = EntityNodePool::instance().acquireGroup(entityType_);
+        placeholder->setName("WaypointBatchPlaceholder");
+        return placeholder.get();
+    }
+
     // 仅支持显式绑定 MapNode 的直接创建
     if (!mapNodeRef_.valid()) {
         return nullptr;
@@ -130,8 +163,10 @@ osg::ref_ptr<osg::Node> WaypointEntity::createNode()
     using namespace osgEarth::Symbology;
     using namespace osgEarth::Annotation;
 
+    double longitude = 0.0, latitude = 0.0, altitude = 0.0;
+    getPosition(longitude, latitude, altitude);
     osgEarth::GeoPoint gp(osgEarth::SpatialReference::get("wgs84"),
-                          longitude_, latitude_, altitude_,  // 使用实体的高度属性（默认通过 MapStateConstants::DEFAULT_ALTITUDE_METERS 设置）
+                          longitude, latitude, altitude,  // 使用实体的高度属性（默认通过 MapStateConstants::DEFAULT_ALTITUDE_METERS 设置）
                           osgEarth::ALTMODE_ABSOLUTE);
 
     // 使用 CircleNode 作为“点”（真实地理半径），固定高度，避免地形遮挡
@@ -161,12 +196,13 @@ osg::ref_ptr<osg::Node> WaypointEntity::createNode()
     ts->halo()->color() = Color(0,0,0,0.6);
     placeNode_ = new PlaceNode(gp, labelString_.toStdString(), labelStyle);
     placeNode_->setMapNode(mapNodeRef_.get());
+    placeNode_->setNodeMask(isLabelVisible() ? 0xffffffff : 0x0);
 
 //    osg::ref_ptr<osg::Group> group = new osg::Group();
 //    group->addChild(circle.get());
 //    group->addChild(placeNode_.get());
 //    return group.get();
-    annotationGroup_ = new osg::Group();
+    annotationGroup_ = EntityNodePool::instance().acquireGroup(entityType_);
     annotationGroup_->addChild(circleNode_.get());
     annotationGroup_->addChild(placeNode_.get());
     return annotationGroup_.get();
@@ -193,8 +229,10 @@ void WaypointEntity::updateAnnotationPosition()
         return;
     }
 
+    double longitude = 0.0, latitude = 0.0, altitude = 0.0;
+    getPosition(longitude, latitude, altitude);
     osgEarth::GeoPoint gp(osgEarth::SpatialReference::get("wgs84"),
-                          longitude_, latitude_, altitude_,
+                          longitude, latitude, altitude,
                           osgEarth::ALTMODE_ABSOLUTE);
 
     if (circleNode_.valid()) {
@@ -48,10 +48,28 @@ public:
     // 设置序号标签内容（如 "1"、"2"）
     /** @brief 设置序号标签内容（如 "1"、"2"） */
     void setOrderLabel(const QString& text);
+    /** @brief 序号标签内容 */
+    QString getOrderLabel() const { return labelString_; }
+
+    bool hasLabel() const override { return !labelString_.isEmpty(); }
+    /** @brief 标签矩形：位于航点右侧、垂直居中，宽度按标签字体估算（不随缩放变化） */
+    QRectF labelScreenRect(double metersPerPixel) const override;
     // 设置 MapNode（优先用此绑定，避免运行时查找失败）
     /** @brief 绑定 MapNode（优先使用，避免运行时查找失败） */
     void setMapNode(osgEarth::MapNode* mapNode) { mapNodeRef_ = mapNode; }
 
+    /**
+     * @brief 设置是否由WaypointBatchLayer批量绘制（须在initialize()之前调用）
+     *
+     * 批量绘制时createNode()只返回空的占位节点，不再创建CircleNode/PlaceNode，也不需要MapNode。
+     */
+    void setBatched(bool batched) { batched_ = batched; }
+    bool isBatched() const { return batched_; }
+
+signals:
+    /** @brief 序号标签内容变化 */
+    void labelChanged(const QString& text);
+
 protected:
     // 生命周期回调重写
     /** 
@@ -71,6 +89,9 @@ protected:
      */
     void onBeforeCleanup() override;
 
+    /** @brief 标签显示状态变化：开关PlaceNode（批量绘制时由图层处理） */
+    void onLabelVisibilityChanged(bool visible) override;
+
 private:
     osg::ref_ptr<osg::Node> createNode() override;
     void updateLabel();
@@ -84,11 +105,13 @@ private:
     osg::ref_ptr<osg::Geode> labelGeode_;
     osg::ref_ptr<osgText::Text> labelText_;
     QString labelString_;
+    double labelWidthPixels_ = 0.0;   // 按标签字体估算的标签宽度
     osg::ref_ptr<osgEarth::Annotation::PlaceNode> placeNode_;
     osg::ref_ptr<osgEarth::MapNode> mapNodeRef_;
 
     osg::ref_ptr<osgEarth::Annotation::CircleNode> circleNode_;
     osg::ref_ptr<osg::Group> annotationGroup_;
+    bool batched_ = false;
 
 private:
 };
@@ -0,0 +1,132 @@
+/**
+ * @file plandefinitions.cpp
+ * @brief 方案共享定义实现文件
+ *
+ * 实现PlanDefinitions类的所有功能
+ */
+
+#include "plandefinitions.h"
+#include <QDebug>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonArray>
+
+namespace {
+const char kRefKey[] = "$ref";
+const char kSetKey[] = "$set";
+const char kUnsetKey[] = "$unset";
+
+int compactSize(const QJsonObject& object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact).size();
+}
+}
+
+QStringList PlanDefinitions::sharedFields()
+{
+    return QStringList() << QStringLiteral("modelAssembly") << QStringLiteral("componentConfigs");
+}
+
+QString PlanDefinitions::intern(const QJsonObject& blob)
+{
+    const QByteArray canonical = QJsonDocument(blob).toJson(QJsonDocument::Compact);
+    const QString hash = QString::fromLatin1(QCryptographicHash::hash(canonical, QCryptographicHash::Sha1).toHex());
+    if (!definitions_.contains(hash)) {
+        definitions_.insert(hash, blob);
+    }
+    return hash;
+}
+
+QJsonObject PlanDefinitions::referenceFor(const QString& field, const QString& modelId, const QJsonObject& blob)
+{
+    QJsonObject ref;
+    const QString baseKey = field + QLatin1Char('|') + modelId;
+    auto baseIt = bases_.constFind(baseKey);
+    if (baseIt == bases_.constEnd()) {
+        const QString hash = intern(blob);
+        bases_.insert(baseKey, hash);
+        ref[kRefKey] = hash;
+        return ref;
+    }
+
+    const QJsonObject base = definitions_.value(baseIt.value()).toObject();
+    ref[kRefKey] = baseIt.value();
+    if (base == blob) {
+        return ref;
+    }
+
+    // 与基准逐个顶层键比较
+    QJsonObject set;
+    for (auto it = blob.constBegin(); it != blob.constEnd(); ++it) {
+        if (base.value(it.key()) != it.value()) {
+            set.insert(it.key(), it.value());
+        }
+    }
+    QJsonArray unset;
+    for (auto it = base.constBegin(); it != base.constEnd(); ++it) {
+        if (!blob.contains(it.key())) {
+            unset.append(it.key());
+        }
+    }
+    if (!set.isEmpty()) {
+        ref[kSetKey] = set;
+    }
+    if (!unset.isEmpty()) {
+        ref[kUnsetKey] = unset;
+    }
+
+    // 差异不比完整内容小时，完整内容作为独立定义（相同内容的实体仍然共享）
+    if (compactSize(ref) >= compactSize(blob)) {
+        QJsonObject fullRef;
+        fullRef[kRefKey] = intern(blob);
+        return fullRef;
+    }
+    return ref;
+}
+
+void PlanDefinitions::internEntity(QJsonObject& entity)
+{
+    const QString modelId = entity.value(QStringLiteral("modelId")).toString();
+    for (const QString& field : sharedFields()) {
+        const QJsonValue value = entity.value(field);
+        if (!value.isObject() || value.toObject().isEmpty()) {
+            continue;
+        }
+        entity[field] = referenceFor(field, modelId, value.toObject());
+    }
+}
+
+bool PlanDefinitions::resolveEntity(QJsonObject& entity, const QJsonObject& definitions)
+{
+    bool ok = true;
+    for (const QString& field : sharedFields()) {
+        const QJsonObject value = entity.value(field).toObject();
+        if (!value.contains(kRefKey)) {
+            continue;  // 内联数据（旧版本文件或增量日志）无需还原
+        }
+        const QString hash = value.value(kRefKey).toString();
+        const QJsonValue definition = definitions.value(hash);
+        if (!definition.isObject()) {
+            qDebug() << "方案定义缺失，忽略字段:" << field << "引用:" << hash
+                     << "实体UID:" << entity.value("uid").toString();
+            entity.remove(field);
+            ok = false;
+            continue;
+        }
+        if (!value.contains(kSetKey) && !value.contains(kUnsetKey)) {
+            entity[field] = definition;
+            continue;
+        }
+
+        QJsonObject resolved = definition.toObject();
+        const QJsonObject set = value.value(kSetKey).toObject();
+        for (auto it = set.constBegin(); it != set.constEnd(); ++it) {
+            resolved.insert(it.key(), it.value());
+        }
+        for (const QJsonValue& key : value.value(kUnsetKey).toArray()) {
+            resolved.remove(key.toString());
+        }
+        entity[field] = resolved;
+    }
+    return ok;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file plandefinitions.h
+ * @brief 方案共享定义头文件
+ *
+ * 定义PlanDefinitions类，负责将实体中重复的模型组装、组件配置数据按内容哈希去重，
+ * 保存到方案文件的"definitions"段中。
+ */
+
+#ifndef PLANDEFINITIONS_H
+#define PLANDEFINITIONS_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+#include <QHash>
+
+/**
+ * @brief 方案共享定义表
+ *
+ * 保存时，实体的共享字段（modelAssembly、componentConfigs）被替换为引用
+ * {"$ref":"<内容哈希>"}，内容只在definitions段中保存一次；实体本身只保留
+ * 位置、姿态、名称、行为等实例数据。加载时按引用还原为完整对象，
+ * 还原后的实体共享同一份JSON数据。方案文件仍然完全自包含，不依赖数据库。
+ *
+ * 同一模型（modelId）第一次出现的内容作为该字段的基准定义。之后的实体与基准只有部分
+ * 顶层键不同时，只保存引用与差异：{"$ref":"<基准哈希>","$set":{...},"$unset":[...]}；
+ * 差异不比完整内容小时改为把完整内容作为独立定义引用。
+ *
+ * 内容哈希为紧凑JSON（QJsonObject按键排序，序列化结果唯一）的SHA-1。
+ */
+class PlanDefinitions
+{
+public:
+    /** @brief 需要去重的实体字段 */
+    static QStringList sharedFields();
+
+    /**
+     * @brief 将实体的共享字段替换为引用（必要时附带覆盖字段），并把内容加入定义表
+     * @param entity 实体JSON（原地修改）
+     */
+    void internEntity(QJsonObject& entity);
+
+    /** @brief 定义表的JSON表示（哈希 -> 内容） */
+    QJsonObject toJson() const { return definitions_; }
+
+    /** @brief 定义条目数量 */
+    int size() const { return definitions_.size(); }
+
+    /**
+     * @brief 将实体中的引用还原为完整对象（应用$set/$unset覆盖）
+     * @param entity 实体JSON（原地修改）
+     * @param definitions 方案文件中的definitions段
+     * @return 全部引用都能解析返回true
+     */
+    static bool resolveEntity(QJsonObject& entity, const QJsonObject& definitions);
+
+private:
+    QString intern(const QJsonObject& blob);
+    QJsonObject referenceFor(const QString& field, const QString& modelId, const QJsonObject& blob);
+
+    QJsonObject definitions_;
+    QHash<QString, QString> bases_;      // 字段|modelId -> 基准定义哈希
+};
+
+#endif // PLANDEFINITIONS_H
@@ -6,10 +6,15 @@
  */
 
 #include "planfilemanager.h"
+#include "planjournal.h"
+#include "planformat.h"
+#include "plandefinitions.h"
 #include "../geo/geoentitymanager.h"
 #include "../geo/geoentity.h"
 #include "../geo/waypointentity.h"
+#include "../geo/iconatlas.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include "../ui/ModelAssemblyDialog.h"  // 包含ModelInfo定义
 #include <QDebug>
 #include <QFile>
@@ -24,9 +29,23 @@
 #include <QTimer>
 #include <QtMath>
 #include <QTextStream>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 namespace {
 
+// 异步加载时每批构建的时间预算（毫秒），保证地图渲染不被阻塞
+const qint64 kLoadFrameBudgetMs = 8;
+// 每次批量创建的实体数上限（每块创建后检查时间预算）
+const int kLoadEntityChunk = 64;
+// 同步加载时发出进度信号的间隔（毫秒）
+const qint64 kSyncLoadProgressIntervalMs = 50;
+// 方案文件版本（1.1：共享定义段definitions；1.2：定义引用附带逐字段覆盖$set/$unset）
+const char kPlanFileVersion[] = "1.2";
+// 增量日志记录数超过该值时，下一次保存改为完整保存（压缩）
+const int kJournalCompactRecordCount = 1000;
+
 QJsonArray sanitizeComponentArray(const QJsonArray& array)
 {
     QJsonArray cleanArray;
@@ -47,6 +66,29 @@ QJsonObject sanitizeModelAssembly(const QJsonObject& assembly)
     return result;
 }
 
+// 直线实体带端点航点，需逐个创建
+bool isLineRecord(const PlanEntityRecord& record)
+{
+    return record.json["type"].toString() == QStringLiteral("line");
+}
+
+// 加载记录转换为批量创建描述（图片路径已在解析阶段查询）
+GeoEntityManager::EntityDescriptor entityDescriptor(const PlanEntityRecord& record)
+{
+    const QJsonObject& json = record.json;
+    const QJsonObject position = json["position"].toObject();
+
+    GeoEntityManager::EntityDescriptor descriptor;
+    descriptor.type = json["type"].toString();
+    descriptor.name = json["modelName"].toString();
+    descriptor.imagePath = record.imagePath;
+    descriptor.longitude = position["longitude"].toDouble();
+    descriptor.latitude = position["latitude"].toDouble();
+    descriptor.altitude = position["altitude"].toDouble();
+    descriptor.uid = json["uid"].toString();
+    return descriptor;
+}
+
 }
 
 PlanFileManager::PlanFileManager(GeoEntityManager* entityManager, QObject *parent)
@@ -56,24 +98,48 @@ PlanFileManager::PlanFileManager(GeoEntityManager* entityManager, QObject *paren
     , hasUnsavedChanges_(false)
     , autoSaveEnabled_(false)
     , cancelLoad_(false)
+    , loading_(false)
+    , loadWatcher_(nullptr)
+    , loadBatchTimer_(nullptr)
+    , loadEntityIndex_(0)
+    , loadRouteIndex_(0)
+    , loadTotalSteps_(0)
+    , journalEnabled_(true)
+    , journalStructureDirty_(false)
+    , journalRecordCount_(0)
 {
     if (!entityManager_) {
         qDebug() << "警告: PlanFileManager的entityManager为空，将在后续设置";
+    } else {
+        connectEntityManager();
     }
     
     // 初始化自动保存定时器
     autoSaveTimer_ = new QTimer(this);
     autoSaveTimer_->setSingleShot(true);  // 单次触发
     connect(autoSaveTimer_, &QTimer::timeout, this, [this]() {
+        // 加载期间场景属于新方案而currentPlanFile_仍指向原方案，不能保存
+        if (loading_) {
+            return;
+        }
         if (hasUnsavedChanges_ && !currentPlanFile_.isEmpty()) {
             qDebug() << "自动保存方案文件:" << currentPlanFile_;
-            savePlan();
+            if (journalEnabled_) {
+                saveIncremental();
+            } else {
+                savePlan();
+            }
         }
     });
     
+    // 分批构建定时器：间隔为0，每次事件循环空闲时构建一批，渲染定时器照常触发
+    loadBatchTimer_ = new QTimer(this);
+    loadBatchTimer_->setInterval(0);
+    connect(loadBatchTimer_, &QTimer::timeout, this, &PlanFileManager::onLoadBatchTimeout);
+
     // 连接planDataChanged信号到自动保存定时器
     connect(this, &PlanFileManager::planDataChanged, this, [this]() {
-        if (autoSaveEnabled_ && !currentPlanFile_.isEmpty()) {
+        if (autoSaveEnabled_ && !loading_ && !currentPlanFile_.isEmpty()) {
             // 重启定时器（防抖处理）
             autoSaveTimer_->stop();
             autoSaveTimer_->start();
@@ -83,21 +149,61 @@ PlanFileManager::PlanFileManager(GeoEntityManager* entityManager, QObject *paren
 
 PlanFileManager::~PlanFileManager()
 {
+    // 工作线程持有独立的取消标志，这里只需通知其尽快结束
+    if (parseCancel_) {
+        parseCancel_->store(true);
+    }
 }
 
 void PlanFileManager::requestCancelLoad()
 {
     cancelLoad_.store(true);
+    if (parseCancel_) {
+        parseCancel_->store(true);
+    }
+
+    if (!loading_) {
+        return;
+    }
+
+    // 取消立即生效：解析阶段直接丢弃工作线程的结果，构建阶段立即回滚已创建的实体
+    if (loadWatcher_) {
+        const QString filePath = loadWatcher_->property("filePath").toString();
+        loadWatcher_ = nullptr;
+        loading_ = false;
+        resumeAutoSave();
+        emit loadCancelled();
+        emit loadFinished(filePath, false);
+    } else if (loadBatchTimer_->isActive()) {
+        loadBatchTimer_->stop();
+        const QString filePath = loadData_.filePath;
+        abortBuild();
+        emit loadFinished(filePath, false);
+    }
 }
 
 void PlanFileManager::setEntityManager(GeoEntityManager* entityManager)
 {
+    if (entityManager_ == entityManager) {
+        return;
+    }
+    if (entityManager_) {
+        disconnect(entityManager_, nullptr, this, nullptr);
+    }
     entityManager_ = entityManager;
     if (entityManager_) {
+        connectEntityManager();
         qDebug() << "PlanFileManager: EntityManager已设置";
     }
 }
 
+void PlanFileManager::connectEntityManager()
+{
+    // 批量修改提交时一次性记入增量日志，只发出一次planDataChanged
+    connect(entityManager_, &GeoEntityManager::entitiesChanged,
+            this, &PlanFileManager::updateEntitiesInPlan);
+}
+
 
 QString PlanFileManager::getPlansDirectory()
 {
@@ -129,7 +235,7 @@ bool PlanFileManager::createPlan(const QString& name, const QString& description
 
     // 创建空的方案文件
     QJsonObject planObject;
-    planObject["version"] = "1.0";
+    planObject["version"] = kPlanFileVersion;
 
     QJsonObject metadata;
     metadata["name"] = planName_;
@@ -153,6 +259,9 @@ bool PlanFileManager::createPlan(const QString& name, const QString& description
     file.write(doc.toJson(QJsonDocument::Indented));
     file.close();
 
+    PlanJournal::remove(filePath);
+    resetJournalState();
+
     currentPlanFile_ = filePath;
     emit planFileChanged(currentPlanFile_);
     qDebug() << "方案创建成功:" << currentPlanFile_;
@@ -162,6 +271,11 @@ bool PlanFileManager::createPlan(const QString& name, const QString& description
 
 bool PlanFileManager::savePlan(const QString& filePath)
 {
+    if (loading_) {
+        qDebug() << "方案正在加载中，忽略保存请求";
+        return false;
+    }
+
     QString savePath = filePath.isEmpty() ? currentPlanFile_ : filePath;
     
     if (savePath.isEmpty()) {
@@ -174,8 +288,11 @@ bool PlanFileManager::savePlan(const QString& filePath)
         return false;
     }
 
+    QElapsedTimer saveTimer;
+    saveTimer.start();
+
     QJsonObject planObject;
-    planObject["version"] = "1.0";
+    planObject["version"] = kPlanFileVersion;
 
     // 元数据
     QJsonObject metadata;
@@ -186,8 +303,9 @@ bool PlanFileManager::savePlan(const QString& filePath)
     metadata["coordinateSystem"] = "WGS84";
     planObject["metadata"] = metadata;
 
-    // 实体列表
+    // 实体列表（模型组装、组件配置去重后保存到definitions段）
     QJsonArray entitiesArray;
+    PlanDefinitions definitions;
     QList<GeoEntity*> entities = entityManager_->getAllEntities();
     for (GeoEntity* entity : entities) {
         QJsonObject obj = entityToJson(entity);
@@ -195,9 +313,12 @@ bool PlanFileManager::savePlan(const QString& filePath)
             continue;
         }
         obj["uid"] = entity->getUid(); // 写入实体实例UID
+        definitions.internEntity(obj);
         entitiesArray.append(obj);
     }
+    planObject["definitions"] = definitions.toJson();
     planObject["entities"] = entitiesArray;
+    qDebug() << "方案共享定义:" << definitions.size() << "实体数量:" << entitiesArray.size();
 
     // 保存航线信息（关联到实体的航线）
     QJsonArray routesArray;
@@ -213,7 +334,7 @@ bool PlanFileManager::savePlan(const QString& filePath)
         
         // 更好的方式：遍历当前方案的所有实体，检查其routeGroupId属性
         for (GeoEntity* entity : entities) {
-            QString routeGroupId = entity->getProperty("routeGroupId").toString();
+            QString routeGroupId = entity->getRouteGroupId();
             if (routeGroupId == groupInfo.groupId) {
                 entityUid = entity->getUid();
                 break;
@@ -261,274 +382,388 @@ bool PlanFileManager::savePlan(const QString& filePath)
         planObject["camera"] = QJsonObject();  // 空对象
     }
 
-    // 写入文件
-    QJsonDocument doc(planObject);
-    QFile file(savePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "无法保存方案文件:" << savePath << file.errorString();
+    // 写入文件（格式按文件自动选择；先写临时文件再替换，保证主文件始终完整，之后才删除增量日志）
+    QString errorMessage;
+    if (!PlanFormat::write(savePath, planObject, PlanFormat::formatForSave(savePath), &errorMessage)) {
+        qDebug() << "无法保存方案文件:" << savePath << errorMessage;
         return false;
     }
 
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    // 主文件已包含全部修改，日志可以丢弃
+    PlanJournal::remove(savePath);
+    resetJournalState();
 
     hasUnsavedChanges_ = false;
     emit planSaved(savePath);
-    qDebug() << "方案保存成功:" << savePath;
+    qDebug() << "方案保存成功:" << savePath << "耗时:" << saveTimer.elapsed() << "ms";
 
     return true;
 }
 
 bool PlanFileManager::loadPlan(const QString& filePath)
 {
+    if (loading_) {
+        qDebug() << "方案正在加载中，忽略新的加载请求:" << filePath;
+        return false;
+    }
+    if (!entityManager_) {
+        qDebug() << "EntityManager为空，无法加载方案";
+        return false;
+    }
+
     cancelLoad_.store(false);
+    autoSaveTimer_->stop();
+    emit loadProgress(0, 0, QString::fromUtf8(u8"正在解析方案文件..."));
 
-    if (filePath.isEmpty()) {
-        qDebug() << "方案文件路径为空";
+    PlanLoadData data = PlanLoader::parse(filePath, &cancelLoad_);
+    if (data.cancelled || cancelLoad_.load()) {
+        resumeAutoSave();
+        emit loadCancelled();
         return false;
     }
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "无法打开方案文件:" << filePath << file.errorString();
+    if (!data.ok) {
+        qDebug() << "方案文件加载失败:" << filePath << data.errorMessage;
+        resumeAutoSave();
         return false;
     }
 
-    QByteArray data = file.readAll();
-    file.close();
+    loading_ = true;
+    loadData_ = data;
+    beginBuild();
+    while (!buildNextBatch(kSyncLoadProgressIntervalMs)) {
+        if (cancelLoad_.load()) {
+            abortBuild();
+            return false;
+        }
+    }
+    finishBuild();
+    return true;
+}
 
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        qDebug() << "方案文件JSON解析错误:" << parseError.errorString();
+bool PlanFileManager::loadPlanAsync(const QString& filePath)
+{
+    if (loading_) {
+        qDebug() << "方案正在加载中，忽略新的加载请求:" << filePath;
+        return false;
+    }
+    if (!entityManager_) {
+        qDebug() << "EntityManager为空，无法加载方案";
         return false;
     }
 
-    QJsonObject planObject = doc.object();
+    cancelLoad_.store(false);
+    parseCancel_ = std::make_shared<std::atomic_bool>(false);
+    loading_ = true;
+    // 加载期间不自动保存：待保存的是原方案，而场景即将被新方案替换
+    autoSaveTimer_->stop();
+    emit loadProgress(0, 0, QString::fromUtf8(u8"正在解析方案文件..."));
+
+    // 第一阶段：在工作线程中解析文件并完成数据库查询
+    std::shared_ptr<std::atomic_bool> cancelFlag = parseCancel_;
+    QFutureWatcher<PlanLoadData>* watcher = new QFutureWatcher<PlanLoadData>(this);
+    loadWatcher_ = watcher;
+    connect(watcher, &QFutureWatcher<PlanLoadData>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        if (watcher != loadWatcher_) {
+            // 已被取消的旧请求，结果直接丢弃
+            return;
+        }
+        loadWatcher_ = nullptr;
+        onPlanParsed(watcher->result());
+    });
+    watcher->setProperty("filePath", filePath);
+    watcher->setFuture(QtConcurrent::run([filePath, cancelFlag]() {
+        return PlanLoader::parse(filePath, cancelFlag.get());
+    }));
+    return true;
+}
+
+bool PlanFileManager::isLoading() const
+{
+    return loading_;
+}
 
-    // 检查版本
-    QString version = planObject["version"].toString();
-    if (version != "1.0") {
-        qDebug() << "不支持的方案文件版本:" << version;
-        // 可以添加版本转换逻辑
+void PlanFileManager::onPlanParsed(const PlanLoadData& data)
+{
+    if (data.cancelled || cancelLoad_.load()) {
+        loading_ = false;
+        resumeAutoSave();
+        emit loadCancelled();
+        emit loadFinished(data.filePath, false);
+        return;
+    }
+    if (!data.ok) {
+        qDebug() << "方案文件加载失败:" << data.filePath << data.errorMessage;
+        loading_ = false;
+        resumeAutoSave();
+        emit loadFinished(data.filePath, false);
+        return;
     }
 
-    // 读取元数据
-    QJsonObject metadata = planObject["metadata"].toObject();
-    planName_ = metadata["name"].toString();
-    planDescription_ = metadata["description"].toString();
-    QString createTimeStr = metadata["createTime"].toString();
-    createTime_ = QDateTime::fromString(createTimeStr, Qt::ISODate);
+    // 第二阶段：在主线程中分批创建节点，每批不超过一帧的时间预算
+    loadData_ = data;
+    beginBuild();
+    loadBatchTimer_->start();
+}
 
-    if (!entityManager_) {
-        qDebug() << "EntityManager为空，无法加载方案";
-        return false;
+void PlanFileManager::onLoadBatchTimeout()
+{
+    if (cancelLoad_.load()) {
+        loadBatchTimer_->stop();
+        abortBuild();
+        emit loadFinished(loadData_.filePath, false);
+        return;
     }
 
-    QJsonArray entitiesArray = planObject["entities"].toArray();
-    QJsonArray routesArray = planObject["routes"].toArray();
+    if (buildNextBatch(kLoadFrameBudgetMs)) {
+        loadBatchTimer_->stop();
+        const QString filePath = loadData_.filePath;
+        finishBuild();
+        emit loadFinished(filePath, true);
+    }
+}
 
-    int totalSteps = qMax(1, entitiesArray.size() + routesArray.size() + 1);
-    int currentStep = 0;
+void PlanFileManager::beginBuild()
+{
+    loadEntityIndex_ = 0;
+    loadRouteIndex_ = 0;
+    loadTotalSteps_ = qMax(1, loadData_.entities.size() + loadData_.routes.size() + 1);
+
+    emit loadProgress(0, loadTotalSteps_, QString::fromUtf8(u8"正在清理当前场景..."));
 
-    emit loadProgress(currentStep, totalSteps, QString::fromUtf8(u8"正在清理当前场景..."));
+    planName_ = loadData_.name;
+    planDescription_ = loadData_.description;
+    createTime_ = loadData_.createTime;
 
     entityManager_->clearAllEntities();
+    // 加载在主线程的渲染之外进行，立即回收，使旧实体的节点归还节点池供新实体复用
     entityManager_->processPendingDeletions();
 
-    // 加载实体
+    // 方案使用的图标一次性加入图集，避免逐个创建实体时反复重新打包
+    QStringList iconPaths;
+    for (const PlanEntityRecord& record : loadData_.entities) {
+        if (!record.imagePath.isEmpty()) {
+            iconPaths.append(record.imagePath);
+        }
+    }
+    IconAtlas::instance().ensureIcons(iconPaths);
+
     entityCounter_ = 0;
-    for (int i = 0; i < entitiesArray.size(); ++i) {
+}
+
+bool PlanFileManager::buildNextBatch(qint64 budgetMs)
+{
+    QElapsedTimer batchTimer;
+    batchTimer.start();
+
+    const int entityCount = loadData_.entities.size();
+    const int routeCount = loadData_.routes.size();
+    QString message;
+
+    // 本批创建的实体在构造后还会写入多项属性，变化通知合并到本批结束时一次发出
+    GeoEntityManager::EntityBatch entityBatch(entityManager_);
+
+    while (loadEntityIndex_ < entityCount || loadRouteIndex_ < routeCount) {
         if (cancelLoad_.load()) {
-            emit loadCancelled();
-            entityManager_->clearAllEntities();
-            entityManager_->processPendingDeletions();
             return false;
         }
-        const auto& entityValue = entitiesArray.at(i);
-        QJsonObject entityObj = entityValue.toObject();
-        QString entityName = entityObj["name"].toString();
-        if (entityName.isEmpty()) {
-            entityName = entityObj["modelName"].toString();
-        }
-        emit loadProgress(currentStep, totalSteps,
-                          QString::fromUtf8(u8"加载实体 %1/%2：%3")
-                              .arg(i + 1)
-                              .arg(entitiesArray.size())
-                              .arg(entityName));
-        GeoEntity* entity = jsonToEntity(entityObj);
-        if (entity) {
-            entity->setProperty("modelId", entityObj["modelId"].toString());
-
-            // 保存模型组装和组件配置覆盖到entity属性中
-            if (entityObj.contains("modelAssembly")) {
-                QJsonObject modelAssembly = sanitizeModelAssembly(entityObj["modelAssembly"].toObject());
-                entity->setProperty("modelAssembly", modelAssembly);
+
+        if (loadEntityIndex_ < entityCount) {
+            // 连续的图片/航点实体按块批量创建，直线实体（带端点航点）逐个创建
+            int chunkEnd = loadEntityIndex_;
+            while (chunkEnd < entityCount && chunkEnd - loadEntityIndex_ < kLoadEntityChunk
+                   && !isLineRecord(loadData_.entities.at(chunkEnd))) {
+                ++chunkEnd;
             }
-            if (entityObj.contains("componentConfigs")) {
-                QJsonObject componentConfigs = entityObj["componentConfigs"].toObject();
-                entity->setProperty("componentConfigs", componentConfigs);
+            if (chunkEnd > loadEntityIndex_) {
+                buildEntities(loadEntityIndex_, chunkEnd - loadEntityIndex_);
+                loadEntityIndex_ = chunkEnd;
+            } else {
+                buildEntity(loadData_.entities.at(loadEntityIndex_));
+                ++loadEntityIndex_;
             }
+            message = QString::fromUtf8(u8"加载实体 %1/%2：%3")
+                          .arg(loadEntityIndex_)
+                          .arg(entityCount)
+                          .arg(loadData_.entities.at(loadEntityIndex_ - 1).displayName);
+        } else {
+            const PlanRouteRecord& record = loadData_.routes.at(loadRouteIndex_);
+            buildRoute(record);
+            ++loadRouteIndex_;
+            message = QString::fromUtf8(u8"加载航线 %1/%2：%3")
+                          .arg(loadRouteIndex_)
+                          .arg(routeCount)
+                          .arg(record.groupId);
         }
-        ++currentStep;
-        emit loadProgress(currentStep, totalSteps,
-                          QString::fromUtf8(u8"实体加载进度 %1/%2")
-                              .arg(i + 1)
-                              .arg(entitiesArray.size()));
-    }
 
-    // 加载航线信息
-    for (int i = 0; i < routesArray.size(); ++i) {
-        if (cancelLoad_.load()) {
-            emit loadCancelled();
-            entityManager_->clearAllEntities();
-            entityManager_->processPendingDeletions();
-            return false;
+        if (budgetMs >= 0 && batchTimer.elapsed() >= budgetMs) {
+            break;
         }
-        const auto& routeValue = routesArray.at(i);
-        QJsonObject routeObj = routeValue.toObject();
-        QString groupId = routeObj["groupId"].toString();
-        QString targetUid = routeObj["targetUid"].toString();
-
-        emit loadProgress(currentStep, totalSteps,
-                          QString::fromUtf8(u8"加载航线 %1/%2：%3")
-                              .arg(i + 1)
-                              .arg(routesArray.size())
-                              .arg(groupId));
-
-        // 查找对应的实体（通过稳定UID）
-        GeoEntity* entity = entityManager_->getEntityByUid(targetUid);
+    }
+
+    emit loadProgress(loadEntityIndex_ + loadRouteIndex_, loadTotalSteps_, message);
+    return loadEntityIndex_ >= entityCount && loadRouteIndex_ >= routeCount;
+}
+
+void PlanFileManager::buildEntity(const PlanEntityRecord& record)
+{
+    GeoEntity* entity = jsonToEntity(record);
+    if (!entity) {
+        return;
+    }
+    applyRecordOverrides(entity, record);
+}
+
+void PlanFileManager::buildEntities(int first, int count)
+{
+    QVector<GeoEntityManager::EntityDescriptor> descriptors;
+    descriptors.reserve(count);
+    for (int i = first; i < first + count; ++i) {
+        descriptors.append(entityDescriptor(loadData_.entities.at(i)));
+    }
+
+    const QVector<GeoEntity*> entities = entityManager_->createEntities(descriptors);
+    for (int i = 0; i < entities.size(); ++i) {
+        GeoEntity* entity = entities.at(i);
         if (!entity) {
-            qDebug() << "加载航线失败：找不到实体UID" << targetUid;
             continue;
         }
+        const PlanEntityRecord& record = loadData_.entities.at(first + i);
+        applyEntityRecord(entity, record);
+        applyRecordOverrides(entity, record);
+    }
+}
 
-        // 创建航点组
-        QString newGroupId = entityManager_->createWaypointGroup(routeObj["name"].toString());
-
-        QJsonArray waypointUidArray = routeObj["waypointUids"].toArray();
-        if (!waypointUidArray.isEmpty()) {
-            for (const QJsonValue& value : waypointUidArray) {
-                QString waypointUid = value.toString();
-                GeoEntity* waypointEntity = entityManager_->getEntityByUid(waypointUid);
-                WaypointEntity* waypoint = qobject_cast<WaypointEntity*>(waypointEntity);
-                if (!waypoint) {
-                    qDebug() << "加载航线警告：waypointUid 未找到对应航点" << waypointUid;
-                    continue;
-                }
-                entityManager_->attachWaypointToGroup(newGroupId, waypoint);
-            }
-        } else {
-            // 兼容旧格式：直接使用坐标重建航点
-            QJsonArray waypointsArray = routeObj["waypoints"].toArray();
-            for (const auto& wpValue : waypointsArray) {
-                QJsonObject wpObj = wpValue.toObject();
-                double lon = wpObj["longitude"].toDouble();
-                double lat = wpObj["latitude"].toDouble();
-                double alt = wpObj["altitude"].toDouble();
-                entityManager_->addWaypointToGroup(newGroupId, lon, lat, alt);
-            }
-        }
+void PlanFileManager::applyRecordOverrides(GeoEntity* entity, const PlanEntityRecord& record)
+{
+    const QJsonObject& entityObj = record.json;
+    entity->setProperty("modelId", entityObj["modelId"].toString());
 
-        // 绑定航线到实体（使用uid作为统一标识符）
-        entityManager_->bindRouteToEntity(newGroupId, entity->getUid());
+    // 保存模型组装和组件配置覆盖到entity属性中
+    if (entityObj.contains("modelAssembly")) {
+        QJsonObject modelAssembly = sanitizeModelAssembly(entityObj["modelAssembly"].toObject());
+        entity->setProperty("modelAssembly", modelAssembly);
+    }
+    if (entityObj.contains("componentConfigs")) {
+        QJsonObject componentConfigs = entityObj["componentConfigs"].toObject();
+        entity->setProperty("componentConfigs", componentConfigs);
+    }
+}
 
-        // 保存航线组ID到实体属性
-        entity->setProperty("routeGroupId", newGroupId);
+void PlanFileManager::buildRoute(const PlanRouteRecord& record)
+{
+    const QJsonObject& routeObj = record.json;
+    const QString& groupId = record.groupId;
+    const QString& targetUid = record.targetUid;
+
+    // 查找对应的实体（通过稳定UID）
+    GeoEntity* entity = entityManager_->getEntityByUid(targetUid);
+    if (!entity) {
+        qDebug() << "加载航线失败：找不到实体UID" << targetUid;
+        return;
+    }
 
-        QString routeType = entity->getProperty("routeType").toString();
-        if (routeType.isEmpty() && routeObj.contains("routeType")) {
-            routeType = routeObj["routeType"].toString();
+    // 创建航点组
+    QString newGroupId = entityManager_->createWaypointGroup(routeObj["name"].toString());
+
+    QJsonArray waypointUidArray = routeObj["waypointUids"].toArray();
+    if (!waypointUidArray.isEmpty()) {
+        for (const QJsonValue& value : waypointUidArray) {
+            QString waypointUid = value.toString();
+            GeoEntity* waypointEntity = entityManager_->getEntityByUid(waypointUid);
+            WaypointEntity* waypoint = qobject_cast<WaypointEntity*>(waypointEntity);
+            if (!waypoint) {
+                qDebug() << "加载航线警告：waypointUid 未找到对应航点" << waypointUid;
+                continue;
+            }
+            entityManager_->attachWaypointToGroup(newGroupId, waypoint);
         }
-        if (routeType.isEmpty()) {
-            routeType = QStringLiteral("linear");
+    } else {
+        // 兼容旧格式：直接使用坐标重建航点
+        QJsonArray waypointsArray = routeObj["waypoints"].toArray();
+        for (const auto& wpValue : waypointsArray) {
+            QJsonObject wpObj = wpValue.toObject();
+            double lon = wpObj["longitude"].toDouble();
+            double lat = wpObj["latitude"].toDouble();
+            double alt = wpObj["altitude"].toDouble();
+            entityManager_->addWaypointToGroup(newGroupId, lon, lat, alt);
         }
-        entity->setProperty("routeType", routeType);
+    }
 
-        // 如果航点数量>=2，生成路线
-        auto groupInfo = entityManager_->getWaypointGroup(newGroupId);
-        if (groupInfo.waypoints.size() >= 2) {
-            entityManager_->generateRouteForGroup(newGroupId, routeType);
-            groupInfo = entityManager_->getWaypointGroup(newGroupId);
-        }
+    // 绑定航线到实体（使用uid作为统一标识符）
+    entityManager_->bindRouteToEntity(newGroupId, entity->getUid());
 
-        qDebug() << "加载航线成功:" << groupId << "->" << newGroupId << "实体UID:" << targetUid << "航点数:" << groupInfo.waypoints.size();
+    // 保存航线组ID到实体属性
+    entity->setProperty("routeGroupId", newGroupId);
 
-        ++currentStep;
-        emit loadProgress(currentStep, totalSteps,
-                          QString::fromUtf8(u8"航线加载进度 %1/%2")
-                              .arg(i + 1)
-                              .arg(routesArray.size()));
+    QString routeType = entity->getProperty("routeType").toString();
+    if (routeType.isEmpty() && routeObj.contains("routeType")) {
+        routeType = routeObj["routeType"].toString();
     }
-    
-    // 加载相机视角
-    emit loadProgress(currentStep, totalSteps, QString::fromUtf8(u8"恢复相机视角..."));
-    if (planObject.contains("camera")) {
-        if (cancelLoad_.load()) {
-            emit loadCancelled();
-            entityManager_->clearAllEntities();
-            entityManager_->processPendingDeletions();
-            return false;
-        }
-        QJsonObject camera = planObject["camera"].toObject();
-        if (!camera.isEmpty()) {
-            double lon = camera["longitude"].toDouble();
-            double lat = camera["latitude"].toDouble();
-            double alt = camera["altitude"].toDouble();
-            double heading = camera["heading"].toDouble();
-            double pitch = camera["pitch"].toDouble();
-            double range = camera["range"].toDouble();
-            
-            // 验证数据的有效性
-            bool isValid = true;
-            // 检查是否为NaN或无穷大
-            if (qIsNaN(lon) || qIsInf(lon) || qIsNaN(lat) || qIsInf(lat) || 
-                qIsNaN(alt) || qIsInf(alt) || qIsNaN(heading) || qIsInf(heading) ||
-                qIsNaN(pitch) || qIsInf(pitch) || qIsNaN(range) || qIsInf(range)) {
-                isValid = false;
-                qDebug() << "相机视角数据包含NaN或Inf，忽略";
-            }
-            // 检查经纬度范围
-            if (isValid && (lon < -180.0 || lon > 180.0 || lat < -90.0 || lat > 90.0)) {
-                isValid = false;
-                qDebug() << "相机视角经纬度超出有效范围，忽略";
-            }
-            // 检查距离和高度是否合理（避免异常大的值）
-            if (isValid && (range < 0.0 || range > 1e8 || alt < -10000.0 || alt > 1e7)) {
-                isValid = false;
-                qDebug() << "相机视角距离或高度超出合理范围，忽略";
-            }
-            
-            if (isValid) {
-                hasCameraViewpoint_ = true;
-                cameraLongitude_ = lon;
-                cameraLatitude_ = lat;
-                cameraAltitude_ = alt;
-                cameraHeading_ = heading;
-                cameraPitch_ = pitch;
-                cameraRange_ = range;
-                qDebug() << "加载相机视角:" << cameraLongitude_ << cameraLatitude_ << cameraRange_;
-            } else {
-                hasCameraViewpoint_ = false;
-                qDebug() << "相机视角数据无效，已忽略";
-            }
-        } else {
-            hasCameraViewpoint_ = false;
-        }
-    } else {
-        hasCameraViewpoint_ = false;
+    if (routeType.isEmpty()) {
+        routeType = QStringLiteral("linear");
     }
+    entity->setProperty("routeType", routeType);
 
-    ++currentStep;
+    // 如果航点数量>=2，生成路线
+    auto groupInfo = entityManager_->getWaypointGroup(newGroupId);
+    if (groupInfo.waypoints.size() >= 2) {
+        entityManager_->generateRouteForGroup(newGroupId, routeType);
+        groupInfo = entityManager_->getWaypointGroup(newGroupId);
+    }
+
+    qDebug() << "加载航线成功:" << groupId << "->" << newGroupId << "实体UID:" << targetUid << "航点数:" << groupInfo.waypoints.size();
+}
+
+void PlanFileManager::finishBuild()
+{
+    // 加载相机视角（已在解析阶段校验）
+    emit loadProgress(loadTotalSteps_ - 1, loadTotalSteps_, QString::fromUtf8(u8"恢复相机视角..."));
+    hasCameraViewpoint_ = loadData_.hasCamera;
+    if (hasCameraViewpoint_) {
+        cameraLongitude_ = loadData_.cameraLongitude;
+        cameraLatitude_ = loadData_.cameraLatitude;
+        cameraAltitude_ = loadData_.cameraAltitude;
+        cameraHeading_ = loadData_.cameraHeading;
+        cameraPitch_ = loadData_.cameraPitch;
+        cameraRange_ = loadData_.cameraRange;
+        qDebug() << "加载相机视角:" << cameraLongitude_ << cameraLatitude_ << cameraRange_;
+    }
+
+    const QString filePath = loadData_.filePath;
+    const int entityCount = loadData_.entities.size();
+    resetJournalState();
+    journalRecordCount_ = loadData_.journalRecordCount;
+    loadData_ = PlanLoadData();
+    loading_ = false;
 
     currentPlanFile_ = filePath;
     hasUnsavedChanges_ = false;
     emit planLoaded(filePath);
-    qDebug() << "方案加载成功:" << filePath << "实体数量:" << entitiesArray.size();
+    qDebug() << "方案加载成功:" << filePath << "实体数量:" << entityCount;
 
-    emit loadProgress(totalSteps, totalSteps, QString::fromUtf8(u8"方案加载完成"));
+    emit loadProgress(loadTotalSteps_, loadTotalSteps_, QString::fromUtf8(u8"方案加载完成"));
+}
 
-    return true;
+void PlanFileManager::abortBuild()
+{
+    loadData_ = PlanLoadData();
+    loading_ = false;
+    emit loadCancelled();
+    entityManager_->clearAllEntities();
+    entityManager_->processPendingDeletions();
+
+    // 原方案的场景已被清空：解除关联，之后的保存不会用空场景覆盖原方案文件或日志
+    resetJournalState();
+    hasUnsavedChanges_ = false;
+    setCurrentPlanFile(QString());
+}
+
+void PlanFileManager::resumeAutoSave()
+{
+    if (autoSaveEnabled_ && hasUnsavedChanges_ && !currentPlanFile_.isEmpty()) {
+        autoSaveTimer_->start();
+    }
 }
 
 QString PlanFileManager::getCurrentPlanFile() const
@@ -555,6 +790,8 @@ void PlanFileManager::addEntityToPlan(GeoEntity* entity)
         return;
     }
 
+    journalRemovedUids_.remove(entity->getUid());
+    journalDirtyUids_.insert(entity->getUid());
     hasUnsavedChanges_ = true;
     emit planDataChanged();
     qDebug() << "实体已添加到方案:" << entity->getUid();
@@ -566,7 +803,14 @@ void PlanFileManager::removeEntityFromPlan(const QString& uid)
         return;
     }
 
-    Q_UNUSED(uid);
+    // 删除带航线的实体会同时影响航线，无法只用实体日志表达
+    GeoEntity* entity = entityManager_ ? entityManager_->getEntityByUid(uid) : nullptr;
+    if (entity && !entity->getRouteGroupId().isEmpty()) {
+        journalStructureDirty_ = true;
+    }
+
+    journalDirtyUids_.remove(uid);
+    journalRemovedUids_.insert(uid);
     hasUnsavedChanges_ = true;
     emit planDataChanged();
     qDebug() << "实体已从方案中移除:" << uid;
@@ -578,13 +822,28 @@ void PlanFileManager::updateEntityInPlan(GeoEntity* entity)
         return;
     }
 
-    if (currentPlanFile_.isEmpty()) {
+    updateEntitiesInPlan(QStringList{entity->getUid()});
+}
+
+void PlanFileManager::updateEntitiesInPlan(const QStringList& uids)
+{
+    // 加载期间的批量提交来自新方案的构建，不是对当前方案的修改
+    if (loading_ || uids.isEmpty() || currentPlanFile_.isEmpty()) {
         return;
     }
 
+    for (const QString& uid : uids) {
+        if (!journalRemovedUids_.contains(uid)) {
+            journalDirtyUids_.insert(uid);
+        }
+    }
     hasUnsavedChanges_ = true;
     emit planDataChanged();
-    qDebug() << "方案中的实体已更新:" << entity->getUid();
+    if (uids.size() == 1) {
+        qDebug() << "方案中的实体已更新:" << uids.first();
+    } else {
+        qDebug() << "方案中的实体已批量更新:" << uids.size() << "个";
+    }
 }
 
 void PlanFileManager::markPlanModified()
@@ -592,10 +851,92 @@ void PlanFileManager::markPlanModified()
     if (currentPlanFile_.isEmpty()) {
         return;
     }
+    journalStructureDirty_ = true;
     hasUnsavedChanges_ = true;
     emit planDataChanged();
 }
 
+bool PlanFileManager::saveIncremental()
+{
+    if (loading_) {
+        qDebug() << "方案正在加载中，忽略保存请求";
+        return false;
+    }
+    if (currentPlanFile_.isEmpty()) {
+        qDebug() << "没有指定方案文件路径";
+        return false;
+    }
+    if (!entityManager_) {
+        qDebug() << "EntityManager为空，无法保存方案";
+        return false;
+    }
+    if (!hasUnsavedChanges_) {
+        return true;
+    }
+
+    const int pendingCount = journalDirtyUids_.size() + journalRemovedUids_.size();
+    if (journalStructureDirty_ || !QFile::exists(currentPlanFile_) ||
+        journalRecordCount_ + pendingCount > kJournalCompactRecordCount) {
+        qDebug() << "增量日志压缩，完整保存方案文件:" << currentPlanFile_
+                 << "日志记录数:" << journalRecordCount_ << "待写入:" << pendingCount;
+        return savePlan();
+    }
+
+    QElapsedTimer saveTimer;
+    saveTimer.start();
+
+    QVector<QJsonObject> records;
+    records.reserve(pendingCount);
+    for (const QString& uid : journalRemovedUids_) {
+        records.append(PlanJournal::removeRecord(uid));
+    }
+    for (const QString& uid : journalDirtyUids_) {
+        GeoEntity* entity = entityManager_->getEntityByUid(uid);
+        if (!entity) {
+            continue;
+        }
+        QJsonObject obj = entityToJson(entity);
+        if (obj.isEmpty()) {
+            continue;
+        }
+        obj["uid"] = uid;
+        records.append(PlanJournal::upsertRecord(obj));
+    }
+
+    if (!records.isEmpty() && !PlanJournal::append(currentPlanFile_, records)) {
+        qDebug() << "增量日志写入失败，改为完整保存";
+        return savePlan();
+    }
+
+    journalRecordCount_ += records.size();
+    journalDirtyUids_.clear();
+    journalRemovedUids_.clear();
+
+    hasUnsavedChanges_ = false;
+    emit planSaved(currentPlanFile_);
+    qDebug() << "方案增量保存成功:" << currentPlanFile_ << "记录数:" << records.size()
+             << "耗时:" << saveTimer.elapsed() << "ms";
+    return true;
+}
+
+void PlanFileManager::setJournalEnabled(bool enabled)
+{
+    journalEnabled_ = enabled;
+}
+
+bool PlanFileManager::isJournalEnabled() const
+{
+    return journalEnabled_;
+}
+
+void PlanFileManager::resetJournalState()
+{
+    journalDirtyUids_.clear();
+    journalRemovedUids_.clear();
+    journalStructureDirty_ = false;
+    journalRecordCount_ = 0;
+}
+
 bool PlanFileManager::hasUnsavedChanges() const
 {
     return hasUnsavedChanges_;
@@ -626,7 +967,7 @@ QJsonObject PlanFileManager::entityToJson(GeoEntity* entity)
     QString displayName = entity->getProperty("displayName").toString();
     entityObj["name"] = displayName.isEmpty() ? entity->getName() : displayName;
     entityObj["type"] = entity->getType();
-    entityObj["modelId"] = entity->getProperty("modelId").toString();
+    entityObj["modelId"] = entity->getModelId();
     entityObj["modelName"] = entity->getName();  // 模型名称
 
     // 规划属性：位置
@@ -688,7 +1029,7 @@ QJsonObject PlanFileManager::entityToJson(GeoEntity* entity)
         entityObj["modelAssembly"] = modelAssembly;
     } else {
         // 兼容旧格式：如果没有components数组，尝试从数据库加载并保存完整信息
-        QString modelId = entity->getProperty("modelId").toString();
+        QString modelId = entity->getModelId();
         QJsonObject dbModelAssembly = getModelAssemblyFromDatabase(modelId);
         
         QJsonObject modelAssembly;
@@ -764,14 +1105,14 @@ QJsonObject PlanFileManager::entityToJson(GeoEntity* entity)
  * @param json JSON对象，包含实体的完整信息
  * @return 创建的实体指针，失败返回nullptr
  */
-GeoEntity* PlanFileManager::jsonToEntity(const QJsonObject& json)
+GeoEntity* PlanFileManager::jsonToEntity(const PlanEntityRecord& record)
 {
+    const QJsonObject& json = record.json;
     if (!entityManager_) {
         qDebug() << "EntityManager为空，无法创建实体";
         return nullptr;
     }
 
-    QString modelId = json["modelId"].toString();
     QString modelName = json["modelName"].toString();
 
     // 获取位置信息
@@ -824,13 +1165,17 @@ GeoEntity* PlanFileManager::jsonToEntity(const QJsonObject& json)
         return lineEntity;
     }
 
-    // 创建实体
+    // 创建实体（图片路径已在解析阶段查询，避免主线程访问数据库）
+    QJsonObject createProperties;
+    if (!record.imagePath.isEmpty()) {
+        createProperties["imagePath"] = record.imagePath;
+    }
     QString uidOverride = json["uid"].toString();
     GeoEntity* entity = entityManager_->createEntity(
 //        json["type"].toString(),
         type,
         modelName,
-        QJsonObject(),  // properties会在后面设置
+        createProperties,  // 其余properties会在后面设置
         longitude,
         latitude,
         altitude,
@@ -838,70 +1183,71 @@ GeoEntity* PlanFileManager::jsonToEntity(const QJsonObject& json)
     );
 
     if (entity) {
-        // 设置规划属性
-        if (json.contains("heading")) {
-            entity->setHeading(json["heading"].toDouble());
-        }
-        if (json.contains("visible")) {
-            entity->setVisible(json["visible"].toBool());
-        }
-        if (json.contains("name")) {
-            entity->setProperty("displayName", json["name"].toString());
-        }
-        if (json.contains("routeType")) {
-            entity->setProperty("routeType", json["routeType"].toString());
-        }
+        applyEntityRecord(entity, record);
+    }
 
-        // 设置模型ID
-        entity->setProperty("modelId", modelId);
+    return entity;
+}
+
+void PlanFileManager::applyEntityRecord(GeoEntity* entity, const PlanEntityRecord& record)
+{
+    const QJsonObject& json = record.json;
+    const QString modelId = json["modelId"].toString();
+
+    // 设置规划属性
+    if (json.contains("heading")) {
+        entity->setHeading(json["heading"].toDouble());
+    }
+    if (json.contains("visible")) {
+        entity->setVisible(json["visible"].toBool());
+    }
+    if (json.contains("name")) {
+        entity->setProperty("displayName", json["name"].toString());
+    }
+    if (json.contains("routeType")) {
+        entity->setProperty("routeType", json["routeType"].toString());
+    }
+
+    // 设置模型ID
+    entity->setProperty("modelId", modelId);
+    
+    // 从JSON文件加载完整的模型组装信息（不再依赖数据库）
+    QJsonObject modelAssemblyObj;
+    if (json.contains("modelAssembly")) {
+        QJsonObject jsonModelAssembly = json["modelAssembly"].toObject();
         
-        // 从JSON文件加载完整的模型组装信息（不再依赖数据库）
-        QJsonObject modelAssemblyObj;
-        if (json.contains("modelAssembly")) {
-            QJsonObject jsonModelAssembly = json["modelAssembly"].toObject();
-            
-            // 直接复制完整的组件信息数组
-            if (jsonModelAssembly.contains("components")) {
-                modelAssemblyObj["components"] = jsonModelAssembly["components"];
-            }
-            
-            // 复制location和icon
-            if (jsonModelAssembly.contains("location")) {
-                modelAssemblyObj["location"] = jsonModelAssembly["location"];
-            }
-            if (jsonModelAssembly.contains("icon")) {
-                modelAssemblyObj["icon"] = jsonModelAssembly["icon"];
-            }
-        } else {
-            // 兼容旧格式：如果没有modelAssembly，从数据库加载（仅用于兼容）
-            ModelInfo modelInfo = getModelInfoFromDatabase(modelId);
-            modelAssemblyObj["location"] = modelInfo.location;
-            modelAssemblyObj["icon"] = modelInfo.icon;
-            QJsonArray compListArray;
-            for (const QString& compId : modelInfo.componentList) {
-                compListArray.append(compId);
-            }
-            modelAssemblyObj["componentList"] = compListArray;
+        // 直接复制完整的组件信息数组
+        if (jsonModelAssembly.contains("components")) {
+            modelAssemblyObj["components"] = jsonModelAssembly["components"];
         }
         
-        entity->setProperty("modelAssembly", modelAssemblyObj);
-
-        // 从JSON文件加载完整的组件配置（不再依赖数据库）
-        if (json.contains("componentConfigs")) {
-            entity->setProperty("componentConfigs", json["componentConfigs"].toObject());
-        }
-        // 从JSON文件加载武器挂载信息
-        if (json.contains("weaponMounts")) {
-            entity->setProperty("weaponMounts", json["weaponMounts"].toObject());
+        // 复制location和icon
+        if (jsonModelAssembly.contains("location")) {
+            modelAssemblyObj["location"] = jsonModelAssembly["location"];
         }
-        if (json.contains("behavior")) {
-            entity->setProperty("behavior", json["behavior"].toObject());
-        } else {
-            entity->setProperty("behavior", QJsonObject());
+        if (jsonModelAssembly.contains("icon")) {
+            modelAssemblyObj["icon"] = jsonModelAssembly["icon"];
         }
+    } else {
+        // 兼容旧格式：如果没有modelAssembly，使用解析阶段从数据库查询的结果（仅用于兼容）
+        modelAssemblyObj = record.legacyModelAssembly;
     }
+    
+    entity->setProperty("modelAssembly", modelAssemblyObj);
 
-    return entity;
+    // 从JSON文件加载完整的组件配置（不再依赖数据库）
+    if (json.contains("componentConfigs")) {
+        entity->setProperty("componentConfigs", json["componentConfigs"].toObject());
+    }
+    // 从JSON文件加载武器挂载信息
+    if (json.contains("weaponMounts")) {
+        entity->setProperty("weaponMounts", json["weaponMounts"].toObject());
+    }
+    if (json.contains("behavior")) {
+        entity->setProperty("behavior", json["behavior"].toObject());
+    } else {
+        entity->setProperty("behavior", QJsonObject());
+    }
 }
 
 /**
@@ -917,28 +1263,16 @@ ModelInfo PlanFileManager::getModelInfoFromDatabase(const QString& modelId)
     ModelInfo info;
     info.id = modelId;
 
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
-        return info;
-    }
-
-    QSqlQuery query;
-    query.prepare("SELECT mi.id, mi.name, mi.location, mi.icon, mi.componentlist, mt.type "
-                  "FROM ModelInformation mi "
-                  "JOIN ModelType mt ON mi.modeltypeid = mt.id "
-                  "WHERE mi.id = ?");
-    query.addBindValue(modelId);
-
-    if (query.exec() && query.next()) {
-        info.id = query.value(0).toString();
-        info.name = query.value(1).toString();
-        info.location = query.value(2).toString();
-        info.icon = query.value(3).toString();
-        QString componentListStr = query.value(4).toString();
-        info.componentList = componentListStr.split(',', Qt::SkipEmptyParts);
-        info.type = query.value(5).toString();
+    CatalogModel model = CatalogCache::instance().model(modelId);
+    if (!model.id.isEmpty()) {
+        info.id = model.id;
+        info.name = model.name;
+        info.location = model.location;
+        info.icon = model.icon;
+        info.componentList = model.componentList;
+        info.type = model.type;
     } else {
-        qDebug() << "未找到模型信息:" << modelId << query.lastError().text();
+        qDebug() << "未找到模型信息:" << modelId;
     }
 
     return info;
@@ -1020,104 +1354,7 @@ QJsonObject PlanFileManager::getModelAssemblyFromDatabase(const QString& modelId
 
 QJsonObject PlanFileManager::getComponentFullInfoFromDatabase(const QString& componentId)
 {
-    QJsonObject result;
-
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
-        return result;
-    }
-
-    QSqlQuery query;
-    query.prepare("SELECT ci.componentid, ci.name, ci.type, ci.configinfo, "
-                  "ct.wsf, ct.subtype, ct.template "
-                  "FROM ComponentInformation ci "
-                  "JOIN ComponentType ct ON ci.componenttypeid = ct.ctypeid "
-                  "WHERE ci.componentid = ?");
-    query.addBindValue(componentId);
-
-    if (query.exec() && query.next()) {
-        result["componentId"] = query.value(0).toString();
-        result["name"] = query.value(1).toString();
-        result["type"] = query.value(2).toString();
-        result["wsf"] = query.value(4).toString();
-        result["subtype"] = query.value(5).toString();
-
-        // 解析配置信息
-        QJsonObject configInfo;
-        QString configStr = query.value(3).toString();
-        if (!configStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument configDoc = QJsonDocument::fromJson(configStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError && configDoc.isObject()) {
-                configInfo = configDoc.object();
-            }
-        }
-
-        // 解析模板信息以检查嵌套组件参数
-        QString templateStr = query.value(6).toString();
-        if (!templateStr.isEmpty()) {
-            QJsonParseError templateParseError;
-            QJsonDocument templateDoc = QJsonDocument::fromJson(templateStr.toUtf8(), &templateParseError);
-            if (templateParseError.error == QJsonParseError::NoError && templateDoc.isObject()) {
-                QJsonObject templateInfo = templateDoc.object();
-                for (auto it = templateInfo.begin(); it != templateInfo.end(); ++it) {
-                    const QString& paramName = it.key();
-                    QJsonObject paramConfig = it.value().toObject();
-                    if (paramConfig["type"].toInt() != 7) {
-                        continue;
-                    }
-
-                    QJsonValue currentValue = configInfo.value(paramName);
-                    QString componentName;
-                    QJsonObject paramValueObject;
-
-                    if (currentValue.isObject()) {
-                        paramValueObject = currentValue.toObject();
-                        componentName = paramValueObject.value("value").toString();
-                    } else if (currentValue.isString()) {
-                        componentName = currentValue.toString();
-                    }
-
-                    if (componentName.isEmpty()) {
-                        continue;
-                    }
-
-                    QSqlQuery nestedQuery;
-                    nestedQuery.prepare("SELECT componentid, configinfo FROM ComponentInformation WHERE name = ?");
-                    nestedQuery.addBindValue(componentName);
-                    if (!nestedQuery.exec() || !nestedQuery.next()) {
-                        qWarning() << "找不到名称为" << componentName << "的组件信息";
-                        continue;
-                    }
-
-                    QString nestedConfigStr = nestedQuery.value(1).toString();
-                    QJsonObject nestedConfigObj;
-                    if (!nestedConfigStr.isEmpty()) {
-                        QJsonParseError nestedParseError;
-                        QJsonDocument nestedDoc = QJsonDocument::fromJson(nestedConfigStr.toUtf8(), &nestedParseError);
-                        if (nestedParseError.error == QJsonParseError::NoError && nestedDoc.isObject()) {
-                            nestedConfigObj = nestedDoc.object();
-                        }
-                    }
-
-                    paramValueObject["value"] = componentName;
-                    if (!nestedConfigObj.isEmpty()) {
-                        paramValueObject["configInfo"] = nestedConfigObj;
-                    }
-
-                    configInfo[paramName] = paramValueObject;
-                }
-            }
-        }
-
-        if (!configInfo.isEmpty()) {
-            result["configInfo"] = configInfo;
-        }
-
-        // 模板信息不再写入方案文件，直接忽略
-    }
-
-    return result;
+    return CatalogCache::instance().componentFullInfo(componentId);
 }
 
 /**
@@ -1130,29 +1367,7 @@ QJsonObject PlanFileManager::getComponentFullInfoFromDatabase(const QString& com
  */
 QJsonObject PlanFileManager::getComponentConfigFromDatabase(const QString& componentId)
 {
-    QJsonObject result;
-
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
-        return result;
-    }
-
-    QSqlQuery query;
-    query.prepare("SELECT configinfo FROM ComponentInformation WHERE componentid = ?");
-    query.addBindValue(componentId);
-
-    if (query.exec() && query.next()) {
-        QString configStr = query.value(0).toString();
-        if (!configStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(configStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result = doc.object();
-            }
-        }
-    }
-
-    return result;
+    return CatalogCache::instance().component(componentId).configInfo;
 }
 
 /**
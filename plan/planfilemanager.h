@@ -14,8 +14,14 @@
 #include <QJsonArray>
 #include <QDateTime>
 #include <QList>
+#include <QSet>
+#include <QStringList>
 #include <QTimer>
 #include <atomic>
+#include <memory>
+#include "planloader.h"
+
+template <typename T> class QFutureWatcher;
 
 // 前向声明
 class GeoEntity;
@@ -26,7 +32,7 @@ struct ModelInfo;  // 在ModelAssemblyDialog.h中定义
  * @brief 方案文件管理器
  * 
  * 负责方案文件的创建、保存、加载和管理。
- * 方案文件采用JSON格式存储，包含实体列表、航点、航线等信息。
+ * 方案文件采用JSON（或CBOR）格式存储，包含实体列表、航点、航线以及实体共享的模型定义等信息。
  */
 class PlanFileManager : public QObject
 {
@@ -51,12 +57,50 @@ public:
      */
     bool savePlan(const QString& filePath = QString());
 
+    /**
+     * @brief 增量保存当前方案
+     *
+     * 将自上次保存以来通过addEntityToPlan/removeEntityFromPlan/updateEntityInPlan记录的实体变更
+     * 追加到方案的增量日志中。存在无法按实体记录的修改（markPlanModified）或日志过长时，
+     * 改为调用savePlan()完整保存（压缩），并删除日志。
+     * @return 成功返回true
+     */
+    bool saveIncremental();
+
+    /**
+     * @brief 设置自动保存是否使用增量日志
+     * @param enabled 为true时自动保存调用saveIncremental()，否则调用savePlan()
+     */
+    void setJournalEnabled(bool enabled);
+
+    /** @brief 自动保存是否使用增量日志 */
+    bool isJournalEnabled() const;
+
     /**
      * @brief 加载方案文件
      * @param filePath 方案文件路径
      * @return 成功返回true
      */
     bool loadPlan(const QString& filePath);
+
+    /**
+     * @brief 异步加载方案文件
+     *
+     * 文件读取、JSON解析和数据库查询在工作线程中完成；实体节点在主线程中分批创建，
+     * 每批不超过一帧的时间预算，加载期间地图保持渲染和交互。完成或取消后发出loadFinished。
+     * @param filePath 方案文件路径
+     * @return 成功启动加载返回true（已有加载在进行时返回false）
+     */
+    bool loadPlanAsync(const QString& filePath);
+
+    /** @brief 是否有方案正在加载 */
+    bool isLoading() const;
+
+    /**
+     * @brief 请求取消当前加载
+     *
+     * 异步加载时立即生效：已创建的实体会被清除，并发出loadCancelled和loadFinished。
+     */
     void requestCancelLoad();
 
     /**
@@ -89,13 +133,26 @@ public:
      */
     void updateEntityInPlan(GeoEntity* entity);
 
+    /**
+     * @brief 批量更新方案中的实体
+     *
+     * 所有实体一起记入增量日志，只发出一次planDataChanged。
+     * 已连接到GeoEntityManager::entitiesChanged，批量修改提交后自动调用；加载期间忽略。
+     * @param uids 实体UID列表
+     */
+    void updateEntitiesInPlan(const QStringList& uids);
+
     /**
      * @brief 检查是否有未保存的更改
      * @return 有未保存更改返回true
      */
     bool hasUnsavedChanges() const;
 
-    /** @brief 手动标记方案已发生修改（发出planDataChanged信号） */
+    /**
+     * @brief 手动标记方案已发生修改（发出planDataChanged信号）
+     *
+     * 用于航线、航点等无法按实体记录的修改，下一次保存将写入完整方案文件。
+     */
     void markPlanModified();
 
     /**
@@ -103,6 +160,8 @@ public:
      * @param entityManager 实体管理器指针
      */
     void setEntityManager(GeoEntityManager* entityManager);
+    /** @brief 获取实体管理器 */
+    GeoEntityManager* getEntityManager() const { return entityManager_; }
     
     /**
      * @brief 设置自动保存选项
@@ -179,7 +238,49 @@ private:
      * @param json JSON对象
      * @return 创建的实体指针，失败返回nullptr
      */
-    GeoEntity* jsonToEntity(const QJsonObject& json);
+    GeoEntity* jsonToEntity(const PlanEntityRecord& record);
+
+    /** @brief 工作线程解析完成后在主线程中开始构建 */
+    void onPlanParsed(const PlanLoadData& data);
+    /** @brief 分批构建定时器回调 */
+    void onLoadBatchTimeout();
+    /** @brief 构建前清理场景并重置进度 */
+    void beginBuild();
+    /**
+     * @brief 构建下一批实体/航线
+     * @param budgetMs 本批时间预算（毫秒），负数表示不限
+     * @return 全部构建完成返回true
+     */
+    bool buildNextBatch(qint64 budgetMs);
+    /** @brief 根据加载记录创建实体 */
+    void buildEntity(const PlanEntityRecord& record);
+    /**
+     * @brief 根据连续的加载记录批量创建实体（图片/航点实体）
+     * @param first 第一条记录在loadData_.entities中的下标
+     * @param count 记录数
+     */
+    void buildEntities(int first, int count);
+    /** @brief 将加载记录中的规划属性、模型组装、组件配置等写入实体 */
+    void applyEntityRecord(GeoEntity* entity, const PlanEntityRecord& record);
+    /** @brief 写入方案文件中覆盖的modelId、模型组装与组件配置 */
+    void applyRecordOverrides(GeoEntity* entity, const PlanEntityRecord& record);
+    /** @brief 根据加载记录恢复航线 */
+    void buildRoute(const PlanRouteRecord& record);
+    /** @brief 构建完成：恢复相机视角并发出planLoaded */
+    void finishBuild();
+    /**
+     * @brief 取消构建：清除已创建的实体并发出loadCancelled
+     *
+     * 场景已被清空，同时解除与原方案文件的关联，避免之后的保存用空场景覆盖原方案。
+     */
+    void abortBuild();
+    /** @brief 连接实体管理器的批量修改信号（entitiesChanged -> updateEntitiesInPlan） */
+    void connectEntityManager();
+    /** @brief 加载未开始构建就结束（解析失败或取消）时，原方案仍有未保存修改则重新启动自动保存 */
+    void resumeAutoSave();
+
+    /** @brief 清空增量日志的变更记录（完整保存或加载后调用） */
+    void resetJournalState();
 
     /**
      * @brief 从数据库获取模型信息
@@ -221,6 +322,13 @@ signals:
     void loadProgress(int current, int total, const QString& message);
     void loadCancelled();
 
+    /**
+     * @brief 异步加载结束时发出（成功、失败或取消）
+     * @param filePath 方案文件路径
+     * @param success 是否加载成功
+     */
+    void loadFinished(const QString& filePath, bool success);
+
 private:
     /**
      * @brief 比较两个JSON对象是否有差异
@@ -252,6 +360,23 @@ private:
     double cameraRange_;
 
     std::atomic_bool cancelLoad_;
+
+    // 异步加载相关
+    bool loading_;                                      // 是否正在加载
+    std::shared_ptr<std::atomic_bool> parseCancel_;     // 工作线程解析的取消标志（由工作线程共享持有）
+    QFutureWatcher<PlanLoadData>* loadWatcher_;         // 当前解析任务（取消后置空，旧结果被丢弃）
+    QTimer* loadBatchTimer_;                            // 分批构建定时器
+    PlanLoadData loadData_;                             // 正在构建的解析结果
+    int loadEntityIndex_;                               // 下一个待构建的实体下标
+    int loadRouteIndex_;                                // 下一个待构建的航线下标
+    int loadTotalSteps_;                                // 进度总步数
+
+    // 增量日志相关
+    bool journalEnabled_;                               // 自动保存是否使用增量日志
+    QSet<QString> journalDirtyUids_;                    // 上次保存以来新增或修改的实体UID
+    QSet<QString> journalRemovedUids_;                  // 上次保存以来删除的实体UID
+    bool journalStructureDirty_;                        // 存在需要完整保存的修改
+    int journalRecordCount_;                            // 日志中已有的记录数
 };
 
 #endif // PLANFILEMANAGER_H
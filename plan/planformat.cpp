@@ -0,0 +1,170 @@
+/**
+ * @file planformat.cpp
+ * @brief 方案文件格式实现文件
+ *
+ * 实现PlanFormat类的所有功能
+ */
+
+#include "planformat.h"
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QCborValue>
+#include <QCborMap>
+#include <cstring>
+
+namespace {
+
+// CBOR自描述标签55799的编码（RFC 8949 3.4.6）
+const char kCborMagic[] = { '\xd9', '\xd9', '\xf7' };
+const int kCborMagicSize = 3;
+
+bool hasCborMagic(const char* data, qint64 size)
+{
+    return size >= kCborMagicSize && std::memcmp(data, kCborMagic, kCborMagicSize) == 0;
+}
+
+void setError(QString* errorMessage, const QString& message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+}
+
+QString PlanFormat::jsonSuffix()
+{
+    return QStringLiteral(".plan.json");
+}
+
+QString PlanFormat::cborSuffix()
+{
+    return QStringLiteral(".plan.cbor");
+}
+
+bool PlanFormat::detect(const QString& filePath, Format& format)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray head = file.read(kCborMagicSize);
+    format = hasCborMagic(head.constData(), head.size()) ? Cbor : Json;
+    return true;
+}
+
+PlanFormat::Format PlanFormat::formatForSave(const QString& filePath)
+{
+    if (filePath.endsWith(cborSuffix(), Qt::CaseInsensitive)) {
+        return Cbor;
+    }
+    if (filePath.endsWith(jsonSuffix(), Qt::CaseInsensitive)) {
+        return Json;
+    }
+    Format format = Json;
+    if (QFile::exists(filePath) && detect(filePath, format)) {
+        return format;
+    }
+    return Json;
+}
+
+bool PlanFormat::read(const QString& filePath, QJsonObject& plan, QString* errorMessage)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(errorMessage, QStringLiteral("无法打开方案文件: %1").arg(file.errorString()));
+        return false;
+    }
+
+    // 映射文件内容；映射失败（如空文件）时退回到一次性读取
+    const qint64 size = file.size();
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    QByteArray bytes;
+    if (mapped) {
+        bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), static_cast<int>(size));
+    } else {
+        bytes = file.readAll();
+    }
+    const qint64 readMs = timer.elapsed();
+
+    bool ok = false;
+    const bool isCbor = hasCborMagic(bytes.constData(), bytes.size());
+    if (isCbor) {
+        QCborParserError parseError;
+        QCborValue value = QCborValue::fromCbor(bytes, &parseError);
+        if (parseError.error != QCborError::NoError) {
+            setError(errorMessage, QStringLiteral("方案文件CBOR解析错误: %1").arg(parseError.errorString()));
+        } else {
+            if (value.isTag()) {
+                value = value.taggedValue();
+            }
+            if (!value.isMap()) {
+                setError(errorMessage, QStringLiteral("方案文件CBOR内容不是对象"));
+            } else {
+                // 转换会复制整棵树；解码结果在离开作用域时释放
+                plan = value.toMap().toJsonObject();
+                ok = true;
+            }
+        }
+    } else {
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(bytes, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            setError(errorMessage, QStringLiteral("方案文件JSON解析错误: %1").arg(parseError.errorString()));
+        } else {
+            plan = doc.object();
+            ok = true;
+        }
+    }
+
+    // bytes引用映射内存，必须在unmap之前完成解析
+    const int byteCount = bytes.size();
+    bytes.clear();
+    if (mapped) {
+        file.unmap(mapped);
+    }
+    file.close();
+
+    if (ok) {
+        qDebug() << "方案文件读取完成:" << filePath << (isCbor ? "CBOR" : "JSON")
+                 << "大小:" << byteCount << "字节"
+                 << "映射/读取:" << readMs << "ms" << "解析:" << (timer.elapsed() - readMs) << "ms";
+    }
+    return ok;
+}
+
+bool PlanFormat::write(const QString& filePath, const QJsonObject& plan, Format format, QString* errorMessage)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QByteArray bytes;
+    if (format == Cbor) {
+        bytes = QCborValue(QCborKnownTags::Signature, QCborValue::fromJsonValue(plan)).toCbor();
+    } else {
+        bytes = QJsonDocument(plan).toJson(QJsonDocument::Indented);
+    }
+    const qint64 encodeMs = timer.elapsed();
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(errorMessage, QStringLiteral("无法写入方案文件: %1").arg(file.errorString()));
+        return false;
+    }
+    file.write(bytes);
+    if (!file.commit()) {
+        setError(errorMessage, QStringLiteral("无法写入方案文件: %1").arg(file.errorString()));
+        return false;
+    }
+
+    qDebug() << "方案文件写入完成:" << filePath << (format == Cbor ? "CBOR" : "JSON")
+             << "大小:" << bytes.size() << "字节"
+             << "编码:" << encodeMs << "ms" << "写入:" << (timer.elapsed() - encodeMs) << "ms";
+    return true;
+}
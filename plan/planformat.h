@@ -0,0 +1,80 @@
+/**
+ * @file planformat.h
+ * @brief 方案文件格式头文件
+ *
+ * 定义PlanFormat类，负责方案文件在JSON与二进制（CBOR）两种格式下的读写与识别。
+ */
+
+#ifndef PLANFORMAT_H
+#define PLANFORMAT_H
+
+#include <QString>
+#include <QJsonObject>
+
+/**
+ * @brief 方案文件格式
+ *
+ * 两种格式承载同一份方案对象：
+ * - JSON：缩进文本（*.plan.json），便于阅读和比对
+ * - CBOR：以自描述标签（0xd9d9f7）开头的二进制（*.plan.cbor），体积更小、解析更快
+ *
+ * 读取时按文件头自动识别格式，并通过QFile::map映射文件，省去把文件读入缓冲区的那次拷贝。
+ * 解析结果仍是独立的对象树：CBOR先解码为QCborValue，再转换为加载流程使用的QJsonObject，
+ * 解析期间两棵树同时存在（CBOR的收益在于体积和解码速度，而不是内存峰值）。
+ * CBOR由JSON对象无损转换而来，两种格式承载的信息相同；格式转换通过“另存为”选择后缀完成。
+ */
+class PlanFormat
+{
+public:
+    enum Format {
+        Json,
+        Cbor
+    };
+
+    /** @brief JSON方案文件后缀 */
+    static QString jsonSuffix();
+    /** @brief 二进制方案文件后缀 */
+    static QString cborSuffix();
+
+    /**
+     * @brief 识别已有文件的格式
+     * @param filePath 文件路径
+     * @param format 输出格式
+     * @return 文件可读返回true
+     */
+    static bool detect(const QString& filePath, Format& format);
+
+    /**
+     * @brief 确定保存时使用的格式
+     *
+     * 优先按后缀选择（*.plan.cbor为CBOR，*.plan.json为JSON）；其他后缀沿用已有文件的格式，
+     * 文件不存在时使用JSON。
+     * @param filePath 文件路径
+     * @return 保存格式
+     */
+    static Format formatForSave(const QString& filePath);
+
+    /**
+     * @brief 读取方案对象（自动识别格式）
+     * @param filePath 文件路径
+     * @param plan 输出方案对象
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 成功返回true
+     */
+    static bool read(const QString& filePath, QJsonObject& plan, QString* errorMessage = nullptr);
+
+    /**
+     * @brief 写入方案对象
+     *
+     * 先写临时文件再替换，保证目标文件始终完整。
+     * @param filePath 文件路径
+     * @param plan 方案对象
+     * @param format 文件格式
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 成功返回true
+     */
+    static bool write(const QString& filePath, const QJsonObject& plan, Format format,
+                      QString* errorMessage = nullptr);
+};
+
+#endif // PLANFORMAT_H
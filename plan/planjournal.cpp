@@ -0,0 +1,160 @@
+/**
+ * @file planjournal.cpp
+ * @brief 方案增量日志实现文件
+ *
+ * 实现PlanJournal类的所有功能
+ */
+
+#include "planjournal.h"
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QJsonDocument>
+
+QString PlanJournal::journalPath(const QString& planFile)
+{
+    return planFile + QStringLiteral(".journal");
+}
+
+bool PlanJournal::append(const QString& planFile, const QVector<QJsonObject>& records)
+{
+    if (planFile.isEmpty() || records.isEmpty()) {
+        return false;
+    }
+
+    QByteArray buffer;
+    for (const QJsonObject& record : records) {
+        buffer += QJsonDocument(record).toJson(QJsonDocument::Compact);
+        buffer += '\n';
+    }
+
+    QFile file(journalPath(planFile));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "无法写入方案日志:" << file.fileName() << file.errorString();
+        return false;
+    }
+    const qint64 written = file.write(buffer);
+    file.close();
+    if (written != buffer.size()) {
+        qDebug() << "方案日志写入不完整:" << file.fileName();
+        return false;
+    }
+    return true;
+}
+
+QJsonObject PlanJournal::upsertRecord(const QJsonObject& entity)
+{
+    QJsonObject record;
+    record["op"] = "upsert";
+    record["entity"] = entity;
+    return record;
+}
+
+QJsonObject PlanJournal::removeRecord(const QString& uid)
+{
+    QJsonObject record;
+    record["op"] = "remove";
+    record["uid"] = uid;
+    return record;
+}
+
+int PlanJournal::replay(const QString& planFile, QJsonArray& entities, QJsonArray& routes)
+{
+    QFile file(journalPath(planFile));
+    if (!file.exists()) {
+        return 0;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法读取方案日志:" << file.fileName() << file.errorString();
+        return 0;
+    }
+
+    // uid -> entities下标，保持实体原有顺序，新增实体追加在末尾
+    QHash<QString, int> indexByUid;
+    for (int i = 0; i < entities.size(); ++i) {
+        indexByUid.insert(entities.at(i).toObject().value("uid").toString(), i);
+    }
+
+    QSet<QString> removedUids;
+    int applied = 0;
+    int lineNumber = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError parseError;
+        QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            qDebug() << "跳过无效的方案日志行:" << lineNumber << parseError.errorString();
+            continue;
+        }
+
+        const QJsonObject record = doc.object();
+        const QString op = record.value("op").toString();
+        if (op == QStringLiteral("upsert")) {
+            const QJsonObject entity = record.value("entity").toObject();
+            const QString uid = entity.value("uid").toString();
+            if (uid.isEmpty()) {
+                continue;
+            }
+            auto it = indexByUid.constFind(uid);
+            if (it != indexByUid.constEnd() && it.value() >= 0) {
+                entities[it.value()] = entity;
+            } else {
+                indexByUid.insert(uid, entities.size());
+                entities.append(entity);
+            }
+            removedUids.remove(uid);
+            ++applied;
+        } else if (op == QStringLiteral("remove")) {
+            const QString uid = record.value("uid").toString();
+            auto it = indexByUid.find(uid);
+            if (it != indexByUid.end() && it.value() >= 0) {
+                // 先标记，回放结束后统一压缩数组，避免下标失效
+                entities[it.value()] = QJsonValue();
+                it.value() = -1;
+            }
+            removedUids.insert(uid);
+            ++applied;
+        } else {
+            qDebug() << "未知的方案日志操作:" << op << "行:" << lineNumber;
+        }
+    }
+    file.close();
+
+    if (!removedUids.isEmpty()) {
+        QJsonArray remainingEntities;
+        for (const QJsonValue& value : entities) {
+            if (value.isObject()) {
+                remainingEntities.append(value);
+            }
+        }
+        entities = remainingEntities;
+
+        QJsonArray remainingRoutes;
+        for (const QJsonValue& value : routes) {
+            if (!removedUids.contains(value.toObject().value("targetUid").toString())) {
+                remainingRoutes.append(value);
+            }
+        }
+        routes = remainingRoutes;
+    }
+
+    qDebug() << "方案日志回放完成:" << file.fileName() << "记录数:" << applied;
+    return applied;
+}
+
+void PlanJournal::remove(const QString& planFile)
+{
+    if (planFile.isEmpty()) {
+        return;
+    }
+    const QString path = journalPath(planFile);
+    if (QFile::exists(path) && !QFile::remove(path)) {
+        qDebug() << "无法删除方案日志:" << path;
+    }
+}
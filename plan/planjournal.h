@@ -0,0 +1,58 @@
+/**
+ * @file planjournal.h
+ * @brief 方案增量日志头文件
+ *
+ * 定义PlanJournal类，负责方案文件旁路日志（.journal）的追加、回放和删除。
+ */
+
+#ifndef PLANJOURNAL_H
+#define PLANJOURNAL_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QVector>
+
+/**
+ * @brief 方案增量日志
+ *
+ * 自上次完整保存以来的实体变更以JSON Lines格式追加到"<方案文件>.journal"：
+ * - {"op":"upsert","entity":{...}}：新增或整体替换一个实体（按uid）
+ * - {"op":"remove","uid":"..."}：删除一个实体
+ *
+ * 记录均为幂等操作，完整保存（压缩）写入主文件后再删除日志，
+ * 两步之间中断时重复回放也不会产生错误结果。追加中断导致的不完整行在回放时被跳过。
+ */
+class PlanJournal
+{
+public:
+    /** @brief 获取方案文件对应的日志文件路径 */
+    static QString journalPath(const QString& planFile);
+
+    /**
+     * @brief 追加日志记录
+     * @param planFile 方案文件路径
+     * @param records 日志记录
+     * @return 成功返回true
+     */
+    static bool append(const QString& planFile, const QVector<QJsonObject>& records);
+
+    /** @brief 构造upsert记录 */
+    static QJsonObject upsertRecord(const QJsonObject& entity);
+    /** @brief 构造remove记录 */
+    static QJsonObject removeRecord(const QString& uid);
+
+    /**
+     * @brief 将日志回放到方案的实体与航线数组上
+     * @param planFile 方案文件路径
+     * @param entities 方案实体数组（原地修改）
+     * @param routes 方案航线数组（原地修改，移除目标实体已删除的航线）
+     * @return 回放的记录数，日志不存在返回0
+     */
+    static int replay(const QString& planFile, QJsonArray& entities, QJsonArray& routes);
+
+    /** @brief 删除方案文件对应的日志 */
+    static void remove(const QString& planFile);
+};
+
+#endif // PLANJOURNAL_H
@@ -0,0 +1,283 @@
+/**
+ * @file planloader.cpp
+ * @brief 方案文件解析（加载第一阶段）实现文件
+ *
+ * 实现PlanLoader类的所有功能
+ */
+
+#include "planloader.h"
+#include "planjournal.h"
+#include "planformat.h"
+#include "plandefinitions.h"
+#include "../util/databaseutils.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QtMath>
+
+namespace {
+
+bool isCancelled(const std::atomic_bool* cancelFlag)
+{
+    return cancelFlag && cancelFlag->load();
+}
+
+const char kIconByNameStatement[] = "PlanLoader.iconByName";
+const char kAssemblyByIdStatement[] = "PlanLoader.assemblyById";
+
+/**
+ * @brief 工作线程的数据库查询上下文
+ *
+ * 使用DatabaseUtils的线程专属连接和预编译语句，并缓存同名模型的查询结果。
+ */
+class ModelLookup
+{
+public:
+    ModelLookup()
+    {
+        DatabaseUtils::registerStatement(kIconByNameStatement,
+                                         "SELECT icon FROM ModelInformation WHERE name = ?");
+        DatabaseUtils::registerStatement(kAssemblyByIdStatement,
+                                         "SELECT mi.location, mi.icon, mi.componentlist "
+                                         "FROM ModelInformation mi "
+                                         "JOIN ModelType mt ON mi.modeltypeid = mt.id "
+                                         "WHERE mi.id = ?");
+    }
+
+    /** @brief 按模型名查询图标路径（与GeoEntityManager::getImagePathFromDatabase一致） */
+    QString iconPathForName(const QString& modelName)
+    {
+        auto it = iconByName_.constFind(modelName);
+        if (it != iconByName_.constEnd()) {
+            return it.value();
+        }
+
+        QString iconPath;
+        if (ensureOpen()) {
+            QSqlQuery query = DatabaseUtils::preparedQuery(kIconByNameStatement);
+            query.bindValue(0, modelName);
+            if (query.exec() && query.next()) {
+                QString candidate = query.value(0).toString();
+                QFileInfo fileInfo(candidate);
+                if (!candidate.isEmpty() && fileInfo.exists() && fileInfo.isFile()) {
+                    iconPath = candidate;
+                } else {
+                    qDebug() << "数据库中的图片路径不存在:" << candidate;
+                }
+            } else {
+                qDebug() << "数据库查询失败或未找到模型:" << modelName << query.lastError().text();
+            }
+            query.finish();
+        }
+        iconByName_.insert(modelName, iconPath);
+        return iconPath;
+    }
+
+    /** @brief 按模型ID查询组装信息（旧格式兼容，与PlanFileManager::getModelInfoFromDatabase一致） */
+    QJsonObject modelAssemblyForId(const QString& modelId)
+    {
+        auto it = assemblyById_.constFind(modelId);
+        if (it != assemblyById_.constEnd()) {
+            return it.value();
+        }
+
+        QJsonObject assembly;
+        QString location;
+        QString icon;
+        QJsonArray compListArray;
+        if (ensureOpen()) {
+            QSqlQuery query = DatabaseUtils::preparedQuery(kAssemblyByIdStatement);
+            query.bindValue(0, modelId);
+            if (query.exec() && query.next()) {
+                location = query.value(0).toString();
+                icon = query.value(1).toString();
+                const QStringList componentList = query.value(2).toString().split(',', Qt::SkipEmptyParts);
+                for (const QString& compId : componentList) {
+                    compListArray.append(compId);
+                }
+            } else {
+                qDebug() << "未找到模型信息:" << modelId << query.lastError().text();
+            }
+            query.finish();
+        }
+        assembly["location"] = location;
+        assembly["icon"] = icon;
+        assembly["componentList"] = compListArray;
+        assemblyById_.insert(modelId, assembly);
+        return assembly;
+    }
+
+private:
+    bool ensureOpen()
+    {
+        if (!opened_) {
+            opened_ = true;
+            openOk_ = DatabaseUtils::threadDatabase().isOpen();
+            if (!openOk_) {
+                qDebug() << "PlanLoader: 无法打开数据库";
+            }
+        }
+        return openOk_;
+    }
+
+    bool opened_ = false;
+    bool openOk_ = false;
+    QHash<QString, QString> iconByName_;
+    QHash<QString, QJsonObject> assemblyById_;
+};
+
+void parseCamera(const QJsonObject& camera, PlanLoadData& data)
+{
+    data.hasCamera = false;
+    if (camera.isEmpty()) {
+        return;
+    }
+
+    double lon = camera["longitude"].toDouble();
+    double lat = camera["latitude"].toDouble();
+    double alt = camera["altitude"].toDouble();
+    double heading = camera["heading"].toDouble();
+    double pitch = camera["pitch"].toDouble();
+    double range = camera["range"].toDouble();
+
+    // 检查是否为NaN或无穷大
+    if (qIsNaN(lon) || qIsInf(lon) || qIsNaN(lat) || qIsInf(lat) ||
+        qIsNaN(alt) || qIsInf(alt) || qIsNaN(heading) || qIsInf(heading) ||
+        qIsNaN(pitch) || qIsInf(pitch) || qIsNaN(range) || qIsInf(range)) {
+        qDebug() << "相机视角数据包含NaN或Inf，忽略";
+        return;
+    }
+    // 检查经纬度范围
+    if (lon < -180.0 || lon > 180.0 || lat < -90.0 || lat > 90.0) {
+        qDebug() << "相机视角经纬度超出有效范围，忽略";
+        return;
+    }
+    // 检查距离和高度是否合理（避免异常大的值）
+    if (range < 0.0 || range > 1e8 || alt < -10000.0 || alt > 1e7) {
+        qDebug() << "相机视角距离或高度超出合理范围，忽略";
+        return;
+    }
+
+    data.hasCamera = true;
+    data.cameraLongitude = lon;
+    data.cameraLatitude = lat;
+    data.cameraAltitude = alt;
+    data.cameraHeading = heading;
+    data.cameraPitch = pitch;
+    data.cameraRange = range;
+}
+
+}
+
+PlanLoadData PlanLoader::parse(const QString& filePath, const std::atomic_bool* cancelFlag)
+{
+    PlanLoadData data;
+    data.filePath = filePath;
+
+    if (filePath.isEmpty()) {
+        data.errorMessage = QStringLiteral("方案文件路径为空");
+        return data;
+    }
+
+    // 读取并解析方案文件，回放自上次完整保存以来的增量日志，还原共享定义引用
+    QJsonObject planObject;
+    if (!readPlan(filePath, planObject, &data.journalRecordCount, &data.errorMessage)) {
+        return data;
+    }
+
+    if (isCancelled(cancelFlag)) {
+        data.cancelled = true;
+        return data;
+    }
+
+    // 检查版本
+    QString version = planObject["version"].toString();
+    if (version != "1.0" && version != "1.1" && version != "1.2") {
+        qDebug() << "不支持的方案文件版本:" << version;
+        // 可以添加版本转换逻辑
+    }
+
+    // 读取元数据
+    QJsonObject metadata = planObject["metadata"].toObject();
+    data.name = metadata["name"].toString();
+    data.description = metadata["description"].toString();
+    data.createTime = QDateTime::fromString(metadata["createTime"].toString(), Qt::ISODate);
+
+    const QJsonArray entitiesArray = planObject["entities"].toArray();
+    const QJsonArray routesArray = planObject["routes"].toArray();
+
+    // 实体：提前完成数据库查询，主线程只需创建节点
+    ModelLookup lookup;
+    data.entities.reserve(entitiesArray.size());
+    for (const QJsonValue& value : entitiesArray) {
+        if (isCancelled(cancelFlag)) {
+            data.cancelled = true;
+            return data;
+        }
+
+        PlanEntityRecord record;
+        record.json = value.toObject();
+        record.type = record.json["type"].toString();
+        record.displayName = record.json["name"].toString();
+        if (record.displayName.isEmpty()) {
+            record.displayName = record.json["modelName"].toString();
+        }
+
+        if (record.type == QStringLiteral("aircraft") || record.type == QStringLiteral("image")) {
+            record.imagePath = lookup.iconPathForName(record.json["modelName"].toString());
+        }
+        if (record.type != QStringLiteral("line") && !record.json.contains("modelAssembly")) {
+            record.legacyModelAssembly = lookup.modelAssemblyForId(record.json["modelId"].toString());
+        }
+
+        data.entities.append(record);
+    }
+
+    // 航线
+    data.routes.reserve(routesArray.size());
+    for (const QJsonValue& value : routesArray) {
+        PlanRouteRecord record;
+        record.json = value.toObject();
+        record.groupId = record.json["groupId"].toString();
+        record.targetUid = record.json["targetUid"].toString();
+        data.routes.append(record);
+    }
+
+    // 相机视角
+    parseCamera(planObject["camera"].toObject(), data);
+
+    data.ok = true;
+    return data;
+}
+
+bool PlanLoader::readPlan(const QString& filePath, QJsonObject& planObject,
+                          int* journalRecordCount, QString* errorMessage)
+{
+    // JSON或CBOR，按文件头自动识别
+    if (!PlanFormat::read(filePath, planObject, errorMessage)) {
+        return false;
+    }
+
+    QJsonArray entitiesArray = planObject["entities"].toArray();
+    QJsonArray routesArray = planObject["routes"].toArray();
+    const int replayed = PlanJournal::replay(filePath, entitiesArray, routesArray);
+
+    // 共享定义（1.1版本起，1.2起引用可附带覆盖字段）：把实体中的$ref还原为完整对象
+    const QJsonObject definitions = planObject["definitions"].toObject();
+    for (int i = 0; i < entitiesArray.size(); ++i) {
+        QJsonObject entity = entitiesArray.at(i).toObject();
+        PlanDefinitions::resolveEntity(entity, definitions);
+        entitiesArray[i] = entity;
+    }
+    planObject.remove("definitions");
+    planObject["entities"] = entitiesArray;
+    planObject["routes"] = routesArray;
+
+    if (journalRecordCount) {
+        *journalRecordCount = replayed;
+    }
+    return true;
+}
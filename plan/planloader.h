@@ -0,0 +1,98 @@
+/**
+ * @file planloader.h
+ * @brief 方案文件解析（加载第一阶段）头文件
+ *
+ * 定义方案加载的中间数据结构和PlanLoader类。PlanLoader负责读取、解析、校验方案文件，
+ * 并从SQLite解析模型数据，结果为不依赖OSG的普通结构体，可在工作线程中执行。
+ */
+
+#ifndef PLANLOADER_H
+#define PLANLOADER_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QVector>
+#include <QDateTime>
+#include <atomic>
+
+/**
+ * @brief 单个实体的加载记录
+ */
+struct PlanEntityRecord {
+    QJsonObject json;                 ///< 方案文件中的实体JSON
+    QString type;                     ///< 实体类型
+    QString displayName;              ///< 用于进度提示的名称
+    QString imagePath;                ///< 预解析的图标路径（image/aircraft类型）
+    QJsonObject legacyModelAssembly;  ///< 旧格式（无modelAssembly）时从数据库补全的组装信息
+};
+
+/**
+ * @brief 单条航线的加载记录
+ */
+struct PlanRouteRecord {
+    QJsonObject json;                 ///< 方案文件中的航线JSON
+    QString groupId;                  ///< 原航线组ID（用于日志和进度提示）
+    QString targetUid;                ///< 关联实体UID
+};
+
+/**
+ * @brief 方案文件解析结果
+ */
+struct PlanLoadData {
+    bool ok = false;                  ///< 解析是否成功
+    bool cancelled = false;           ///< 是否在解析过程中被取消
+    QString errorMessage;             ///< 失败原因
+    QString filePath;                 ///< 方案文件路径
+
+    QString name;                     ///< 方案名称
+    QString description;              ///< 方案描述
+    QDateTime createTime;             ///< 创建时间
+
+    QVector<PlanEntityRecord> entities;
+    QVector<PlanRouteRecord> routes;
+    int journalRecordCount = 0;       ///< 回放的增量日志记录数
+
+    bool hasCamera = false;           ///< 是否包含有效的相机视角
+    double cameraLongitude = 0.0;
+    double cameraLatitude = 0.0;
+    double cameraAltitude = 0.0;
+    double cameraHeading = 0.0;
+    double cameraPitch = 0.0;
+    double cameraRange = 0.0;
+};
+
+/**
+ * @brief 方案文件解析器
+ *
+ * 只做不涉及场景图的工作：文件读取、JSON解析与校验、相机视角校验、
+ * 模型图标路径与旧格式组装信息的数据库查询。数据库访问使用线程专属连接，
+ * 因此可通过QtConcurrent在工作线程中调用。
+ */
+class PlanLoader
+{
+public:
+    /**
+     * @brief 解析方案文件
+     * @param filePath 方案文件路径
+     * @param cancelFlag 取消标志（为true时尽快返回，结果cancelled=true）
+     * @return 解析结果
+     */
+    static PlanLoadData parse(const QString& filePath, const std::atomic_bool* cancelFlag = nullptr);
+
+    /**
+     * @brief 读取方案文件、回放增量日志并还原共享定义引用
+     *
+     * parse()与其他需要读取方案内容的功能（如AFSIM脚本导出）共用此入口，
+     * 得到的entities/routes与加载到场景中的内容一致：实体中的$ref已还原为完整的
+     * modelAssembly/componentConfigs，结果中不再包含definitions段。
+     * @param filePath 方案文件路径（JSON或CBOR，按文件头自动识别）
+     * @param planObject 输出方案对象
+     * @param journalRecordCount 输出回放的日志记录数（可为nullptr）
+     * @param errorMessage 输出错误信息（可为nullptr）
+     * @return 成功返回true
+     */
+    static bool readPlan(const QString& filePath, QJsonObject& planObject,
+                         int* journalRecordCount = nullptr, QString* errorMessage = nullptr);
+};
+
+#endif // PLANLOADER_H
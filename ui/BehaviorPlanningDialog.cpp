@@ -642,7 +642,7 @@ void BehaviorPlanningDialog::onClearClicked()
             entity->setProperty("behavior", QJsonObject());
             // 只标记为已修改，不直接保存文件。真正的保存应该通过"保存方案"按钮
             if (planFileManager_) {
-                planFileManager_->markPlanModified();
+                planFileManager_->updateEntityInPlan(entity);
             }
         }
     }
@@ -698,7 +698,7 @@ void BehaviorPlanningDialog::commitCurrentEntity()
     }
     // 只标记为已修改，不直接保存文件。真正的保存应该通过"保存方案"按钮
     if (planFileManager_) {
-        planFileManager_->markPlanModified();
+        planFileManager_->updateEntityInPlan(entity);
     }
     dirty_ = false;
     updateWindowTitle();
@@ -7,6 +7,7 @@
 
 #include "ComponentConfigDialog.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QVBoxLayout>
@@ -796,6 +797,7 @@ void ComponentConfigDialog::onSaveButtonClicked()
     query.addBindValue(QJsonDocument(configInfo).toJson(QJsonDocument::Compact));
     query.addBindValue(currentComponentInfo.componentId);
     if (query.exec()) {
+        CatalogCache::instance().invalidate();
         QMessageBox::information(this, "成功", "组件配置已保存");
         // 更新树显示
         if (currentItem) {
@@ -1021,6 +1023,7 @@ void ComponentConfigDialog::copyComponent()
     insertQuery.addBindValue(newConfigInfo);
 
     if (insertQuery.exec()) {
+        CatalogCache::instance().invalidate();
         QSqlQuery query;
         query.prepare("SELECT componentid "
                       "FROM ComponentInformation WHERE name = ?");
@@ -1090,6 +1093,7 @@ void ComponentConfigDialog::deleteComponent()
        if (!DatabaseUtils::commitTransaction()) {
            throw QString("提交事务失败");
        }
+       CatalogCache::instance().invalidate();
 
        // 从树形结构中移除
        // 获取组件父节点（WSF节点）
@@ -314,7 +314,7 @@ void EntityManagementDialog::populateTree(const QList<GeoEntity*>& entities,
         const QString typeId = entity->getType();
 
         if (typeId == QStringLiteral("waypoint")) {
-            const QString groupId = entity->getProperty("waypointGroupId").toString();
+            const QString groupId = entity->getWaypointGroupId();
             if (!groupId.isEmpty()) {
                 continue;
             }
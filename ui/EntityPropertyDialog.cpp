@@ -7,8 +7,10 @@
 
 #include "EntityPropertyDialog.h"
 #include "../geo/geoentity.h"
+#include "../geo/geoentitymanager.h"
 #include "../plan/planfilemanager.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
@@ -569,17 +571,23 @@ void EntityPropertyDialog::onSaveClicked()
         return;
     }
 
-    // 保存规划属性
-    savePlanningProperties();
+    {
+        // 一次保存写入的位置、航向与多项属性合并为一次变化通知；
+        // 提交时的entitiesChanged由方案管理器记入方案（标记为未保存，触发"当前方案: %1 *未保存"提示）
+        GeoEntityManager::EntityBatch batch(planFileManager_->getEntityManager());
 
-    // 保存模型组装属性
-    saveModelAssemblyProperties();
+        // 保存规划属性
+        savePlanningProperties();
 
-    // 保存组件配置
-    saveComponentConfigs();
+        // 保存模型组装属性
+        saveModelAssemblyProperties();
 
-    // 通知方案管理器更新实体（会标记为未保存，触发"当前方案: %1 *未保存"提示）
-    planFileManager_->updateEntityInPlan(entity_);
+        // 保存组件配置
+        saveComponentConfigs();
+    }
+    if (!planFileManager_->getEntityManager()) {
+        planFileManager_->updateEntityInPlan(entity_);
+    }
 
     QMessageBox::information(this, "成功", "实体属性已应用");
     accept();
@@ -728,74 +736,35 @@ QJsonObject EntityPropertyDialog::getModelAssemblyFromDatabase(const QString& mo
 
 QJsonObject EntityPropertyDialog::getComponentConfigFromDatabase(const QString& componentId)
 {
-    QJsonObject result;
-
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
-        return result;
-    }
-
-    QSqlQuery query;
-    query.prepare("SELECT configinfo FROM ComponentInformation WHERE componentid = ?");
-    query.addBindValue(componentId);
-
-    if (query.exec() && query.next()) {
-        QString configStr = query.value(0).toString();
-        if (!configStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(configStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result = doc.object();
-            }
-        }
-    }
-
-    return result;
+    return CatalogCache::instance().component(componentId).configInfo;
 }
 
 QJsonObject EntityPropertyDialog::getComponentFullInfoFromDatabase(const QString& componentId)
 {
     QJsonObject result;
 
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
+    CatalogCache& catalog = CatalogCache::instance();
+    CatalogComponent component = catalog.component(componentId);
+    if (component.componentId.isEmpty()) {
+        return result;
+    }
+    CatalogComponentType type = catalog.componentType(component.componentTypeId);
+    if (type.ctypeId.isEmpty()) {
         return result;
     }
 
-    QSqlQuery query;
-    query.prepare("SELECT ci.componentid, ci.name, ci.type, ci.configinfo, "
-                  "ct.wsf, ct.subtype, ct.template "
-                  "FROM ComponentInformation ci "
-                  "JOIN ComponentType ct ON ci.componenttypeid = ct.ctypeid "
-                  "WHERE ci.componentid = ?");
-    query.addBindValue(componentId);
+    result["componentId"] = component.componentId;
+    result["name"] = component.name;
+    result["type"] = component.type;
+    result["wsf"] = type.wsf;
+    result["subtype"] = type.subtype;
 
-    if (query.exec() && query.next()) {
-        result["componentId"] = query.value(0).toString();
-        result["name"] = query.value(1).toString();
-        result["type"] = query.value(2).toString();
-        result["wsf"] = query.value(4).toString();
-        result["subtype"] = query.value(5).toString();
-        
-        // 解析配置信息
-        QString configStr = query.value(3).toString();
-        if (!configStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument configDoc = QJsonDocument::fromJson(configStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result["configInfo"] = configDoc.object();
-            }
-        }
-        
-        // 解析模板信息
-        QString templateStr = query.value(6).toString();
-        if (!templateStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument templateDoc = QJsonDocument::fromJson(templateStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result["templateInfo"] = templateDoc.object();
-            }
-        }
+    // 配置信息和模板信息（缓存中已解析）
+    if (component.hasConfigInfo) {
+        result["configInfo"] = component.configInfo;
+    }
+    if (type.hasTemplateInfo) {
+        result["templateInfo"] = type.templateInfo;
     }
 
     return result;
@@ -803,31 +772,7 @@ QJsonObject EntityPropertyDialog::getComponentFullInfoFromDatabase(const QString
 
 QJsonObject EntityPropertyDialog::getComponentTemplateFromDatabase(const QString& componentId)
 {
-    QJsonObject result;
-
-    if (!DatabaseUtils::openDatabase()) {
-        qDebug() << "无法打开数据库";
-        return result;
-    }
-
-    QSqlQuery query;
-    query.prepare("SELECT ct.template FROM ComponentInformation ci "
-                  "JOIN ComponentType ct ON ci.componenttypeid = ct.ctypeid "
-                  "WHERE ci.componentid = ?");
-    query.addBindValue(componentId);
-
-    if (query.exec() && query.next()) {
-        QString templateStr = query.value(0).toString();
-        if (!templateStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(templateStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result = doc.object();
-            }
-        }
-    }
-
-    return result;
+    return CatalogCache::instance().componentTypeOf(componentId).templateInfo;
 }
 
 bool EntityPropertyDialog::jsonObjectsDiffer(const QJsonObject& obj1, const QJsonObject& obj2)
@@ -13,6 +13,7 @@
 #include "LocationJumpDialog.h"
 #include "BaseMapDialog.h"
 #include "../plan/planfilemanager.h"
+#include "../plan/planformat.h"
 #include "../geo/geoutils.h"
 #include <QLabel>
 #include <qt_windows.h>
@@ -75,7 +76,6 @@ MainWidget::MainWidget(QWidget *parent)
     
     // 禁用自动保存，只保留未保存提示
     planFileManager_->setAutoSaveEnabled(false);
-    dialogHoverEntity_ = nullptr;
     
     // 加载最近打开的文件列表
     loadRecentFiles();
@@ -581,8 +581,8 @@ void MainWidget::onDistanceMeasureClicked()
     }
 
     isMeasuringDistance_ = true;
-    distancePointA_ = nullptr;
-    distancePointB_ = nullptr;
+    distancePointA_ = EntityHandle();
+    distancePointB_ = EntityHandle();
     entityManager->setBlockMapNavigation(true);
 
     QMessageBox::information(this, "距离测算", "请依次点击两个标注点进行测距，右键可取消。");
@@ -598,22 +598,28 @@ void MainWidget::onDistanceMeasureClicked()
             return;
         }
 
-        if (!distancePointA_) {
-            distancePointA_ = wp;
+        if (distancePointA_.isNull()) {
+            distancePointA_ = wp->handle();
             return;
         }
 
-        if (wp == distancePointA_) {
+        if (wp->handle() == distancePointA_) {
             exitDistanceMeasure("请选择两个不同的标注点，距离测算已退出。");
             return;
         }
 
-        distancePointB_ = wp;
+        // 起点可能在两次点击之间被删除
+        WaypointEntity* pointA = resolveWaypoint(distancePointA_);
+        if (!pointA) {
+            exitDistanceMeasure("起点标注点已被删除，距离测算已退出。");
+            return;
+        }
+        distancePointB_ = wp->handle();
 
         double lon1 = 0.0, lat1 = 0.0, alt1 = 0.0;
         double lon2 = 0.0, lat2 = 0.0, alt2 = 0.0;
-        distancePointA_->getPosition(lon1, lat1, alt1);
-        distancePointB_->getPosition(lon2, lat2, alt2);
+        pointA->getPosition(lon1, lat1, alt1);
+        wp->getPosition(lon2, lat2, alt2);
         double meters = computeDistanceMeters(lat1, lon1, lat2, lon2);
         double km = meters / 1000.0;
 
@@ -661,7 +667,18 @@ void MainWidget::onAreaMeasureClicked()
         "请依次点击三个及以上的标注点组成多边形，再次单击首个点闭合，右键可取消。");
 
     auto finalizeArea = [this]() {
-        const double areaMeters = computePolygonAreaMeters(areaMeasurePoints_);
+        QVector<WaypointEntity*> points;
+        points.reserve(areaMeasurePoints_.size());
+        for (EntityHandle handle : areaMeasurePoints_) {
+            WaypointEntity* point = resolveWaypoint(handle);
+            if (!point) {
+                exitAreaMeasure("已选标注点已被删除，面积测算已退出。");
+                return;
+            }
+            points.append(point);
+        }
+
+        const double areaMeters = computePolygonAreaMeters(points);
         if (areaMeters <= 0.0) {
             exitAreaMeasure("所选点无法组成有效的封闭多边形（面积为0），面积测算已退出。");
             return;
@@ -690,11 +707,11 @@ void MainWidget::onAreaMeasureClicked()
         }
 
         if (areaMeasurePoints_.isEmpty()) {
-            areaMeasurePoints_.append(wp);
+            areaMeasurePoints_.append(wp->handle());
             return;
         }
 
-        if (wp == areaMeasurePoints_.first()) {
+        if (wp->handle() == areaMeasurePoints_.first()) {
             if (areaMeasurePoints_.size() < 3) {
                 exitAreaMeasure("至少需要三个不同的标注点才能计算面积，面积测算已退出。");
                 return;
@@ -703,12 +720,12 @@ void MainWidget::onAreaMeasureClicked()
             return;
         }
 
-        if (areaMeasurePoints_.contains(wp)) {
+        if (areaMeasurePoints_.contains(wp->handle())) {
             QMessageBox::information(this, "面积测算", "该标注点已选择，请选择其他点或单击首点完成测算。");
             return;
         }
 
-        areaMeasurePoints_.append(wp);
+        areaMeasurePoints_.append(wp->handle());
     });
 
     areaRightClickConn_ = connect(entityManager, &GeoEntityManager::mapRightClicked, this, [this](QPoint) {
@@ -772,8 +789,8 @@ void MainWidget::onAngleMeasureClicked()
     }
 
     isMeasuringAngle_ = true;
-    angleBasePoint_ = nullptr;
-    angleTargetPoint_ = nullptr;
+    angleBasePoint_ = EntityHandle();
+    angleTargetPoint_ = EntityHandle();
     entityManager->setBlockMapNavigation(true);
 
     QMessageBox::information(
@@ -792,18 +809,23 @@ void MainWidget::onAngleMeasureClicked()
             return;
         }
 
-        if (!angleBasePoint_) {
-            angleBasePoint_ = wp;
+        if (angleBasePoint_.isNull()) {
+            angleBasePoint_ = wp->handle();
             return;
         }
 
-        if (wp == angleBasePoint_) {
+        if (wp->handle() == angleBasePoint_) {
             exitAngleMeasure("请选择两个不同的标注点，角度测算已退出。");
             return;
         }
 
-        angleTargetPoint_ = wp;
-        showAngleBetweenWaypoints(angleBasePoint_, angleTargetPoint_);
+        WaypointEntity* basePoint = resolveWaypoint(angleBasePoint_);
+        if (!basePoint) {
+            exitAngleMeasure("基准标注点已被删除，角度测算已退出。");
+            return;
+        }
+        angleTargetPoint_ = wp->handle();
+        showAngleBetweenWaypoints(basePoint, wp);
         exitAngleMeasure();
     });
 
@@ -940,8 +962,8 @@ void MainWidget::exitDistanceMeasure(const QString& message)
 
     // 重置距离测量相关的状态变量
     isMeasuringDistance_ = false;  // 清除距离测量标志
-    distancePointA_ = nullptr;     // 清空测量点A
-    distancePointB_ = nullptr;     // 清空测量点B
+    distancePointA_ = EntityHandle();  // 清空测量点A
+    distancePointB_ = EntityHandle();  // 清空测量点B
 
     // 断开与鼠标点击事件相关的信号槽连接
     disconnectMeasurementConnection(distanceLeftClickConn_);   // 断开左键连接
@@ -994,8 +1016,8 @@ void MainWidget::exitAngleMeasure(const QString& message)
     }
 
     isMeasuringAngle_ = false;
-    angleBasePoint_ = nullptr;
-    angleTargetPoint_ = nullptr;
+    angleBasePoint_ = EntityHandle();
+    angleTargetPoint_ = EntityHandle();
 
     disconnectMeasurementConnection(angleLeftClickConn_);
     disconnectMeasurementConnection(angleRightClickConn_);
@@ -1044,6 +1066,11 @@ WaypointEntity* MainWidget::pickWaypointNearScreenPos(const QPoint& screenPos, i
 }
 
 
+WaypointEntity* MainWidget::resolveWaypoint(EntityHandle handle) const
+{
+    if (!osgMapWidget_ || !osgMapWidget_->getEntityManager()) return nullptr;
+    return qobject_cast<WaypointEntity*>(osgMapWidget_->getEntityManager()->getEntity(handle));
+}
 
 void MainWidget::createMapArea()
 {
@@ -1283,8 +1310,6 @@ void MainWidget::onOpenPlanClicked()
                                         }
                                         QString text = message.isEmpty() ? defaultMessage : message;
                                         progressDialog.setLabelText(text);
-                                        progressDialog.repaint();
-                                        QApplication::processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers);
                                    });
 
             cancelConn = connect(planFileManager_, &PlanFileManager::loadCancelled,
@@ -1302,7 +1327,18 @@ void MainWidget::onOpenPlanClicked()
             });
         }
 
-        bool result = planFileManager_->loadPlan(filePath);
+        // 异步加载：在本地事件循环中等待完成，期间地图继续渲染，取消按钮可以响应
+        bool result = false;
+        QEventLoop loadLoop;
+        QMetaObject::Connection finishedConn = connect(planFileManager_, &PlanFileManager::loadFinished,
+                                                       &loadLoop, [&](const QString&, bool success) {
+                                                           result = success;
+                                                           loadLoop.quit();
+                                                       });
+        if (planFileManager_->loadPlanAsync(filePath)) {
+            loadLoop.exec();
+        }
+        QObject::disconnect(finishedConn);
 
         progressDialog.close();
         QApplication::processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers);
@@ -1327,7 +1363,7 @@ void MainWidget::onOpenPlanClicked()
         QString filePath = QFileDialog::getOpenFileName(this, 
                                                         "打开方案文件", 
                                                         plansDir, 
-                                                        "方案文件 (*.plan.json);;所有文件 (*.*)");
+                                                        "方案文件 (*.plan.json *.plan.cbor);;所有文件 (*.*)");
         
         if (!filePath.isEmpty()) {
             bool cancelled = false;
@@ -1471,18 +1507,22 @@ void MainWidget::onSavePlanAsClicked()
     }
     
     QString plansDir = PlanFileManager::getPlansDirectory();
+    const QString jsonFilter = "方案文件 (*.plan.json)";
+    const QString cborFilter = "二进制方案文件 (*.plan.cbor)";
+    QString selectedFilter;
     QString filePath = QFileDialog::getSaveFileName(this, 
                                                     "另存为方案文件", 
                                                     plansDir, 
-                                                    "方案文件 (*.plan.json);;所有文件 (*.*)");
+                                                    jsonFilter + ";;" + cborFilter + ";;所有文件 (*.*)",
+                                                    &selectedFilter);
     
     if (filePath.isEmpty()) {
         return;
     }
     
-    // 确保文件扩展名正确
-    if (!filePath.endsWith(".plan.json")) {
-        filePath += ".plan.json";
+    // 确保文件扩展名正确（扩展名决定保存格式）
+    if (!filePath.endsWith(PlanFormat::jsonSuffix()) && !filePath.endsWith(PlanFormat::cborSuffix())) {
+        filePath += (selectedFilter == cborFilter) ? PlanFormat::cborSuffix() : PlanFormat::jsonSuffix();
     }
     
     // 保存当前相机视角（mapStateManager 必然存在）
@@ -1747,6 +1787,7 @@ void MainWidget::onMapLoaded()
     });
 
     connect(entityManager, &GeoEntityManager::entityCreated, this, &MainWidget::onEntityCreated, Qt::UniqueConnection);
+    connect(entityManager, &GeoEntityManager::entitiesCreated, this, &MainWidget::onEntitiesCreated, Qt::UniqueConnection);
     connect(entityManager, &GeoEntityManager::entityRemoved, this, &MainWidget::onEntityRemoved, Qt::UniqueConnection);
     connect(entityManager, &GeoEntityManager::entitySelected, this, &MainWidget::onEntitySelected, Qt::UniqueConnection);
     connect(entityManager, &GeoEntityManager::entityDeselected, this, &MainWidget::onEntityDeselected, Qt::UniqueConnection);
@@ -1897,7 +1938,7 @@ void MainWidget::onMapLoaded()
                 QMessageBox::warning(this, "直线标绘", "直线创建失败。");
             } else {
                 if (planFileManager_) {
-                    planFileManager_->markPlanModified();
+                    planFileManager_->addEntityToPlan(line);
                 }
                 entityManager->setSelectedEntity(line);
             }
@@ -1948,7 +1989,7 @@ void MainWidget::onMapLoaded()
         if (isPlacingRoute_ && !currentWaypointGroupId_.isEmpty()) {
             qDebug() << "[Route] 右键结束，准备生成路线，groupId=" << currentWaypointGroupId_;
             // 选择路径算法
-            QStringList items; items << "linear" << "bezier";
+            QStringList items; items << "linear" << "rhumb" << "bezier";
             bool okSel = false;
             QString choice = QInputDialog::getItem(this, "生成航线", "选择生成算法:", items, 0, false, &okSel);
             if (!okSel || choice.isEmpty()) choice = "linear";
@@ -1976,7 +2017,7 @@ void MainWidget::onMapLoaded()
             }
             
             // 选择路径算法
-            QStringList items; items << "linear" << "bezier";
+            QStringList items; items << "linear" << "rhumb" << "bezier";
             bool okSel = false;
             QString choice = QInputDialog::getItem(this, "生成航线", "选择生成算法:", items, 0, false, &okSel);
             if (!okSel || choice.isEmpty()) choice = "linear";
@@ -2165,30 +2206,32 @@ void MainWidget::showEntityManagementDialog()
                         return;
                     }
                     GeoEntity* entity = uid.isEmpty() ? nullptr : entityManager->getEntity(uid);
+                    GeoEntity* current = entityManager->getEntity(dialogHoverEntity_);
                     if (hovered) {
-                        if (dialogHoverEntity_ && dialogHoverEntity_ != entity) {
-                            dialogHoverEntity_->setHovered(false);
+                        if (current && current != entity) {
+                            current->setHovered(false);
                         }
-                        dialogHoverEntity_ = entity;
-                        if (dialogHoverEntity_) {
-                            dialogHoverEntity_->setHovered(true);
+                        dialogHoverEntity_ = entity ? entity->handle() : EntityHandle();
+                        if (entity) {
+                            entity->setHovered(true);
                         }
                     } else {
-                        if (!entity || entity == dialogHoverEntity_) {
-                            if (dialogHoverEntity_) {
-                                dialogHoverEntity_->setHovered(false);
-                                dialogHoverEntity_ = nullptr;
+                        if (!entity || entity == current) {
+                            if (current) {
+                                current->setHovered(false);
                             }
+                            dialogHoverEntity_ = EntityHandle();
                         } else if (entity) {
                             entity->setHovered(false);
                         }
                     }
                 });
         connect(entityManagementDialog_, &QDialog::finished, this, [this](int){
-            if (dialogHoverEntity_) {
-                dialogHoverEntity_->setHovered(false);
-                dialogHoverEntity_ = nullptr;
+            auto entityManager = osgMapWidget_ ? osgMapWidget_->getEntityManager() : nullptr;
+            if (GeoEntity* current = entityManager ? entityManager->getEntity(dialogHoverEntity_) : nullptr) {
+                current->setHovered(false);
             }
+            dialogHoverEntity_ = EntityHandle();
             if (osgMapWidget_) {
                 osgMapWidget_->setFocus(Qt::OtherFocusReason);
             }
@@ -2382,7 +2425,7 @@ void MainWidget::onEntityVisibilityChanged(const QString& uid, bool visible)
     }
 
     if (planFileManager_) {
-        planFileManager_->markPlanModified();
+        planFileManager_->updateEntityInPlan(entityManager->getEntity(uid));
     }
 
     refreshEntityManagementDialog();
@@ -2419,6 +2462,16 @@ void MainWidget::onEntityCreated(GeoEntity* entity)
     }
 }
 
+void MainWidget::onEntitiesCreated(const QList<GeoEntity*>& entities)
+{
+    // 批量创建只刷新一次列表
+    Q_UNUSED(entities);
+    refreshEntityManagementDialog();
+    if (behaviorDialog_) {
+        behaviorDialog_->refreshEntities();
+    }
+}
+
 void MainWidget::onEntityRemoved(const QString& uid)
 {
     Q_UNUSED(uid);
@@ -2486,7 +2539,7 @@ void MainWidget::onEntityWeaponQuantityChanged(const QString& entityUid,
     entity->setProperty("weaponMounts", mounts);
 
     if (planFileManager_) {
-        planFileManager_->markPlanModified();
+        planFileManager_->updateEntityInPlan(entity);
     }
 
     refreshEntityManagementDialog();
@@ -150,6 +150,7 @@ private slots:
     void onEntitySelectionRequested(const QString& uid);
     void onEntityRefreshRequested();
     void onEntityCreated(GeoEntity* entity);
+    void onEntitiesCreated(const QList<GeoEntity*>& entities);
     void onEntityRemoved(const QString& uid);
     void onEntitySelected(GeoEntity* entity);
     void onEntityDeselected();
@@ -326,17 +327,17 @@ private:
     bool isPlanningEntityRoute_;     // 是否正在为实体规划航线
     QString entityRouteUid_;     // 正在规划航线的实体UID
     QString entityRouteGroupId_;     // 实体航线组ID
-    GeoEntity* dialogHoverEntity_;
+    EntityHandle dialogHoverEntity_;                 // 实体管理对话框悬停的实体
 
     // 地图服务相关
     bool isMeasuringDistance_ = false;               // 是否处于测距模式
-    WaypointEntity* distancePointA_ = nullptr;  // 起点标绘点
-    WaypointEntity* distancePointB_ = nullptr;  // 终点标绘点
+    EntityHandle distancePointA_;                    // 起点标绘点
+    EntityHandle distancePointB_;                    // 终点标绘点
     bool isMeasuringArea_ = false;                   // 是否处于面积测算模式
-    QVector<class WaypointEntity*> areaMeasurePoints_; // 面积测算已选航点
+    QVector<EntityHandle> areaMeasurePoints_;        // 面积测算已选航点
     bool isMeasuringAngle_ = false;                  // 是否处于角度测算模式
-    class WaypointEntity* angleBasePoint_ = nullptr; // 角度测算起点
-    class WaypointEntity* angleTargetPoint_ = nullptr;// 角度测算终点
+    EntityHandle angleBasePoint_;                    // 角度测算起点
+    EntityHandle angleTargetPoint_;                  // 角度测算终点
 
     bool isDrawingLine_ = false;                     // 是否处于直线绘制模式
     bool hasPendingLineStart_ = false;               // 是否已记录直线起点
@@ -378,6 +379,8 @@ private:
      * @return 找到的航点指针，未找到返回nullptr
      */
     WaypointEntity* pickWaypointNearScreenPos(const QPoint& screenPos, int radiusPx) const;
+    /** @brief 按句柄解析航点（航点已删除或不是航点时返回nullptr） */
+    WaypointEntity* resolveWaypoint(EntityHandle handle) const;
 
 
 };
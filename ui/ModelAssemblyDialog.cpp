@@ -7,6 +7,7 @@
 
 #include "ModelAssemblyDialog.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include <QListWidget>
 #include <QTreeWidget>
 #include <QVBoxLayout>
@@ -603,6 +604,7 @@ void ModelAssemblyDialog::onSaveButtonClicked()
     query.addBindValue(currentModelInfo.id);
 
     if (query.exec()) {
+        CatalogCache::instance().invalidate();
         QMessageBox::information(this, "成功", "模型配置已保存");
         // 更新模型列表显示
         loadModelTree();
@@ -663,6 +665,7 @@ void ModelAssemblyDialog::addModel(QString modelName)
     insertQuery.addBindValue(modelTypeId);
 
     if (insertQuery.exec()) {
+        CatalogCache::instance().invalidate();
         // 查询新模型的id
         QSqlQuery query;
         query.prepare("SELECT mi.id, mt.type, mi.location, mi.icon, mi.componentlist "
@@ -745,6 +748,7 @@ void ModelAssemblyDialog::ondeleteModelAction()
 
         // 提交事务
         DatabaseUtils::commitTransaction();
+        CatalogCache::instance().invalidate();
 
         // 从树形结构中移除
         // 获取模型父节点
@@ -7,15 +7,15 @@
 
 #include "afsimscriptgenerator.h"
 #include "../plan/planfilemanager.h"
+#include "../plan/planloader.h"
 #include "../util/databaseutils.h"
+#include "../util/catalogcache.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDebug>
 #include <QSqlQuery>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QJsonDocument>
-#include <QJsonParseError>
 #include <QFileInfo>
 #include <QSet>
 #include <cmath>
@@ -599,23 +599,13 @@ bool AfsimScriptGenerator::loadPlanData(QJsonObject& planObj) const
         return false;
     }
 
-    QFile planFile(planPath);
-    if (!planFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qDebug() << "无法打开方案文件:" << planPath << planFile.errorString();
+    // 与加载流程相同的读取方式：识别JSON/CBOR格式、回放增量日志并还原共享定义引用，
+    // 实体的modelAssembly等字段为完整对象
+    QString errorMessage;
+    if (!PlanLoader::readPlan(planPath, planObj, nullptr, &errorMessage)) {
+        qDebug() << "方案文件读取失败:" << planPath << errorMessage;
         return false;
     }
-
-    QByteArray data = planFile.readAll();
-    planFile.close();
-
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(data, &parseError);
-    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
-        qDebug() << "方案文件解析失败:" << parseError.errorString();
-        return false;
-    }
-
-    planObj = doc.object();
     return true;
 }
 
@@ -726,40 +716,30 @@ QJsonObject AfsimScriptGenerator::getComponentInfoFromDatabase(const QString& co
 {
     QJsonObject result;
 
-    if (!DatabaseUtils::openDatabase()) {
+    CatalogCache& catalog = CatalogCache::instance();
+    CatalogComponent component = catalog.component(componentId);
+    if (component.componentId.isEmpty()) {
+        return result;
+    }
+    CatalogComponentType type = catalog.componentType(component.componentTypeId);
+    if (type.ctypeId.isEmpty()) {
         return result;
     }
 
-    QSqlQuery query;
-    query.prepare("SELECT ci.componentid, ci.name, ci.type, ci.configinfo, "
-                  "ct.wsf, ct.subtype, ct.afsimtype "
-                  "FROM ComponentInformation ci "
-                  "JOIN ComponentType ct ON ci.componenttypeid = ct.ctypeid "
-                  "WHERE ci.componentid = ?");
-    query.addBindValue(componentId);
+    result["componentId"] = component.componentId;
+    result["name"] = component.name;
+    result["type"] = component.type;
+    result["wsf"] = type.wsf;
+    result["subtype"] = type.subtype;
 
-    if (query.exec() && query.next()) {
-        result["componentId"] = query.value(0).toString();
-        result["name"] = query.value(1).toString();
-        result["type"] = query.value(2).toString();
-        result["wsf"] = query.value(4).toString();
-        result["subtype"] = query.value(5).toString();
-
-        // 解析配置信息
-        QString configStr = query.value(3).toString();
-        if (!configStr.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument configDoc = QJsonDocument::fromJson(configStr.toUtf8(), &parseError);
-            if (parseError.error == QJsonParseError::NoError) {
-                result["configInfo"] = configDoc.object();
-            }
-        }
+    // 配置信息（缓存中已解析）
+    if (component.hasConfigInfo) {
+        result["configInfo"] = component.configInfo;
+    }
 
-        // 解析AFSIM类型（如果有）
-        QString afsimType = query.value(6).toString();
-        if (!afsimType.isEmpty()) {
-            result["afsimtype"] = afsimType;
-        }
+    // AFSIM类型（如果有）
+    if (!type.afsimType.isEmpty()) {
+        result["afsimtype"] = type.afsimType;
     }
 
     return result;
@@ -769,22 +749,8 @@ QJsonArray AfsimScriptGenerator::getModelComponentsFromDatabase(const QString& m
 {
     QJsonArray result;
 
-    if (!DatabaseUtils::openDatabase()) {
-        return result;
-    }
-
-    // 首先获取模型的组件列表
-    QSqlQuery modelQuery;
-    modelQuery.prepare("SELECT componentlist FROM ModelInformation WHERE id = ?");
-    modelQuery.addBindValue(modelId);
-
-    QStringList componentIds;
-    if (modelQuery.exec() && modelQuery.next()) {
-        QString componentListStr = modelQuery.value(0).toString();
-        componentIds = componentListStr.split(',', Qt::SkipEmptyParts);
-    }
-
-    // 为每个组件ID获取完整信息
+    // 获取模型的组件列表，并为每个组件ID获取完整信息
+    const QStringList componentIds = CatalogCache::instance().model(modelId).componentList;
     for (const QString& compId : componentIds) {
         QJsonObject compInfo = getComponentInfoFromDatabase(compId.trimmed());
         if (!compInfo.isEmpty()) {
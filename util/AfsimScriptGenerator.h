@@ -115,7 +115,7 @@ private:
      * @return 路线名称，如果没有路线返回空字符串
      */
     /**
-     * @brief 加载当前方案文件数据
+     * @brief 加载当前方案文件数据（JSON或CBOR格式，含增量日志中的修改，共享定义已还原）
      * @param planObj 输出的方案JSON对象
      * @return 成功返回true
      */
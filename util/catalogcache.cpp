@@ -0,0 +1,291 @@
+/**
+ * @file catalogcache.cpp
+ * @brief 模型/组件目录缓存实现文件
+ *
+ * 实现CatalogCache类的所有功能
+ */
+
+#include "catalogcache.h"
+#include "databaseutils.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSet>
+#include <QJsonDocument>
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace {
+
+bool parseJsonObject(const QString& text, QJsonObject& out)
+{
+    if (text.isEmpty()) {
+        return false;
+    }
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(text.toUtf8(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        return false;
+    }
+    out = doc.object();
+    return true;
+}
+
+}
+
+CatalogCache& CatalogCache::instance()
+{
+    static CatalogCache cache;
+    return cache;
+}
+
+void CatalogCache::invalidate()
+{
+    QMutexLocker locker(&mutex_);
+    if (!loaded_) {
+        return;
+    }
+    loaded_ = false;
+    componentTypes_.clear();
+    components_.clear();
+    componentIdByName_.clear();
+    models_.clear();
+    modelIdByName_.clear();
+    fullInfoCache_.clear();
+    qDebug() << "CatalogCache: 缓存已失效";
+}
+
+void CatalogCache::ensureLoaded()
+{
+    if (loaded_) {
+        return;
+    }
+    // 打开失败时不标记为已加载，下一次查询重试
+    QSqlDatabase db = DatabaseUtils::threadDatabase();
+    if (!db.isOpen()) {
+        qDebug() << "CatalogCache: 无法打开数据库";
+        return;
+    }
+    loaded_ = true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSqlQuery typeQuery(db);
+    if (typeQuery.exec("SELECT ctypeid, wsf, subtype, afsimtype, template FROM ComponentType")) {
+        while (typeQuery.next()) {
+            CatalogComponentType record;
+            record.ctypeId = typeQuery.value(0).toString();
+            record.wsf = typeQuery.value(1).toString();
+            record.subtype = typeQuery.value(2).toString();
+            record.afsimType = typeQuery.value(3).toString();
+            record.hasTemplateInfo = parseJsonObject(typeQuery.value(4).toString(), record.templateInfo);
+            componentTypes_.insert(record.ctypeId, record);
+        }
+    } else {
+        qDebug() << "CatalogCache: 加载ComponentType失败:" << typeQuery.lastError().text();
+    }
+
+    QSqlQuery componentQuery(db);
+    if (componentQuery.exec("SELECT componentid, name, type, componenttypeid, configinfo FROM ComponentInformation")) {
+        while (componentQuery.next()) {
+            CatalogComponent record;
+            record.componentId = componentQuery.value(0).toString();
+            record.name = componentQuery.value(1).toString();
+            record.type = componentQuery.value(2).toString();
+            record.componentTypeId = componentQuery.value(3).toString();
+            record.hasConfigInfo = parseJsonObject(componentQuery.value(4).toString(), record.configInfo);
+            components_.insert(record.componentId, record);
+            // 与原按名称查询一致：同名组件取第一条
+            if (!componentIdByName_.contains(record.name)) {
+                componentIdByName_.insert(record.name, record.componentId);
+            }
+        }
+    } else {
+        qDebug() << "CatalogCache: 加载ComponentInformation失败:" << componentQuery.lastError().text();
+    }
+
+    QSqlQuery modelQuery(db);
+    if (modelQuery.exec("SELECT mi.id, mi.name, mi.location, mi.icon, mi.componentlist, mt.type "
+                        "FROM ModelInformation mi "
+                        "LEFT JOIN ModelType mt ON mi.modeltypeid = mt.id")) {
+        while (modelQuery.next()) {
+            CatalogModel record;
+            record.id = modelQuery.value(0).toString();
+            record.name = modelQuery.value(1).toString();
+            record.location = modelQuery.value(2).toString();
+            record.icon = modelQuery.value(3).toString();
+            record.componentList = modelQuery.value(4).toString().split(',', Qt::SkipEmptyParts);
+            record.type = modelQuery.value(5).toString();
+            models_.insert(record.id, record);
+            if (!modelIdByName_.contains(record.name)) {
+                modelIdByName_.insert(record.name, record.id);
+            }
+        }
+    } else {
+        qDebug() << "CatalogCache: 加载ModelInformation失败:" << modelQuery.lastError().text();
+    }
+
+    qDebug() << "CatalogCache: 加载完成，组件类型:" << componentTypes_.size()
+             << "组件:" << components_.size() << "模型:" << models_.size()
+             << "耗时:" << timer.elapsed() << "ms";
+}
+
+CatalogComponent CatalogCache::component(const QString& componentId)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    return components_.value(componentId);
+}
+
+CatalogComponent CatalogCache::componentByName(const QString& name)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    auto it = componentIdByName_.constFind(name);
+    if (it == componentIdByName_.constEnd()) {
+        return CatalogComponent();
+    }
+    return components_.value(it.value());
+}
+
+CatalogComponentType CatalogCache::componentType(const QString& ctypeId)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    return componentTypes_.value(ctypeId);
+}
+
+CatalogComponentType CatalogCache::componentTypeOf(const QString& componentId)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    auto it = components_.constFind(componentId);
+    if (it == components_.constEnd()) {
+        return CatalogComponentType();
+    }
+    return componentTypes_.value(it.value().componentTypeId);
+}
+
+CatalogModel CatalogCache::model(const QString& modelId)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    return models_.value(modelId);
+}
+
+CatalogModel CatalogCache::modelByName(const QString& name)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    auto it = modelIdByName_.constFind(name);
+    if (it == modelIdByName_.constEnd()) {
+        return CatalogModel();
+    }
+    return models_.value(it.value());
+}
+
+QHash<QString, CatalogModel> CatalogCache::modelsByName(const QStringList& names)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    QHash<QString, CatalogModel> result;
+    result.reserve(names.size());
+    for (const QString& name : names) {
+        auto it = modelIdByName_.constFind(name);
+        if (it != modelIdByName_.constEnd()) {
+            result.insert(name, models_.value(it.value()));
+        }
+    }
+    return result;
+}
+
+QStringList CatalogCache::modelIcons()
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    QStringList icons;
+    QSet<QString> seen;
+    for (const CatalogModel& record : models_) {
+        if (!record.icon.isEmpty() && !seen.contains(record.icon)) {
+            seen.insert(record.icon);
+            icons.append(record.icon);
+        }
+    }
+    return icons;
+}
+
+QJsonObject CatalogCache::componentFullInfo(const QString& componentId)
+{
+    QMutexLocker locker(&mutex_);
+    ensureLoaded();
+    auto cached = fullInfoCache_.constFind(componentId);
+    if (cached != fullInfoCache_.constEnd()) {
+        return cached.value();
+    }
+
+    QJsonObject result;
+    auto componentIt = components_.constFind(componentId);
+    auto typeIt = componentIt != components_.constEnd()
+                      ? componentTypes_.constFind(componentIt.value().componentTypeId)
+                      : componentTypes_.constEnd();
+    // 与原JOIN查询一致：组件或其类型缺失时视为未找到
+    if (componentIt == components_.constEnd() || typeIt == componentTypes_.constEnd()) {
+        return result;
+    }
+
+    const CatalogComponent& component = componentIt.value();
+    const CatalogComponentType& type = typeIt.value();
+    result["componentId"] = component.componentId;
+    result["name"] = component.name;
+    result["type"] = component.type;
+    result["wsf"] = type.wsf;
+    result["subtype"] = type.subtype;
+
+    QJsonObject configInfo = component.configInfo;
+
+    // 展开模板中类型为7的嵌套组件参数
+    for (auto it = type.templateInfo.begin(); it != type.templateInfo.end(); ++it) {
+        const QString& paramName = it.key();
+        QJsonObject paramConfig = it.value().toObject();
+        if (paramConfig["type"].toInt() != 7) {
+            continue;
+        }
+
+        QJsonValue currentValue = configInfo.value(paramName);
+        QString componentName;
+        QJsonObject paramValueObject;
+
+        if (currentValue.isObject()) {
+            paramValueObject = currentValue.toObject();
+            componentName = paramValueObject.value("value").toString();
+        } else if (currentValue.isString()) {
+            componentName = currentValue.toString();
+        }
+
+        if (componentName.isEmpty()) {
+            continue;
+        }
+
+        auto nestedIdIt = componentIdByName_.constFind(componentName);
+        if (nestedIdIt == componentIdByName_.constEnd()) {
+            qWarning() << "找不到名称为" << componentName << "的组件信息";
+            continue;
+        }
+
+        const CatalogComponent nested = components_.value(nestedIdIt.value());
+        paramValueObject["value"] = componentName;
+        if (!nested.configInfo.isEmpty()) {
+            paramValueObject["configInfo"] = nested.configInfo;
+        }
+
+        configInfo[paramName] = paramValueObject;
+    }
+
+    if (!configInfo.isEmpty()) {
+        result["configInfo"] = configInfo;
+    }
+
+    fullInfoCache_.insert(componentId, result);
+    return result;
+}
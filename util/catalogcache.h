@@ -0,0 +1,118 @@
+/**
+ * @file catalogcache.h
+ * @brief 模型/组件目录缓存头文件
+ *
+ * 定义CatalogCache类，一次性加载ModelInformation、ComponentInformation、ComponentType表，
+ * 并缓存已解析的JSON配置，供方案保存、脚本生成和各对话框查询使用。
+ */
+
+#ifndef CATALOGCACHE_H
+#define CATALOGCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+
+/**
+ * @brief 组件类型记录（ComponentType表）
+ */
+struct CatalogComponentType {
+    QString ctypeId;
+    QString wsf;
+    QString subtype;
+    QString afsimType;
+    QJsonObject templateInfo;          ///< 已解析的template字段
+    bool hasTemplateInfo = false;      ///< template字段非空且解析成功
+};
+
+/**
+ * @brief 组件记录（ComponentInformation表）
+ */
+struct CatalogComponent {
+    QString componentId;               ///< 为空表示未找到
+    QString name;
+    QString type;
+    QString componentTypeId;
+    QJsonObject configInfo;            ///< 已解析的configinfo字段
+    bool hasConfigInfo = false;        ///< configinfo字段非空且解析成功
+};
+
+/**
+ * @brief 模型记录（ModelInformation表，附带ModelType.type）
+ */
+struct CatalogModel {
+    QString id;                        ///< 为空表示未找到
+    QString name;
+    QString location;
+    QString icon;
+    QStringList componentList;
+    QString type;
+};
+
+/**
+ * @brief 模型/组件目录缓存
+ *
+ * 首次查询时从默认数据库连接加载三张表，之后的查询均为哈希查找。
+ * 写入这些表的对话框（ComponentConfigDialog、ModelAssemblyDialog）在写入成功后调用invalidate()，
+ * 下一次查询时重新加载。查询结果按值返回并由互斥锁保护，可在工作线程中使用
+ * （加载使用DatabaseUtils的线程专属连接）。
+ */
+class CatalogCache
+{
+public:
+    /** @brief 获取全局实例 */
+    static CatalogCache& instance();
+
+    /** @brief 使缓存失效（数据库写入后调用） */
+    void invalidate();
+
+    /** @brief 按组件ID查询 */
+    CatalogComponent component(const QString& componentId);
+    /** @brief 按组件名称查询 */
+    CatalogComponent componentByName(const QString& name);
+    /** @brief 按组件类型ID查询 */
+    CatalogComponentType componentType(const QString& ctypeId);
+    /** @brief 查询组件所属的组件类型 */
+    CatalogComponentType componentTypeOf(const QString& componentId);
+    /** @brief 按模型ID查询 */
+    CatalogModel model(const QString& modelId);
+    /** @brief 按模型名称查询 */
+    CatalogModel modelByName(const QString& name);
+    /**
+     * @brief 按模型名称批量查询（只加锁一次）
+     * @return 模型名称 -> 模型记录，未找到的名称不在结果中
+     */
+    QHash<QString, CatalogModel> modelsByName(const QStringList& names);
+    /** @brief 所有模型引用的图标路径（去重，不检查文件是否存在） */
+    QStringList modelIcons();
+
+    /**
+     * @brief 获取写入方案文件的完整组件信息
+     *
+     * 包含componentId、name、type、wsf、subtype、configInfo，并将模板中类型为7的
+     * 嵌套组件参数展开为{"value":名称,"configInfo":{...}}。结果同样被缓存。
+     * @param componentId 组件ID
+     * @return 组件信息JSON对象，未找到返回空对象
+     */
+    QJsonObject componentFullInfo(const QString& componentId);
+
+private:
+    CatalogCache() = default;
+    CatalogCache(const CatalogCache&) = delete;
+    CatalogCache& operator=(const CatalogCache&) = delete;
+
+    void ensureLoaded();  // 调用方需持有mutex_
+
+    mutable QMutex mutex_;
+    bool loaded_ = false;
+    QHash<QString, CatalogComponentType> componentTypes_;     // ctypeid -> 组件类型
+    QHash<QString, CatalogComponent> components_;             // componentid -> 组件
+    QHash<QString, QString> componentIdByName_;               // 组件名称 -> componentid
+    QHash<QString, CatalogModel> models_;                     // 模型id -> 模型
+    QHash<QString, QString> modelIdByName_;                   // 模型名称 -> id
+    QHash<QString, QJsonObject> fullInfoCache_;               // componentid -> 完整组件信息
+};
+
+#endif // CATALOGCACHE_H
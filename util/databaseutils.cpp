@@ -11,10 +11,71 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QSqlError>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QThreadStorage>
 
 // 静态成员变量初始化
 QString DatabaseUtils::databasePath_ = "";
 
+namespace {
+
+/**
+ * @brief 线程专属的连接与预编译语句缓存
+ *
+ * 由QThreadStorage持有，线程结束时析构：释放语句并移除该线程创建的连接。
+ */
+struct ThreadConnection {
+    QString name;
+    bool ownsConnection = false;             // 主线程使用默认连接，不在此移除
+    QHash<QString, QSqlQuery> statements;    // 语句名称 -> 已编译的查询
+
+    ~ThreadConnection()
+    {
+        statements.clear();
+        if (ownsConnection && QSqlDatabase::contains(name)) {
+            {
+                QSqlDatabase db = QSqlDatabase::database(name, false);
+                if (db.isOpen()) {
+                    db.close();
+                }
+            }
+            QSqlDatabase::removeDatabase(name);
+        }
+    }
+};
+
+QThreadStorage<ThreadConnection*> threadConnections;
+
+QMutex statementRegistryMutex;
+
+QHash<QString, QString>& statementRegistry()
+{
+    static QHash<QString, QString> registry;
+    return registry;
+}
+
+bool isMainThread()
+{
+    QCoreApplication* app = QCoreApplication::instance();
+    return !app || QThread::currentThread() == app->thread();
+}
+
+ThreadConnection* currentThreadConnection()
+{
+    if (!threadConnections.hasLocalData()) {
+        ThreadConnection* connection = new ThreadConnection;
+        connection->name = DatabaseUtils::threadConnectionName();
+        connection->ownsConnection = !isMainThread();
+        threadConnections.setLocalData(connection);
+    }
+    return threadConnections.localData();
+}
+
+}
+
 QString DatabaseUtils::getDatabasePath()
 {
     // 如果路径未设置，初始化默认路径
@@ -85,6 +146,7 @@ bool DatabaseUtils::openDatabase(const QString& connectionName)
     
     if (db.open()) {
         qDebug() << "DatabaseUtils: 成功打开数据库:" << connectionName;
+        applyPragmas(db);
         return true;
     } else {
         qDebug() << "DatabaseUtils: 打开数据库失败:" << connectionName << db.lastError().text();
@@ -94,6 +156,11 @@ bool DatabaseUtils::openDatabase(const QString& connectionName)
 
 void DatabaseUtils::closeDatabase(const QString& connectionName)
 {
+    // 先释放当前线程缓存的预编译语句，避免其引用已移除的连接
+    if (threadConnections.hasLocalData() && threadConnections.localData()->name == connectionName) {
+        threadConnections.localData()->statements.clear();
+    }
+
     if (QSqlDatabase::contains(connectionName)) {
         QSqlDatabase db = QSqlDatabase::database(connectionName);
         if (db.isOpen()) {
@@ -168,3 +235,100 @@ bool DatabaseUtils::rollbackTransaction(const QString& connectionName)
     return false;
 }
 
+
+void DatabaseUtils::applyPragmas(QSqlDatabase& db)
+{
+    // synchronous=NORMAL：WAL模式下安全且明显减少fsync
+    // busy_timeout：多个连接并发写入时等待而不是立即失败
+    static const char* const walPragmas[] = {
+        "PRAGMA journal_mode=WAL",
+        "PRAGMA synchronous=NORMAL"
+    };
+    static const char* const commonPragmas[] = {
+        "PRAGMA temp_store=MEMORY",
+        "PRAGMA cache_size=-8000",
+        "PRAGMA busy_timeout=5000"
+    };
+
+    QSqlQuery query(db);
+    auto exec = [&query](const char* pragma) {
+        if (!query.exec(QString::fromLatin1(pragma))) {
+            qDebug() << "DatabaseUtils: 设置参数失败:" << pragma << query.lastError().text();
+        }
+    };
+
+    // WAL：读写互不阻塞，工作线程读取时主线程仍可写入。
+    // WAL模式会写入数据库文件头并在同目录创建-wal/-shm文件，文件或目录不可写（如只读安装目录）时
+    // 不启用，保持默认的回滚日志模式，只读查询照常可用
+    const QFileInfo fileInfo(db.databaseName());
+    const QFileInfo dirInfo(fileInfo.absolutePath());
+    if (fileInfo.isWritable() && dirInfo.isWritable()) {
+        for (const char* pragma : walPragmas) {
+            exec(pragma);
+        }
+    } else {
+        qDebug() << "DatabaseUtils: 数据库文件或目录不可写，不启用WAL:" << fileInfo.absoluteFilePath();
+    }
+
+    for (const char* pragma : commonPragmas) {
+        exec(pragma);
+    }
+}
+
+QString DatabaseUtils::threadConnectionName()
+{
+    if (isMainThread()) {
+        return QString::fromLatin1(QSqlDatabase::defaultConnection);
+    }
+    return QStringLiteral("DatabaseUtils_thread_%1")
+        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+}
+
+QSqlDatabase DatabaseUtils::threadDatabase()
+{
+    const QString name = currentThreadConnection()->name;
+    if (!isDatabaseOpen(name)) {
+        openDatabase(name);
+    }
+    return QSqlDatabase::database(name, false);
+}
+
+void DatabaseUtils::registerStatement(const QString& name, const QString& sql)
+{
+    QMutexLocker locker(&statementRegistryMutex);
+    statementRegistry().insert(name, sql);
+}
+
+QSqlQuery DatabaseUtils::preparedQuery(const QString& name)
+{
+    ThreadConnection* connection = currentThreadConnection();
+    QSqlDatabase db = threadDatabase();
+    if (!db.isOpen()) {
+        qDebug() << "DatabaseUtils: 无法打开数据库，语句未编译:" << name;
+        return QSqlQuery();
+    }
+
+    auto it = connection->statements.constFind(name);
+    if (it != connection->statements.constEnd()) {
+        return it.value();
+    }
+
+    QString sql;
+    {
+        QMutexLocker locker(&statementRegistryMutex);
+        sql = statementRegistry().value(name);
+    }
+    if (sql.isEmpty()) {
+        qDebug() << "DatabaseUtils: 未注册的语句:" << name;
+        return QSqlQuery(db);
+    }
+
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    if (!query.prepare(sql)) {
+        qDebug() << "DatabaseUtils: 语句编译失败:" << name << query.lastError().text();
+        return query;
+    }
+    connection->statements.insert(name, query);
+    return query;
+}
@@ -19,6 +19,11 @@
  * - 数据库路径管理（使用绝对路径）
  * - 数据库连接获取
  * - 数据库连接状态检查
+ * - 每线程独立连接（主线程使用默认连接，其他线程按线程ID自动创建，线程结束时释放）
+ * - 命名预编译语句注册表（每个连接只编译一次）
+ *
+ * 每个连接打开时都会设置SQLite参数；数据库文件及其所在目录均可写时启用WAL日志模式，使工作线程的读取
+ * 不阻塞主线程，否则（如只读安装目录）沿用默认的回滚日志模式。
  */
 class DatabaseUtils
 {
@@ -91,6 +96,38 @@ public:
      */
     static bool rollbackTransaction(const QString& connectionName = QSqlDatabase::defaultConnection);
 
+    /**
+     * @brief 获取当前线程的连接名称
+     * @return 主线程返回默认连接名称，其他线程返回按线程ID生成的名称
+     */
+    static QString threadConnectionName();
+
+    /**
+     * @brief 获取当前线程的数据库连接（必要时自动创建并打开）
+     * @return 数据库连接对象，打开失败时isOpen()为false
+     */
+    static QSqlDatabase threadDatabase();
+
+    /**
+     * @brief 注册命名SQL语句
+     *
+     * 可在任意线程调用；同名语句以最后一次注册为准（已编译的连接不受影响）。
+     * @param name 语句名称
+     * @param sql SQL语句（可包含?占位符）
+     */
+    static void registerStatement(const QString& name, const QString& sql);
+
+    /**
+     * @brief 获取当前线程连接上已编译的命名语句
+     *
+     * 每个连接首次使用某语句时调用prepare()，之后直接返回缓存的查询对象。
+     * 返回的对象与缓存共享同一预编译语句：绑定参数后exec()，读取完毕后调用finish()，
+     * 同一语句不能嵌套使用。
+     * @param name 语句名称（需先通过registerStatement注册）
+     * @return 已编译的查询对象，失败时返回未准备的查询对象
+     */
+    static QSqlQuery preparedQuery(const QString& name);
+
 private:
     static QString databasePath_;  // 数据库文件路径（绝对路径）
     
@@ -98,6 +135,12 @@ private:
      * @brief 初始化默认数据库路径
      */
     static void initializeDefaultPath();
+
+    /**
+     * @brief 设置连接的SQLite参数（WAL（目录可写时）、同步级别、缓存等）
+     * @param db 已打开的数据库连接
+     */
+    static void applyPragmas(QSqlDatabase& db);
 };
 
 #endif // DATABASEUTILS_H
@@ -18,9 +18,14 @@
 #include <osg/Camera>
 #include <osgViewer/Viewer>
 #include <osg/GraphicsContext>
+#include <osgDB/DatabasePager>
 #include <algorithm>
 
 #include "../geo/geoentitymanager.h"
+#include "../geo/glyphatlas.h"
+#include "../geo/highlightcache.h"
+#include "../geo/iconatlas.h"
+#include "../geo/iconcache.h"
 #include "../geo/mapstatemanager.h"
 #include "../geo/geoutils.h"
 #include "../geo/navigationhistory.h"
@@ -91,6 +96,8 @@ OsgMapWidget::OsgMapWidget(QWidget *parent)
     // 获取GLWidget并添加到布局
     QGLWidget* glWidget = gw_->getGLWidget();
     mainLayout->addWidget(glWidget);
+    // 监视鼠标移动事件，合并为每帧一次处理
+    glWidget->installEventFilter(this);
     
     // 信息叠加层不覆盖整个窗口，只用来管理子控件
     // 所有子控件都直接作为OsgMapWidget的子控件（类似QMapControl的做法）
@@ -133,26 +140,7 @@ OsgMapWidget::OsgMapWidget(QWidget *parent)
     
     // 定时器用于刷新渲染（但不在构造函数中启动）
     timer_ = new QTimer(this);
-    connect(timer_, &QTimer::timeout, this, [this]() {
-        if (viewer_) {
-            viewer_->frame();
-            // qDebug() << "viewer done?" << viewer_->done();
-            // frame()完成后，立即处理延迟删除队列，确保不在渲染过程中删除
-            if (entityManager_) {
-                entityManager_->processPendingDeletions();
-            }
-
-            // 关键：OpenGL一帧完成后，强制刷新叠加控件，避免缩放时的拖影/重影
-            if (mapInfoOverlay_) {
-                QWidget* infoPanel = mapInfoOverlay_->getInfoPanel();
-                QWidget* compass = mapInfoOverlay_->getCompassWidget();
-                QWidget* scale = mapInfoOverlay_->getScaleWidget();
-                if (infoPanel) infoPanel->update();
-                if (compass) compass->update();
-                if (scale) scale->update();
-            }
-        }
-    });
+    connect(timer_, &QTimer::timeout, this, &OsgMapWidget::onRenderTick);
     // 不在这里启动，等窗口显示后再启动
     
     qDebug() << "OsgMapWidget初始化完成";
@@ -161,6 +149,145 @@ OsgMapWidget::OsgMapWidget(QWidget *parent)
 OsgMapWidget::~OsgMapWidget()
 {
     timer_->stop();
+
+    // 节点池中的线几何体与文字、共享高亮边框、图标纹理和图集、标签字形图集都持有GL对象：
+    // 在图形上下文仍然有效时释放，而不是留到程序退出时的静态析构
+    const bool current = gw_ && gw_->valid() && gw_->makeCurrent();
+    EntityNodePool::instance().clear();
+    HighlightCache::instance().clear();
+    IconCache::instance().clear();
+    IconAtlas::instance().clear();
+    GlyphAtlas::instance().clear();
+    if (current) {
+        gw_->releaseContext();
+    }
+}
+
+namespace {
+// 渲染周期（约60 FPS）
+const int kFrameIntervalMs = 16;
+// 按需模式空闲时的轮询周期：只做状态检查，不渲染
+const int kIdlePollIntervalMs = 100;
+// 连续空闲多少个渲染周期后降低轮询频率
+const int kIdleTicksBeforeSlowPoll = 30;
+// 每次请求重绘后至少渲染的帧数（让操作器与纹理编译稳定下来）
+const int kFramesPerRedrawRequest = 2;
+}
+
+void OsgMapWidget::onRenderTick()
+{
+    if (!viewer_) {
+        return;
+    }
+
+    if (renderMode_ == RenderOnDemand && !needsRedraw()) {
+        // 空闲：不渲染，且逐步降低轮询频率
+        if (++idleTicks_ >= kIdleTicksBeforeSlowPoll && timer_->interval() != kIdlePollIntervalMs) {
+            timer_->setInterval(kIdlePollIntervalMs);
+        }
+        return;
+    }
+
+    idleTicks_ = 0;
+    if (timer_->interval() != kFrameIntervalMs) {
+        timer_->setInterval(kFrameIntervalMs);
+    }
+    if (framesToRender_ > 0) {
+        --framesToRender_;
+    }
+    renderFrame();
+}
+
+void OsgMapWidget::renderFrame()
+{
+    viewer_->frame();
+    ++renderedFrameCount_;
+    // qDebug() << "viewer done?" << viewer_->done();
+    // frame()完成后，立即处理延迟删除队列，确保不在渲染过程中删除
+    if (entityManager_) {
+        entityManager_->processPendingDeletions();
+        // 使用本帧相机更新实体屏幕投影，供悬停拾取在像素空间查找
+        entityManager_->updateScreenProjection();
+    }
+
+    // 本帧合并后的鼠标移动只处理一次
+    processPendingMouseMove();
+
+    // 关键：OpenGL一帧完成后，强制刷新叠加控件，避免缩放时的拖影/重影
+    if (mapInfoOverlay_) {
+        QWidget* infoPanel = mapInfoOverlay_->getInfoPanel();
+        QWidget* compass = mapInfoOverlay_->getCompassWidget();
+        QWidget* scale = mapInfoOverlay_->getScaleWidget();
+        if (infoPanel) infoPanel->update();
+        if (compass) compass->update();
+        if (scale) scale->update();
+    }
+}
+
+/**
+ * @brief 按需模式下判断是否需要渲染
+ *
+ * 以下任一条件成立即需要渲染：
+ * - 显式请求重绘（输入事件、实体/航线变化、底图切换等）
+ * - 延迟删除队列或鼠标采样有待处理的工作
+ * - OSG事件队列非空，或Viewer/操作器请求重绘、连续更新（惯性、动画）
+ * - 操作器正在过渡到新视点，或操作器矩阵与相机矩阵不一致（如外部调用home()）
+ * - 数据库分页器（osgEarth瓦片加载）仍有请求在进行或待合并
+ *
+ * @note 不使用Viewer::checkNeedToDoFrame()：osgEarth的MapNode始终需要更新遍历，
+ *       该函数会因此恒为true。
+ */
+bool OsgMapWidget::needsRedraw() const
+{
+    if (framesToRender_ > 0 || mouseMovePending_) {
+        return true;
+    }
+    if (entityManager_ && entityManager_->hasPendingDeletions()) {
+        return true;
+    }
+    if (viewer_->getRequestRedraw() || viewer_->getRequestContinousUpdate()) {
+        return true;
+    }
+    if (viewer_->checkEvents()) {
+        return true;
+    }
+
+    osgEarth::Util::EarthManipulator* manip = GeoUtils::getEarthManipulator(viewer_.get());
+    if (manip && manip->isSettingViewpoint()) {
+        return true;
+    }
+    osgGA::CameraManipulator* cameraManip = viewer_->getCameraManipulator();
+    if (cameraManip && viewer_->getCamera()
+        && cameraManip->getInverseMatrix() != viewer_->getCamera()->getViewMatrix()) {
+        return true;
+    }
+
+    osgDB::DatabasePager* pager = viewer_->getDatabasePager();
+    if (pager && (pager->getRequestsInProgress() || pager->requiresUpdateSceneGraph())) {
+        return true;
+    }
+    return false;
+}
+
+void OsgMapWidget::setRenderMode(RenderMode mode)
+{
+    if (renderMode_ == mode) {
+        return;
+    }
+    renderMode_ = mode;
+    idleTicks_ = 0;
+    qDebug() << "渲染模式切换为:" << (mode == RenderOnDemand ? "按需渲染" : "连续渲染");
+    requestRedraw();
+}
+
+void OsgMapWidget::requestRedraw()
+{
+    framesToRender_ = std::max(framesToRender_, kFramesPerRedrawRequest);
+    idleTicks_ = 0;
+    // 空闲降频时立即恢复到正常渲染周期
+    if (timer_ && timer_->isActive() && timer_->interval() != kFrameIntervalMs) {
+        timer_->start(kFrameIntervalMs);
+    }
 }
 
 void OsgMapWidget::initializeViewer()
@@ -197,6 +324,11 @@ void OsgMapWidget::loadMap()
     
     // 创建底图管理器
     baseMapManager_ = new BaseMapManager(map.get(), this);
+    // 按需渲染：底图图层变化后需要渲染以触发瓦片加载
+    connect(baseMapManager_, &BaseMapManager::baseMapAdded, this, &OsgMapWidget::requestRedraw);
+    connect(baseMapManager_, &BaseMapManager::baseMapRemoved, this, &OsgMapWidget::requestRedraw);
+    connect(baseMapManager_, &BaseMapManager::baseMapUpdated, this, &OsgMapWidget::requestRedraw);
+    connect(baseMapManager_, &BaseMapManager::baseMapVisibilityChanged, this, &OsgMapWidget::requestRedraw);
     
     // 默认无底图（对应my.earth的默认状态）
     // 用户可以后续通过底图管理对话框添加底图图层
@@ -214,6 +346,11 @@ void OsgMapWidget::loadMap()
         if (!entityManager_) {
             entityManager_ = new GeoEntityManager(root_.get(), mapNode_.get(), this);
             entityManager_->setViewer(viewer_.get());
+            // 按需渲染：实体或航线变化时请求重绘
+            connect(entityManager_, &GeoEntityManager::sceneChanged, this, &OsgMapWidget::requestRedraw);
+            connect(entityManager_, &GeoEntityManager::entityCreated, this, &OsgMapWidget::requestRedraw);
+            connect(entityManager_, &GeoEntityManager::entitiesCreated, this, &OsgMapWidget::requestRedraw);
+            connect(entityManager_, &GeoEntityManager::entityRemoved, this, &OsgMapWidget::requestRedraw);
             qDebug() << "实体管理器初始化完成";
         }
         
@@ -274,6 +411,58 @@ void OsgMapWidget::synthesizeMouseRelease(Qt::MouseButton button)
     QApplication::sendEvent(glWidget, &releaseEvent);
 }
 
+bool OsgMapWidget::eventFilter(QObject* watched, QEvent* event)
+{
+    if (event->type() == QEvent::MouseMove && gw_ && watched == gw_->getGLWidget()) {
+        QMouseEvent* mouseEvent = static_cast<QMouseEvent*>(event);
+        ++mouseMoveEventCount_;
+        if (mouseMovePending_) {
+            // 上一个位置尚未处理就被覆盖
+            ++droppedMouseMoveCount_;
+        }
+        pendingMousePos_ = mouseEvent->pos();
+        mouseMovePending_ = true;
+    }
+
+    // 按需渲染：GLWidget上的输入事件都需要重绘
+    if (gw_ && watched == gw_->getGLWidget()) {
+        switch (event->type()) {
+        case QEvent::MouseMove:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::Wheel:
+        case QEvent::KeyPress:
+        case QEvent::KeyRelease:
+        case QEvent::Resize:
+        case QEvent::Expose:
+        case QEvent::Enter:
+        case QEvent::Leave:
+            requestRedraw();
+            break;
+        default:
+            break;
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+void OsgMapWidget::processPendingMouseMove()
+{
+    if (!mouseMovePending_) {
+        return;
+    }
+    mouseMovePending_ = false;
+
+    // 9元组状态、鼠标坐标（MapInfoOverlay::updateMouseCoordinates）均由此次采样驱动
+    if (mapStateManager_) {
+        mapStateManager_->updateMousePosition(pendingMousePos_);
+    }
+    if (entityManager_) {
+        entityManager_->updateHover(pendingMousePos_);
+    }
+}
+
 void OsgMapWidget::setupManipulator()
 {
     // 默认设置为3D模式
@@ -373,6 +562,7 @@ void OsgMapWidget::setMode2D()
     
     viewer_->setCameraManipulator(em.get());
     viewer_->home();
+    requestRedraw();
     
     qDebug() << "设置为2D模式";
 }
@@ -404,6 +594,7 @@ void OsgMapWidget::setMode3D()
     
     viewer_->setCameraManipulator(em.get());
     viewer_->home();
+    requestRedraw();
     
     qDebug() << "设置为3D模式";
 }
@@ -411,8 +602,9 @@ void OsgMapWidget::setMode3D()
 void OsgMapWidget::showEvent(QShowEvent* event)
 {
     // 窗口显示后才启动渲染定时器
+    requestRedraw();
     if (timer_ && !timer_->isActive()) {
-        timer_->start(16); // ~60 FPS
+        timer_->start(kFrameIntervalMs); // ~60 FPS
         qDebug() << "启动OSG渲染定时器";
     }
     QWidget::showEvent(event);
@@ -433,6 +625,7 @@ void OsgMapWidget::resizeEvent(QResizeEvent* event)
         mapInfoOverlay_->updateOverlayWidgetsPosition(width(), height());
     }
     
+    requestRedraw();
     QWidget::resizeEvent(event);
 }
 
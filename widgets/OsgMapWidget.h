@@ -55,6 +55,14 @@ class OsgMapWidget : public QWidget
     Q_OBJECT
 
 public:
+    /**
+     * @brief 渲染模式
+     */
+    enum RenderMode {
+        RenderContinuous,   ///< 连续渲染：每个定时器周期都调用frame()
+        RenderOnDemand      ///< 按需渲染：仅在场景、相机、输入或分页加载有变化时渲染
+    };
+
     /**
      * @brief 构造函数
      * @param parent 父widget
@@ -148,6 +156,43 @@ public:
      */
     void synthesizeMouseRelease(Qt::MouseButton button);
 
+    /**
+     * @brief 获取收到的鼠标移动事件总数
+     */
+    quint64 getMouseMoveEventCount() const { return mouseMoveEventCount_; }
+
+    /**
+     * @brief 获取被合并丢弃的鼠标移动事件数量
+     *
+     * 同一帧内收到多个鼠标移动事件时只处理最后一个，其余计入此计数。
+     */
+    quint64 getDroppedMouseMoveCount() const { return droppedMouseMoveCount_; }
+
+    /**
+     * @brief 设置渲染模式（可在运行时切换）
+     * @param mode 渲染模式
+     */
+    void setRenderMode(RenderMode mode);
+
+    /**
+     * @brief 获取当前渲染模式
+     */
+    RenderMode getRenderMode() const { return renderMode_; }
+
+    /**
+     * @brief 获取已渲染的帧数
+     */
+    quint64 getRenderedFrameCount() const { return renderedFrameCount_; }
+
+public slots:
+    /**
+     * @brief 请求重绘
+     *
+     * 按需渲染模式下，场景内容在OSG之外被修改（如切换底图、外部设置视点）时调用，
+     * 保证后续几帧被渲染；连续渲染模式下无影响。
+     */
+    void requestRedraw();
+
 signals:
     /**
      * @brief 地图加载完成信号
@@ -157,6 +202,16 @@ signals:
     void mapLoaded();
 
 protected:
+    /**
+     * @brief 事件过滤器
+     *
+     * 拦截GLWidget的鼠标移动事件，只记录最新的光标位置，留待下一帧统一处理
+     * @param watched 被监视对象
+     * @param event 事件
+     * @return 始终返回false，事件继续交给GLWidget（OSG事件队列）处理
+     */
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
     /**
      * @brief 窗口大小变化事件处理
      * @param event 大小变化事件
@@ -216,11 +271,48 @@ private:
      */
     void setupManipulator();
 
+    /**
+     * @brief 处理本帧合并后的鼠标移动采样
+     *
+     * 在frame()之后调用，以最新光标位置更新地图状态和实体悬停高亮
+     */
+    void processPendingMouseMove();
+
+    /**
+     * @brief 渲染定时器回调
+     *
+     * 连续模式下每次都渲染；按需模式下先检查needsRedraw()，空闲时跳过渲染并降低轮询频率
+     */
+    void onRenderTick();
+
+    /**
+     * @brief 渲染一帧并完成帧后处理（延迟删除、屏幕投影、鼠标采样、叠加控件刷新）
+     */
+    void renderFrame();
+
+    /**
+     * @brief 按需模式下判断是否需要渲染
+     * @return 需要渲染返回true
+     */
+    bool needsRedraw() const;
+
     osg::ref_ptr<osgViewer::Viewer> viewer_;      // OSG Viewer
     osg::ref_ptr<osg::Group> root_;                // 场景根节点
     osg::ref_ptr<osgEarth::MapNode> mapNode_;     // osgEarth地图节点
     osgQt::GraphicsWindowQt* gw_;                 // Qt图形窗口适配器
     QTimer* timer_;                                // 渲染定时器
+
+    // 鼠标移动事件合并（每帧只处理最新的光标位置）
+    QPoint pendingMousePos_;                       // 最新的光标位置
+    bool mouseMovePending_ = false;                // 是否有待处理的鼠标移动
+    quint64 mouseMoveEventCount_ = 0;              // 收到的鼠标移动事件总数
+    quint64 droppedMouseMoveCount_ = 0;            // 被合并丢弃的鼠标移动事件数
+
+    // 按需渲染
+    RenderMode renderMode_ = RenderContinuous;     // 当前渲染模式
+    int framesToRender_ = 0;                       // 请求重绘后仍需渲染的帧数
+    int idleTicks_ = 0;                            // 连续空闲的定时器周期数
+    quint64 renderedFrameCount_ = 0;               // 已渲染的帧数
     
     // 实体和地图状态管理器
     GeoEntityManager* entityManager_;              // 实体管理器